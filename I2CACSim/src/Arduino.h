@@ -0,0 +1,95 @@
+/*
+ * Arduino.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+//
+// just enough of the ATtiny Arduino core to build I2CAnalogClock.cpp on the host
+//
+
+#if defined(__AVR_ATtiny85__) && !defined(__AVR_ATtinyX5__)
+#define __AVR_ATtinyX5__
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "SimAVR.h"
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define HIGH         1
+#define LOW          0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define CHANGE       SIM_CHANGE
+#define FALLING      SIM_FALLING
+#define RISING       SIM_RISING
+
+#define _BV(b)       (1 << (b))
+
+#define noInterrupts() sim.setInterrupts(false)
+#define interrupts()   sim.setInterrupts(true)
+#define cli()          sim.setInterrupts(false)
+#define sei()          sim.setInterrupts(true)
+
+inline unsigned long millis()
+{
+    return sim.awake() / (F_CPU / 1000L);
+}
+
+inline unsigned long micros()
+{
+    return sim.awake() / (F_CPU / 1000000L);
+}
+
+inline void delay(unsigned long ms)
+{
+    sim.busy((uint64_t)ms * (F_CPU / 1000L));
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+    sim.busy((uint64_t)us * (F_CPU / 1000000L));
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+    sim.pinMode(pin, mode);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+    sim.digitalWrite(pin, value);
+}
+
+inline int digitalRead(uint8_t pin)
+{
+    return sim.digitalRead(pin);
+}
+
+#endif /* ARDUINO_H_ */
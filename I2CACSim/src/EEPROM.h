@@ -0,0 +1,49 @@
+/*
+ * EEPROM.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "Arduino.h"
+
+class EEPROMClass
+{
+public:
+    uint8_t read(int address)
+    {
+        return sim.eeprom[address % SIM_EEPROM_SIZE];
+    }
+
+    void write(int address, uint8_t value)
+    {
+        sim.eeprom[address % SIM_EEPROM_SIZE] = value;
+    }
+
+    void update(int address, uint8_t value)
+    {
+        write(address, value);
+    }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif /* EEPROM_H_ */
@@ -0,0 +1,494 @@
+/*
+ * I2CACSim.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// Runs the unmodified I2CAnalogClock firmware against the SimAVR model
+// in virtual time and reports pulse widths, adjustment throughput and
+// ISR load.  Each scenario runs in its own process so the firmware starts
+// from a clean power on.  Exits non-zero if any check fails.
+//
+//   i2cacsim [tick|adjust|protocol|target]...
+//
+
+#include "I2CAnalogClock.h"
+#include "I2CACVersion.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define US(x)        ((uint64_t)(x) * (F_CPU / 1000000L))
+#define MS(x)        US((uint64_t)(x) * 1000)
+#define SECONDS(x)   MS((uint64_t)(x) * 1000)
+#define CYCLES2MS(x) ((double)(x) / (F_CPU / 1000L))
+
+#define PULSE_SLOP_MS 1.0 // allowed pulse width over the configured duration (isr latency)
+
+TwoWire     Wire;
+EEPROMClass EEPROM;
+
+// firmware state we look at
+extern volatile uint16_t position;
+extern volatile uint16_t adjustment;
+extern volatile bool     adjust_active;
+extern volatile Config   config;
+
+void setup();
+void loop();
+
+static int          failures;
+static unsigned int sqw_edges; // falling edges of the 1hz SQW
+
+static void check(bool ok, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("  %s: ", ok ? "PASS" : "FAIL");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok)
+    {
+        ++failures;
+    }
+}
+
+//
+// power on, the DS3231 SQW falls at the start of every second.
+//
+static void powerOn()
+{
+    sim.reset();
+    sqw_edges = 0;
+    sim.driveInput(INT_PIN, HIGH);
+    sim.driveInput(PWRFAIL_PIN, HIGH);
+    sim.every(SECONDS(1), MS(500), []()
+    {
+        bool falling = sim.digitalRead(INT_PIN);
+        if (falling)
+        {
+            ++sqw_edges;
+        }
+        sim.driveInput(INT_PIN, !falling);
+        return true;
+    });
+}
+
+static void run(uint64_t until)
+{
+    sim.stopAt(until);
+    while (true)
+    {
+        try
+        {
+            setup();
+            while (true)
+            {
+                loop();
+                sim.loopDone();
+            }
+        }
+        catch (SimReboot&)
+        {
+            printf("  watchdog reboot at %0.3fms\n", CYCLES2MS(sim.now()));
+            continue;
+        }
+        catch (SimStop&)
+        {
+            return;
+        }
+    }
+}
+
+static void write8(uint64_t when, uint8_t command, uint8_t value)
+{
+    std::vector<uint8_t> data;
+    data.push_back(command);
+    data.push_back(value);
+    sim.i2cWrite(when, data);
+}
+
+static void write16(uint64_t when, uint8_t command, uint16_t value)
+{
+    std::vector<uint8_t> data;
+    data.push_back(command);
+    data.push_back(value & 0xff);
+    data.push_back(value >> 8);
+    sim.i2cWrite(when, data);
+}
+
+static void enable(uint64_t when)
+{
+    write8(when, CMD_CONTROL, BIT_ENABLE);
+}
+
+static uint16_t expectedPosition(uint16_t start, int steps)
+{
+    return ((uint32_t)start + MAX_SECONDS + steps) % MAX_SECONDS;
+}
+
+typedef struct pulse_summary
+{
+    unsigned int count;
+    double       min_ms;
+    double       max_ms;
+    double       avg_ms;
+} PulseSummary;
+
+static PulseSummary summarize(size_t first, size_t last)
+{
+    PulseSummary s;
+    memset(&s, 0, sizeof(s));
+    for (size_t i = first; i < last && i < sim.pulses.size(); ++i)
+    {
+        double width = CYCLES2MS(sim.pulses[i].width);
+        if (s.count == 0 || width < s.min_ms)
+        {
+            s.min_ms = width;
+        }
+        if (width > s.max_ms)
+        {
+            s.max_ms = width;
+        }
+        s.avg_ms += width;
+        s.count  += 1;
+    }
+    if (s.count)
+    {
+        s.avg_ms /= s.count;
+    }
+    return s;
+}
+
+static void checkWidths(const char* name, PulseSummary s, unsigned int duration_ms)
+{
+    printf("  %s pulses: %u width min/avg/max: %0.3f/%0.3f/%0.3fms (config %ums)\n",
+            name, s.count, s.min_ms, s.avg_ms, s.max_ms, duration_ms);
+    check(s.count > 0 && s.min_ms >= duration_ms && s.max_ms <= duration_ms + PULSE_SLOP_MS,
+            "%s pulse width within %ums..%0.1fms", name, duration_ms, duration_ms + PULSE_SLOP_MS);
+}
+
+static void reportLoad()
+{
+    static const char* names[SIM_VECT_COUNT] = { "PCINT0", "TIMER1_COMPA", "TIMER1_OVF", "USI" };
+    uint64_t total = sim.now();
+    uint64_t isr   = 0;
+
+    printf("  isr             count     cycles\n");
+    for (int v = 0; v < SIM_VECT_COUNT; ++v)
+    {
+        printf("  %-12s %8llu %10llu\n", names[v], (unsigned long long)sim.stats.isr_count[v], (unsigned long long)sim.stats.isr_cycles[v]);
+        isr += sim.stats.isr_cycles[v];
+    }
+    printf("  isr load: %0.3f%% active: %0.3f%% idle: %0.3f%% power down: %0.3f%% wakeups: %llu max nesting: %u\n",
+            100.0 * isr / total,
+            100.0 * sim.stats.active_cycles / total,
+            100.0 * sim.stats.idle_cycles / total,
+            100.0 * sim.stats.powerdown_cycles / total,
+            (unsigned long long)sim.stats.wakeups,
+            sim.stats.max_isr_depth);
+
+    uint64_t pulse_cycles = 0;
+    for (size_t i = 0; i < sim.pulses.size(); ++i)
+    {
+        pulse_cycles += sim.pulses[i].width;
+    }
+    if (pulse_cycles)
+    {
+        printf("  isr load during pulses (TIMER1_OVF): %0.2f%%\n", 100.0 * sim.stats.isr_cycles[SIM_VECT_TIMER1_OVF] / pulse_cycles);
+    }
+
+    check(sim.stats.missed_irqs == 0, "no missed timer interrupts (%llu)", (unsigned long long)sim.stats.missed_irqs);
+    check(sim.stats.i2c_overflows == 0, "no TWI buffer overflows (%u)", sim.stats.i2c_overflows);
+}
+
+//
+// enabled clock ticking once a second
+//
+static void scenarioTick()
+{
+    powerOn();
+    enable(MS(200));
+    run(SECONDS(65) + MS(500));
+
+    // the first tick is the power on adjust: start pulse + tick pulse
+    unsigned int ticks = sqw_edges;
+    check(sim.pulses.size() == ticks + 1, "pulse count %u for %u ticks + 1 startup adjust", (unsigned int)sim.pulses.size(), ticks);
+
+    bool alternates = true;
+    for (size_t i = 1; i < sim.pulses.size(); ++i)
+    {
+        alternates = alternates && sim.pulses[i].channel != sim.pulses[i-1].channel;
+    }
+    check(alternates, "tick/tock channels alternate");
+
+    checkWidths("adjust start", summarize(0, 1), config.ap_start_duration);
+    checkWidths("tick", summarize(1, sim.pulses.size()), config.tp_duration);
+
+    double duty = sim.pulses.size() > 1 ? sim.pulses[1].duty : 0.0;
+    printf("  tick duty: %0.1f%% (config %u%%)\n", duty, config.tp_duty);
+    check(fabs(duty - config.tp_duty) < 1.0, "tick duty within 1%% of config");
+
+    uint16_t expected = expectedPosition(MAX_SECONDS - 1, ticks + 1);
+    check(position == expected, "position %u expected %u", position, expected);
+
+    reportLoad();
+}
+
+//
+// fast forward 1000 seconds while ticking
+//
+static void scenarioAdjust()
+{
+    static const uint16_t ADJUST = 1000;
+    static uint64_t       started;
+    static uint64_t       finished;
+    static size_t         first_pulse;
+    static unsigned int   edges_at_start;
+
+    powerOn();
+    enable(MS(200));
+    started  = SECONDS(2) + MS(300);
+    finished = 0;
+    write16(started, CMD_ADJUSTMENT, ADJUST);
+    sim.at(started, []()
+    {
+        first_pulse    = sim.pulses.size();
+        edges_at_start = sqw_edges;
+    });
+    sim.every(started + MS(10), MS(10), []()
+    {
+        if (adjustment == 0 && !adjust_active)
+        {
+            finished = sim.now();
+            sim.stopAt(finished + MS(100));
+            return false;
+        }
+        return true;
+    });
+    run(SECONDS(120));
+
+    check(finished != 0, "adjustment finished");
+    if (!finished)
+    {
+        return;
+    }
+
+    size_t   last    = sim.pulses.size();
+    unsigned int steps = last - first_pulse;
+    uint64_t begin   = sim.pulses[first_pulse].start;
+    uint64_t end     = sim.pulses[last-1].start + sim.pulses[last-1].width;
+    double   seconds = CYCLES2MS(end - begin) / 1000.0;
+
+    printf("  adjusted %u in %0.3fs: %u steps, %0.2f steps/s, %0.2f seconds gained/s\n",
+            ADJUST, seconds, steps, steps / seconds, ADJUST / seconds);
+
+    double gap = 0.0;
+    for (size_t i = first_pulse + 1; i < last; ++i)
+    {
+        gap += CYCLES2MS(sim.pulses[i].start - sim.pulses[i-1].start);
+    }
+    gap /= (last - first_pulse - 1);
+    printf("  step period: %0.3fms (ap_duration %u + ap_delay %u)\n", gap, config.ap_duration, config.ap_delay);
+
+    checkWidths("adjust start", summarize(first_pulse, first_pulse + 1), config.ap_start_duration);
+    checkWidths("adjust", summarize(first_pulse + 1, last - 1), config.ap_duration);
+    checkWidths("final", summarize(last - 1, last), config.tp_duration);
+
+    unsigned int ticks_during = sqw_edges - edges_at_start;
+    check(steps == ADJUST + ticks_during, "steps %u == adjustment %u + %u ticks during", steps, ADJUST, ticks_during);
+
+    uint16_t expected = expectedPosition(MAX_SECONDS - 1, 1 + sqw_edges + ADJUST);
+    check(position == expected, "position %u expected %u", position, expected);
+
+    reportLoad();
+}
+
+//
+// register protocol as seen from the i2c master
+//
+static void scenarioProtocol()
+{
+    powerOn();
+
+    sim.i2cRead(MS(100), CMD_ID, 1, [](const std::vector<uint8_t>& r)
+    {
+        check(r[0] == ID_VALUE, "CMD_ID returns 0x%02x", r[0]);
+    });
+    sim.i2cRead(MS(110), CMD_VERSION, 1, [](const std::vector<uint8_t>& r)
+    {
+        check(r[0] == I2C_ANALOG_CLOCK_VERSION, "CMD_VERSION returns %u", r[0]);
+    });
+    sim.i2cRead(MS(120), CMD_SNAPSHOT, SNAPSHOT_SIZE, [](const std::vector<uint8_t>& r)
+    {
+        uint16_t pos = r[5] | r[6] << 8;
+        uint16_t adj = r[7] | r[8] << 8;
+        check(r[0] == ID_VALUE && r[1] == I2C_ANALOG_CLOCK_VERSION && pos == MAX_SECONDS - 1 && adj == 1,
+                "CMD_SNAPSHOT id:0x%02x version:%u position:%u adjustment:%u", r[0], r[1], pos, adj);
+    });
+
+    static const uint8_t values[sizeof(Config)] = { 30, 40, 16, 50, 10, 33, 200 };
+    std::vector<uint8_t> block(values, values + sizeof(values));
+    block.insert(block.begin(), CMD_CONFIG);
+    sim.i2cWrite(MS(130), block);
+    sim.i2cRead(MS(140), CMD_TP_DURATION, 1, [](const std::vector<uint8_t>& r)
+    {
+        check(r[0] == values[0], "config block write sets tp_duration (%u)", r[0]);
+    });
+    sim.i2cRead(MS(150), CMD_PWMTOP, 1, [](const std::vector<uint8_t>& r)
+    {
+        check(r[0] == values[6], "config block write sets pwm_top (%u)", r[0]);
+    });
+    sim.i2cRead(MS(160), CMD_CONFIG, sizeof(Config), [](const std::vector<uint8_t>& r)
+    {
+        check(memcmp(r.data(), values, sizeof(values)) == 0, "config block read matches");
+    });
+
+    run(MS(500));
+    check(sim.stats.i2c_transactions == 13, "%u i2c transactions", sim.stats.i2c_transactions);
+    check(sim.stats.i2c_overflows == 0, "no TWI buffer overflows (%u)", sim.stats.i2c_overflows);
+}
+
+//
+// controller side target planning: fast forward when behind, pause when ahead
+//
+static void scenarioTarget()
+{
+    static uint16_t     target;
+    static unsigned int edges_at_target;
+    static size_t       pulses_at_target;
+
+    powerOn();
+    enable(MS(200));
+
+    // behind by 50: expect a fast forward starting on the next tick
+    sim.at(SECONDS(3) + MS(300), []()
+    {
+        target = expectedPosition(position, 1 + 50);
+        std::vector<uint8_t> data;
+        data.push_back(CMD_TARGET);
+        data.push_back(target & 0xff);
+        data.push_back(target >> 8);
+        data.push_back(1);
+        data.push_back(0);
+        sim.i2cWrite(sim.now(), data);
+        edges_at_target  = sqw_edges + 1;
+        pulses_at_target = sim.pulses.size();
+    });
+    sim.at(SECONDS(8) + MS(300), []()
+    {
+        unsigned int steps = sim.pulses.size() - pulses_at_target;
+        uint16_t expected = expectedPosition(target, sqw_edges - edges_at_target);
+        check(position == expected, "fast forward: position %u expected %u", position, expected);
+        check(steps > 50, "fast forward: %u steps", steps);
+    });
+
+    // ahead by 3: expect a pause of 3 ticks
+    sim.at(SECONDS(10) + MS(300), []()
+    {
+        target = expectedPosition(position, 1 - 3);
+        std::vector<uint8_t> data;
+        data.push_back(CMD_TARGET);
+        data.push_back(target & 0xff);
+        data.push_back(target >> 8);
+        data.push_back(1);
+        data.push_back(0);
+        sim.i2cWrite(sim.now(), data);
+        edges_at_target  = sqw_edges + 1;
+        pulses_at_target = sim.pulses.size();
+    });
+    sim.at(SECONDS(13) + MS(500), []()
+    {
+        check(sim.pulses.size() == pulses_at_target, "pause: no pulses for 3 ticks");
+    });
+    sim.at(SECONDS(16) + MS(300), []()
+    {
+        uint16_t expected = expectedPosition(target, sqw_edges - edges_at_target);
+        check(position == expected, "pause: position %u expected %u", position, expected);
+    });
+
+    run(SECONDS(17));
+    reportLoad();
+}
+
+typedef struct scenario
+{
+    const char* name;
+    void      (*func)();
+} Scenario;
+
+static const Scenario scenarios[] =
+{
+    { "tick",     scenarioTick     },
+    { "adjust",   scenarioAdjust   },
+    { "protocol", scenarioProtocol },
+    { "target",   scenarioTarget   },
+};
+
+#define SCENARIO_COUNT (sizeof(scenarios) / sizeof(scenarios[0]))
+
+//
+// each scenario gets its own process so the firmware globals start out
+// zeroed just like they do at power on.
+//
+static int runScenario(const Scenario& s)
+{
+    printf("%s:\n", s.name);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        failures = 0;
+        s.func();
+        fflush(stdout);
+        _exit(failures ? 1 : 0);
+    }
+
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        printf("  FAIL: scenario did not complete\n");
+        return 1;
+    }
+    return WEXITSTATUS(status);
+}
+
+int main(int argc, char** argv)
+{
+    int failed = 0;
+    for (size_t i = 0; i < SCENARIO_COUNT; ++i)
+    {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; ++a)
+        {
+            selected = selected || !strcmp(argv[a], scenarios[i].name);
+        }
+        if (selected)
+        {
+            failed += runScenario(scenarios[i]) ? 1 : 0;
+        }
+    }
+
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * PinChangeInterrupt.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef PINCHANGEINTERRUPT_H_
+#define PINCHANGEINTERRUPT_H_
+
+#include "Arduino.h"
+
+// on the ATtiny85 the pin change interrupt number is the pin number
+#define digitalPinToPinChangeInterrupt(pin) (pin)
+
+inline void attachPinChangeInterrupt(uint8_t pcint, void (*func)(), uint8_t mode)
+{
+    sim.attachPinChange(pcint, func, mode);
+}
+
+#endif /* PINCHANGEINTERRUPT_H_ */
@@ -0,0 +1,754 @@
+/*
+ * SimAVR.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimAVR.h"
+#include <string.h>
+
+#define _BV(b)        (1 << (b))
+#define NEVER         UINT64_MAX
+
+#define EVENT_NONE    0
+#define EVENT_TIMER   1
+#define EVENT_ACTION  2
+
+SimAVR sim;
+
+SimReg8 TCCR1(SIM_TCCR1);
+SimReg8 GTCCR(SIM_GTCCR);
+SimReg8 TIMSK(SIM_TIMSK);
+SimReg8 TIFR(SIM_TIFR);
+SimReg8 TCNT1(SIM_TCNT1);
+SimReg8 OCR1A(SIM_OCR1A);
+SimReg8 OCR1B(SIM_OCR1B);
+SimReg8 OCR1C(SIM_OCR1C);
+SimReg8 MCUSR(SIM_MCUSR);
+SimReg8 ADCSRA(SIM_ADCSRA);
+SimReg8 PRR(SIM_PRR);
+
+SimReg8::SimReg8(SimRegId _id)
+{
+    id = _id;
+}
+
+SimReg8::operator uint8_t() const
+{
+    return sim.readReg(id);
+}
+
+SimReg8& SimReg8::operator=(int value)
+{
+    sim.writeReg(id, value);
+    return *this;
+}
+
+SimReg8& SimReg8::operator|=(int value)
+{
+    sim.writeReg(id, sim.readReg(id) | value);
+    return *this;
+}
+
+SimReg8& SimReg8::operator&=(int value)
+{
+    sim.writeReg(id, sim.readReg(id) & value);
+    return *this;
+}
+
+SimReg8& SimReg8::operator^=(int value)
+{
+    sim.writeReg(id, sim.readReg(id) ^ value);
+    return *this;
+}
+
+SimAVR::SimAVR()
+{
+    reset();
+}
+
+//
+// power on reset
+//
+void SimAVR::reset()
+{
+    cycle           = 0;
+    stop_cycle      = NEVER;
+    powerdown_total = 0;
+    interrupts      = true; // the Arduino core enables them before setup()
+    isr_depth       = 0;
+    isr_reg_writes  = 0;
+    sleep_mode      = SIM_SLEEP_IDLE;
+
+    memset(regs, 0, sizeof(regs));
+    regs[SIM_OCR1C] = 0xff;
+    regs[SIM_MCUSR] = 0x01; // PORF
+
+    t0         = 0;
+    c0         = 0;
+    prescale   = 0;
+    timer_last = 0;
+
+    pulse_active = false;
+    memset(&pulse, 0, sizeof(pulse));
+    pulses.clear();
+
+    memset(pin_mode, 0, sizeof(pin_mode));
+    memset(pin_level, 0, sizeof(pin_level));
+    memset(pin_change, 0, sizeof(pin_change));
+    memset(pin_change_mode, 0, sizeof(pin_change_mode));
+    pcint_pending = 0;
+
+    on_receive = NULL;
+    on_request = NULL;
+    rx.clear();
+    rx_pos = 0;
+    tx.clear();
+    i2c_busy_until = 0;
+    usi_queue.clear();
+
+    memset(eeprom, 0xff, sizeof(eeprom));
+    memset(&stats, 0, sizeof(stats));
+    events.clear();
+}
+
+uint64_t SimAVR::now()
+{
+    return cycle;
+}
+
+//
+// cycles the cpu clock has been running, millis() stops in power down
+//
+uint64_t SimAVR::awake()
+{
+    return cycle - powerdown_total;
+}
+
+void SimAVR::stopAt(uint64_t when)
+{
+    stop_cycle = when;
+}
+
+void SimAVR::at(uint64_t when, std::function<void()> action)
+{
+    Scheduled s;
+    s.period = 0;
+    s.action = [action]() { action(); return false; };
+    events.insert(std::make_pair(when, s));
+}
+
+//
+// run action at first and then every period cycles for as long as it returns true
+//
+void SimAVR::every(uint64_t first, uint64_t period, std::function<bool()> action)
+{
+    Scheduled s;
+    s.period = period;
+    s.action = action;
+    events.insert(std::make_pair(first, s));
+}
+
+void SimAVR::setInterrupts(bool enabled)
+{
+    interrupts = enabled;
+    if (enabled)
+    {
+        service();
+    }
+}
+
+void SimAVR::sleepMode(SimSleepMode mode)
+{
+    sleep_mode = mode;
+}
+
+//
+// sleep_cpu(): advance virtual time to the next event that raises an
+// enabled interrupt, Timer1 is stopped in power down.
+//
+void SimAVR::sleep()
+{
+    SimVector vector;
+    if (interrupts && pending(&vector))
+    {
+        service();
+        return;
+    }
+
+    SimSleepMode mode   = sleep_mode;
+    uint32_t     frozen = timerCount(cycle);
+
+    while (true)
+    {
+        int      kind;
+        uint8_t  flag;
+        uint64_t when = nextEvent(mode != SIM_SLEEP_PWR_DOWN, &kind, &flag);
+
+        uint64_t until = when > stop_cycle ? stop_cycle : when;
+        if (until > cycle)
+        {
+            uint64_t span = until - cycle;
+            if (mode == SIM_SLEEP_PWR_DOWN)
+            {
+                stats.powerdown_cycles += span;
+                powerdown_total        += span;
+            }
+            else
+            {
+                stats.idle_cycles += span;
+            }
+            cycle = until;
+        }
+
+        if (when > stop_cycle)
+        {
+            throw SimStop();
+        }
+
+        runEvent(kind, flag);
+        if (interrupts && pending(&vector))
+        {
+            break;
+        }
+    }
+
+    if (mode == SIM_SLEEP_PWR_DOWN)
+    {
+        // the timer clock was stopped while we slept
+        t0         = cycle;
+        c0         = frozen;
+        timer_last = cycle;
+    }
+
+    stats.wakeups += 1;
+    service();
+}
+
+//
+// busy wait (delay()), events and interrupts keep running
+//
+void SimAVR::busy(uint64_t cycles)
+{
+    uint64_t target = cycle + cycles;
+    while (true)
+    {
+        int      kind;
+        uint8_t  flag;
+        uint64_t when = nextEvent(true, &kind, &flag);
+        if (when > target || when > stop_cycle)
+        {
+            break;
+        }
+        if (when > cycle)
+        {
+            stats.active_cycles += when - cycle;
+            cycle = when;
+        }
+        runEvent(kind, flag);
+        service();
+    }
+    if (target > stop_cycle)
+    {
+        throw SimStop();
+    }
+    if (target > cycle)
+    {
+        stats.active_cycles += target - cycle;
+        cycle = target;
+    }
+}
+
+void SimAVR::loopDone()
+{
+    cycle               += SIM_COST_LOOP;
+    stats.active_cycles += SIM_COST_LOOP;
+}
+
+uint8_t SimAVR::readReg(SimRegId id)
+{
+    if (id == SIM_TCNT1)
+    {
+        return timerCount(cycle) & 0xff;
+    }
+    return regs[id];
+}
+
+void SimAVR::writeReg(SimRegId id, uint8_t value)
+{
+    if (isr_depth > 0)
+    {
+        isr_reg_writes += 1;
+    }
+
+    switch (id)
+    {
+    case SIM_TIFR:
+        // writing a one clears the flag
+        regs[SIM_TIFR] &= ~value;
+        break;
+
+    case SIM_TCNT1:
+        regs[id] = value;
+        timerRestart(value);
+        break;
+
+    case SIM_TCCR1:
+    case SIM_GTCCR:
+    case SIM_OCR1C:
+    {
+        uint32_t count = timerCount(cycle);
+        regs[id] = value;
+        uint8_t cs = regs[SIM_TCCR1] & 0x0f;
+        prescale = cs ? 1 << (cs - 1) : 0;
+        timerRestart(count % (timerTop() + 1));
+        break;
+    }
+
+    default:
+        regs[id] = value;
+        break;
+    }
+
+    if (id == SIM_TCCR1 || id == SIM_GTCCR || id == SIM_OCR1A || id == SIM_OCR1B || id == SIM_OCR1C)
+    {
+        updatePulse();
+    }
+
+    if (id == SIM_TIMSK && interrupts)
+    {
+        service();
+    }
+}
+
+void SimAVR::pinMode(uint8_t pin, uint8_t mode)
+{
+    pin_mode[pin & 7] = mode;
+}
+
+void SimAVR::digitalWrite(uint8_t pin, uint8_t value)
+{
+    pin_level[pin & 7] = value ? 1 : 0;
+}
+
+int SimAVR::digitalRead(uint8_t pin)
+{
+    return pin_level[pin & 7];
+}
+
+//
+// external signal on an input pin, raises the pin change interrupt
+// if the edge matches the attached mode.
+//
+void SimAVR::driveInput(uint8_t pin, uint8_t value)
+{
+    pin &= 7;
+    uint8_t old = pin_level[pin];
+    pin_level[pin] = value ? 1 : 0;
+    if (old == pin_level[pin] || pin_change[pin] == NULL)
+    {
+        return;
+    }
+
+    uint8_t mode = pin_change_mode[pin];
+    if (mode == SIM_CHANGE || (mode == SIM_FALLING && !value) || (mode == SIM_RISING && value))
+    {
+        pcint_pending |= 1 << pin;
+    }
+}
+
+void SimAVR::attachPinChange(uint8_t pin, void (*func)(), uint8_t mode)
+{
+    pin_change[pin & 7]      = func;
+    pin_change_mode[pin & 7] = mode;
+}
+
+uint64_t SimAVR::i2cDuration(size_t bytes)
+{
+    // address byte + data bytes
+    return (bytes + 1) * SIM_I2C_BYTE_US * (F_CPU / 1000000L);
+}
+
+//
+// master write: command byte followed by any data
+//
+void SimAVR::i2cWrite(uint64_t when, const std::vector<uint8_t>& data)
+{
+    at(when, [this, data]()
+    {
+        uint64_t end = cycle + i2cDuration(data.size());
+        i2c_busy_until = end;
+        at(end, [this, data]()
+        {
+            usi_queue.push_back(std::make_pair(data.size() + 1, [this, data]()
+            {
+                stats.i2c_transactions += 1;
+                rx = data;
+                if (rx.size() > SIM_TWI_BUFFER_SIZE)
+                {
+                    stats.i2c_overflows += rx.size() - SIM_TWI_BUFFER_SIZE;
+                    rx.resize(SIM_TWI_BUFFER_SIZE);
+                }
+                rx_pos = 0;
+                if (on_receive != NULL)
+                {
+                    on_receive(rx.size());
+                }
+            }));
+        });
+    });
+}
+
+//
+// master write of the command byte then a repeated start read of size bytes
+//
+void SimAVR::i2cRead(uint64_t when, uint8_t command, size_t size, std::function<void(const std::vector<uint8_t>&)> done)
+{
+    std::vector<uint8_t> cmd(1, command);
+    i2cWrite(when, cmd);
+    uint64_t request = when + i2cDuration(1) + i2cDuration(0);
+    at(request, [this, size, done]()
+    {
+        uint64_t end = cycle + i2cDuration(size);
+        i2c_busy_until = end;
+        usi_queue.push_back(std::make_pair(1, [this]()
+        {
+            tx.clear();
+            if (on_request != NULL)
+            {
+                on_request();
+            }
+        }));
+        at(end, [this, size, done]()
+        {
+            usi_queue.push_back(std::make_pair(size, [this, size, done]()
+            {
+                stats.i2c_transactions += 1;
+                std::vector<uint8_t> result = tx;
+                result.resize(size, 0xff); // master reads 0xff past what the slave sent
+                done(result);
+            }));
+        });
+    });
+}
+
+bool SimAVR::i2cActive()
+{
+    return cycle < i2c_busy_until;
+}
+
+void SimAVR::wireBegin(void (*receive)(int), void (*request)())
+{
+    on_receive = receive;
+    on_request = request;
+}
+
+int SimAVR::wireRead()
+{
+    if (rx_pos >= rx.size())
+    {
+        return -1;
+    }
+    return rx[rx_pos++];
+}
+
+int SimAVR::wireAvailable()
+{
+    return rx.size() - rx_pos;
+}
+
+size_t SimAVR::wireWrite(uint8_t value)
+{
+    if (tx.size() >= SIM_TWI_BUFFER_SIZE)
+    {
+        stats.i2c_overflows += 1;
+        return 0;
+    }
+    tx.push_back(value);
+    return 1;
+}
+
+bool SimAVR::timerRunning()
+{
+    return prescale != 0;
+}
+
+uint32_t SimAVR::timerTop()
+{
+    if ((regs[SIM_TCCR1] & (_BV(CTC1) | _BV(PWM1A))) || (regs[SIM_GTCCR] & _BV(PWM1B)))
+    {
+        return regs[SIM_OCR1C];
+    }
+    return 0xff;
+}
+
+uint32_t SimAVR::timerCount(uint64_t when)
+{
+    if (!timerRunning() || when < t0)
+    {
+        return c0;
+    }
+    return (c0 + (when - t0) / prescale) % (timerTop() + 1);
+}
+
+void SimAVR::timerRestart(uint32_t count)
+{
+    t0         = cycle;
+    c0         = count;
+    timer_last = cycle;
+}
+
+//
+// first cycle after 'after' where the count becomes value
+//
+uint64_t SimAVR::timerNext(uint32_t value, uint64_t after)
+{
+    uint64_t period = timerTop() + 1;
+    if (value >= period)
+    {
+        return NEVER;
+    }
+
+    uint64_t base  = (value + period - c0 % period) % period;
+    uint64_t n_min = after >= t0 ? (after - t0) / prescale + 1 : 0;
+    uint64_t n     = base;
+    if (n_min > base)
+    {
+        n = base + ((n_min - base + period - 1) / period) * period;
+    }
+    return t0 + n * prescale;
+}
+
+bool SimAVR::nextTimerEvent(uint64_t* when, uint8_t* flag)
+{
+    if (!timerRunning())
+    {
+        return false;
+    }
+
+    uint64_t overflow = timerNext(0, timer_last);
+    uint64_t compare  = timerNext(regs[SIM_OCR1A], timer_last);
+
+    *when = overflow < compare ? overflow : compare;
+    *flag = 0;
+    if (overflow == *when)
+    {
+        *flag |= _BV(TOV1);
+    }
+    if (compare == *when)
+    {
+        *flag |= _BV(OCF1A);
+    }
+    return true;
+}
+
+void SimAVR::setFlag(uint8_t flag)
+{
+    // an enabled interrupt whose flag is still set loses this event
+    uint8_t enabled = 0;
+    if (regs[SIM_TIMSK] & _BV(TOIE1))
+    {
+        enabled |= _BV(TOV1);
+    }
+    if (regs[SIM_TIMSK] & _BV(OCIE1A))
+    {
+        enabled |= _BV(OCF1A);
+    }
+
+    uint8_t lost = regs[SIM_TIFR] & flag & enabled;
+    for (; lost; lost &= lost - 1)
+    {
+        stats.missed_irqs += 1;
+    }
+    regs[SIM_TIFR] |= flag;
+}
+
+void SimAVR::updatePulse()
+{
+    bool a      = (regs[SIM_TCCR1] & _BV(PWM1A)) && (regs[SIM_TCCR1] & _BV(COM1A1));
+    bool b      = (regs[SIM_GTCCR] & _BV(PWM1B)) && (regs[SIM_GTCCR] & _BV(COM1B1));
+    bool active = timerRunning() && (a || b);
+
+    if (active && !pulse_active)
+    {
+        pulse.start   = cycle;
+        pulse.channel = a ? 0 : 1;
+        pulse.duty    = 100.0 * (a ? regs[SIM_OCR1A] : regs[SIM_OCR1B]) / (regs[SIM_OCR1C] + 1);
+    }
+    else if (!active && pulse_active)
+    {
+        pulse.width = cycle - pulse.start;
+        pulses.push_back(pulse);
+    }
+    pulse_active = active;
+}
+
+uint64_t SimAVR::nextEvent(bool include_timer, int* kind, uint8_t* flag)
+{
+    uint64_t when = NEVER;
+    *kind = EVENT_NONE;
+
+    uint64_t timer;
+    if (include_timer && nextTimerEvent(&timer, flag))
+    {
+        when  = timer;
+        *kind = EVENT_TIMER;
+    }
+
+    if (!events.empty() && events.begin()->first < when)
+    {
+        when  = events.begin()->first;
+        *kind = EVENT_ACTION;
+    }
+
+    return when;
+}
+
+void SimAVR::runEvent(int kind, uint8_t flag)
+{
+    if (kind == EVENT_TIMER)
+    {
+        uint64_t when;
+        nextTimerEvent(&when, &flag);
+        timer_last = when;
+        setFlag(flag);
+    }
+    else if (kind == EVENT_ACTION)
+    {
+        std::multimap<uint64_t, Scheduled>::iterator it = events.begin();
+        uint64_t  when = it->first;
+        Scheduled s    = it->second;
+        events.erase(it);
+        if (s.action() && s.period != 0)
+        {
+            events.insert(std::make_pair(when + s.period, s));
+        }
+    }
+}
+
+bool SimAVR::pending(SimVector* vector)
+{
+    if (pcint_pending)
+    {
+        *vector = SIM_VECT_PCINT0;
+        return true;
+    }
+    if ((regs[SIM_TIFR] & _BV(OCF1A)) && (regs[SIM_TIMSK] & _BV(OCIE1A)))
+    {
+        *vector = SIM_VECT_TIMER1_COMPA;
+        return true;
+    }
+    if ((regs[SIM_TIFR] & _BV(TOV1)) && (regs[SIM_TIMSK] & _BV(TOIE1)))
+    {
+        *vector = SIM_VECT_TIMER1_OVF;
+        return true;
+    }
+    if (!usi_queue.empty())
+    {
+        *vector = SIM_VECT_USI;
+        return true;
+    }
+    return false;
+}
+
+//
+// run pending interrupts, catching up on events that happened while
+// the previous ISR was running.
+//
+void SimAVR::service()
+{
+    while (interrupts)
+    {
+        int      kind;
+        uint8_t  flag;
+        while (nextEvent(true, &kind, &flag) <= cycle)
+        {
+            runEvent(kind, flag);
+        }
+
+        SimVector vector;
+        if (!pending(&vector))
+        {
+            break;
+        }
+        runISR(vector);
+    }
+}
+
+void SimAVR::runISR(SimVector vector)
+{
+    interrupts = false;
+    isr_depth += 1;
+    if (isr_depth > stats.max_isr_depth)
+    {
+        stats.max_isr_depth = isr_depth;
+    }
+    unsigned int saved_writes = isr_reg_writes;
+    isr_reg_writes = 0;
+
+    uint64_t cost = SIM_COST_ISR;
+    switch (vector)
+    {
+    case SIM_VECT_PCINT0:
+    {
+        uint8_t pins = pcint_pending;
+        pcint_pending = 0;
+        cost += SIM_COST_PCINT;
+        for (int pin = 0; pin < 8; ++pin)
+        {
+            if ((pins & (1 << pin)) && pin_change[pin] != NULL)
+            {
+                pin_change[pin]();
+            }
+        }
+        break;
+    }
+    case SIM_VECT_TIMER1_COMPA:
+        regs[SIM_TIFR] &= ~_BV(OCF1A);
+        cost += SIM_COST_TIMER1_CMP;
+        TIMER1_COMPA_vect();
+        break;
+    case SIM_VECT_TIMER1_OVF:
+        regs[SIM_TIFR] &= ~_BV(TOV1);
+        cost += SIM_COST_TIMER1_OVF;
+        TIMER1_OVF_vect();
+        break;
+    case SIM_VECT_USI:
+    {
+        std::pair<size_t, std::function<void()> > usi = usi_queue.front();
+        usi_queue.erase(usi_queue.begin());
+        cost += usi.first * SIM_COST_USI_BYTE;
+        usi.second();
+        break;
+    }
+    default:
+        break;
+    }
+
+    cost += isr_reg_writes * SIM_COST_REG_WRITE;
+    isr_reg_writes = saved_writes;
+
+    stats.isr_count[vector]  += 1;
+    stats.isr_cycles[vector] += cost;
+    stats.active_cycles      += cost;
+    cycle                    += cost;
+
+    isr_depth -= 1;
+    interrupts = true; // reti
+}
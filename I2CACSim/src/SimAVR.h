@@ -0,0 +1,280 @@
+/*
+ * SimAVR.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMAVR_H_
+#define SIMAVR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+//
+// Cycle-approximate model of the parts of an ATtiny85 that I2CAnalogClock
+// uses: Timer1 (CTC/PWM, OCR1A/B/C, TOV1/OCF1A flags), pin change
+// interrupts, the USI I2C slave, EEPROM and the sleep modes.  Time is
+// virtual and counted in CPU cycles, at 1MHz that is one cycle per
+// microsecond.  Firmware code between interrupts runs in zero time,
+// each ISR is charged an estimated cycle cost (see SimCost) so the
+// ISR load and any latency it adds to the pulses can be measured.
+//
+
+#ifndef F_CPU
+#define F_CPU 1000000L
+#endif
+
+#define SIM_EEPROM_SIZE     512
+#define SIM_TWI_BUFFER_SIZE 16   // USI TWI slave rx/tx buffer size
+#define SIM_I2C_BYTE_US     90   // 9 bits at 100khz
+
+// estimated cycle costs
+#define SIM_COST_ISR        34   // vector jump, prologue, epilogue & reti
+#define SIM_COST_TIMER1_OVF 20   // pwm count down
+#define SIM_COST_TIMER1_CMP 30   // compare match (millis() check)
+#define SIM_COST_PCINT      110  // PinChangeInterrupt dispatch
+#define SIM_COST_USI_BYTE   60   // USI TWI state machine per byte
+#define SIM_COST_REG_WRITE  3    // per i/o register write inside an ISR
+#define SIM_COST_LOOP       40   // one trip through loop()
+
+// ATtiny85 register bits
+#define CTC1    7
+#define PWM1A   6
+#define COM1A1  5
+#define COM1A0  4
+#define CS13    3
+#define CS12    2
+#define CS11    1
+#define CS10    0
+#define PWM1B   6
+#define COM1B1  5
+#define COM1B0  4
+#define OCIE1A  6
+#define OCIE1B  5
+#define TOIE1   2
+#define OCF1A   6
+#define OCF1B   5
+#define TOV1    2
+#define ADEN    7
+#define PRADC   0
+
+enum SimRegId
+{
+    SIM_TCCR1, SIM_GTCCR, SIM_TIMSK, SIM_TIFR, SIM_TCNT1,
+    SIM_OCR1A, SIM_OCR1B, SIM_OCR1C, SIM_MCUSR, SIM_ADCSRA, SIM_PRR,
+    SIM_REG_COUNT
+};
+
+//
+// an 8 bit i/o register, reads and writes go through the simulator so
+// timer changes and flag clearing take effect when the firmware writes.
+//
+class SimReg8
+{
+public:
+    SimReg8(SimRegId id);
+    operator uint8_t() const;
+    SimReg8& operator=(int value);
+    SimReg8& operator|=(int value);
+    SimReg8& operator&=(int value);
+    SimReg8& operator^=(int value);
+private:
+    SimRegId id;
+};
+
+enum SimVector
+{
+    // in AVR priority order
+    SIM_VECT_PCINT0,
+    SIM_VECT_TIMER1_COMPA,
+    SIM_VECT_TIMER1_OVF,
+    SIM_VECT_USI,
+    SIM_VECT_COUNT
+};
+
+// pin change modes, same values as the Arduino RISING/FALLING/CHANGE
+#define SIM_CHANGE  1
+#define SIM_FALLING 2
+#define SIM_RISING  3
+
+enum SimSleepMode
+{
+    SIM_SLEEP_IDLE,
+    SIM_SLEEP_PWR_DOWN
+};
+
+typedef struct sim_pulse
+{
+    uint64_t start;    // cycle the PWM output started
+    uint32_t width;    // cycles the PWM output was enabled
+    uint8_t  channel;  // 0=A (tick) 1=B (tock)
+    double   duty;     // % from OCR1x/(OCR1C+1)
+} SimPulse;
+
+typedef struct sim_stats
+{
+    uint64_t isr_count[SIM_VECT_COUNT];
+    uint64_t isr_cycles[SIM_VECT_COUNT];
+    uint64_t active_cycles;     // ISRs + loop()
+    uint64_t idle_cycles;       // SLEEP_MODE_IDLE
+    uint64_t powerdown_cycles;  // SLEEP_MODE_PWR_DOWN
+    uint64_t missed_irqs;       // flag was still set when the event happened again
+    uint64_t wakeups;
+    unsigned int i2c_transactions;
+    unsigned int i2c_overflows; // bytes dropped for the TWI buffer size
+    unsigned int max_isr_depth;
+} SimStats;
+
+class SimStop
+{
+};
+
+class SimReboot
+{
+};
+
+class SimAVR
+{
+public:
+    SimAVR();
+    void     reset();
+
+    // virtual time
+    uint64_t now();
+    uint64_t awake();
+    void     stopAt(uint64_t cycle);
+    void     at(uint64_t cycle, std::function<void()> action);
+    void     every(uint64_t first, uint64_t period, std::function<bool()> action);
+
+    // cpu & interrupts
+    void     setInterrupts(bool enabled);
+    void     sleepMode(SimSleepMode mode);
+    void     sleep();
+    void     busy(uint64_t cycles);
+    void     loopDone();
+
+    // registers
+    uint8_t  readReg(SimRegId id);
+    void     writeReg(SimRegId id, uint8_t value);
+
+    // pins
+    void     pinMode(uint8_t pin, uint8_t mode);
+    void     digitalWrite(uint8_t pin, uint8_t value);
+    int      digitalRead(uint8_t pin);
+    void     driveInput(uint8_t pin, uint8_t value);
+    void     attachPinChange(uint8_t pin, void (*func)(), uint8_t mode);
+
+    // i2c master side, results are delivered when the transaction ends
+    void     i2cWrite(uint64_t cycle, const std::vector<uint8_t>& data);
+    void     i2cRead(uint64_t cycle, uint8_t command, size_t size, std::function<void(const std::vector<uint8_t>&)> done);
+    bool     i2cActive();
+
+    // i2c slave side used by the Wire shim
+    void     wireBegin(void (*receive)(int), void (*request)());
+    int      wireRead();
+    int      wireAvailable();
+    size_t   wireWrite(uint8_t value);
+
+    uint8_t  eeprom[SIM_EEPROM_SIZE];
+
+    std::vector<SimPulse> pulses;
+    SimStats stats;
+
+private:
+    struct Scheduled
+    {
+        uint64_t              period;
+        std::function<bool()> action;
+    };
+
+    uint64_t cycle;
+    uint64_t stop_cycle;
+    uint64_t powerdown_total;   // cycles spent in power down, millis() does not count these
+    bool     interrupts;
+    unsigned int isr_depth;
+    unsigned int isr_reg_writes;
+    SimSleepMode sleep_mode;
+
+    uint8_t  regs[SIM_REG_COUNT];
+
+    // Timer1, the count is c0 at t0 and advances every prescale cycles
+    uint64_t t0;
+    uint32_t c0;
+    uint32_t prescale;
+    uint64_t timer_last; // timer events up to here have been processed
+
+    // pwm output tracking
+    bool     pulse_active;
+    SimPulse pulse;
+
+    uint8_t  pin_mode[8];
+    uint8_t  pin_level[8];
+    void   (*pin_change[8])();
+    uint8_t  pin_change_mode[8];
+    uint8_t  pcint_pending;
+
+    void   (*on_receive)(int);
+    void   (*on_request)();
+    std::vector<uint8_t> rx;
+    size_t   rx_pos;
+    std::vector<uint8_t> tx;
+    uint64_t i2c_busy_until;
+    std::vector<std::pair<size_t, std::function<void()> > > usi_queue; // bytes & action for each USI interrupt
+
+    std::multimap<uint64_t, Scheduled> events;
+
+    uint32_t timerCount(uint64_t at);
+    uint32_t timerTop();
+    uint64_t timerNext(uint32_t value, uint64_t after);
+    bool     timerRunning();
+    void     timerRestart(uint32_t count);
+    bool     nextTimerEvent(uint64_t* when, uint8_t* flag);
+    void     setFlag(uint8_t flag);
+    void     updatePulse();
+    uint64_t nextEvent(bool include_timer, int* kind, uint8_t* flag);
+    void     runEvent(int kind, uint8_t flag);
+    bool     pending(SimVector* vector);
+    void     service();
+    void     runISR(SimVector vector);
+    uint64_t i2cDuration(size_t bytes);
+};
+
+extern SimAVR sim;
+
+// AVR side declarations used by the shims
+extern SimReg8 TCCR1;
+extern SimReg8 GTCCR;
+extern SimReg8 TIMSK;
+extern SimReg8 TIFR;
+extern SimReg8 TCNT1;
+extern SimReg8 OCR1A;
+extern SimReg8 OCR1B;
+extern SimReg8 OCR1C;
+extern SimReg8 MCUSR;
+extern SimReg8 ADCSRA;
+extern SimReg8 PRR;
+
+#define ISR(vector) void vector()
+void TIMER1_OVF_vect();
+void TIMER1_COMPA_vect();
+
+#endif /* SIMAVR_H_ */
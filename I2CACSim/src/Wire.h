@@ -0,0 +1,78 @@
+/*
+ * Wire.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WIRE_H_
+#define WIRE_H_
+
+#include "Arduino.h"
+
+//
+// USI TWI slave, transactions come from the simulated master (SimAVR::i2cWrite/i2cRead)
+//
+class TwoWire
+{
+public:
+    void begin(uint8_t address)
+    {
+        (void)address;
+    }
+
+    void onReceive(void (*func)(int))
+    {
+        receive = func;
+        sim.wireBegin(receive, request);
+    }
+
+    void onRequest(void (*func)())
+    {
+        request = func;
+        sim.wireBegin(receive, request);
+    }
+
+    int read()
+    {
+        return sim.wireRead();
+    }
+
+    int available()
+    {
+        return sim.wireAvailable();
+    }
+
+    size_t write(uint8_t value)
+    {
+        return sim.wireWrite(value);
+    }
+
+    bool isActive()
+    {
+        return sim.i2cActive();
+    }
+
+private:
+    void (*receive)(int);
+    void (*request)();
+};
+
+extern TwoWire Wire;
+
+#endif /* WIRE_H_ */
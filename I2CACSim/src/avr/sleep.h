@@ -0,0 +1,36 @@
+/*
+ * sleep.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include "SimAVR.h"
+
+#define SLEEP_MODE_IDLE     SIM_SLEEP_IDLE
+#define SLEEP_MODE_PWR_DOWN SIM_SLEEP_PWR_DOWN
+
+#define set_sleep_mode(mode) sim.sleepMode(mode)
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu()          sim.sleep()
+
+#endif /* SIM_AVR_SLEEP_H_ */
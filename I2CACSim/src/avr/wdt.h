@@ -0,0 +1,35 @@
+/*
+ * wdt.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIM_AVR_WDT_H_
+#define SIM_AVR_WDT_H_
+
+#include "SimAVR.h"
+
+#define WDTO_15MS 0
+
+#define wdt_disable()
+#define wdt_reset()
+// the watchdog resets the chip, the simulator restarts setup()
+#define wdt_enable(timeout) throw SimReboot()
+
+#endif /* SIM_AVR_WDT_H_ */
@@ -26,6 +26,9 @@
 
 volatile uint16_t     position;         // This is the position that we believe the clock is in.
 volatile uint16_t     adjustment;       // This is the adjustment to be made.
+volatile uint16_t     pause;            // ticks left to hold the clock still.
+volatile uint16_t     target;           // position the clock should show at target_ticks.
+volatile uint16_t     target_ticks;     // ticks until target is valid, 0 if none.
 volatile uint8_t      command;          // This is which "register" to be read/written.
 volatile uint8_t      status;           // status register (has tick bit)
 volatile uint8_t      control;          // This is our control "register".
@@ -62,6 +65,15 @@ void i2creceive(int size)
             adjustment = Wire.read() | Wire.read() << 8;
             // adjustment will start on the next tick!
             break;
+        case CMD_PAUSE:
+            pause = Wire.read() | Wire.read() << 8;
+            // pause will start on the next tick!
+            break;
+        case CMD_TARGET:
+            target       = Wire.read() | Wire.read() << 8;
+            target_ticks = Wire.read() | Wire.read() << 8;
+            // correction is planned on tick target_ticks, 1 is the next tick
+            break;
         case CMD_TP_DURATION:
             config.tp_duration = Wire.read();
             break;
@@ -93,6 +105,18 @@ void i2creceive(int size)
         case CMD_RESET:
             (void)Wire.read(); // we ignore as its just a placeholder
             factory_reset = true;
+            break;
+        default:
+            //
+            // config block, like the DS3231 the register pointer auto increments
+            // so any number of config registers can be written in one transaction.
+            //
+            while (size-- > 0 && isConfigRegister(command))
+            {
+                configRegister(command) = Wire.read();
+                ++command;
+            }
+            break;
         }
         command = 0xff;
     }
@@ -117,6 +141,19 @@ void i2crequest()
         Wire.write(value & 0xff);
         Wire.write(value >> 8);
         break;
+    case CMD_PAUSE:
+        value = pause;
+        Wire.write(value & 0xff);
+        Wire.write(value >> 8);
+        break;
+    case CMD_TARGET:
+        value = target;
+        Wire.write(value & 0xff);
+        Wire.write(value >> 8);
+        value = target_ticks;
+        Wire.write(value & 0xff);
+        Wire.write(value >> 8);
+        break;
     case CMD_TP_DURATION:
         value = config.tp_duration;
         Wire.write(value);
@@ -151,6 +188,30 @@ void i2crequest()
     case CMD_VERSION:
         Wire.write(I2C_ANALOG_CLOCK_VERSION);
         break;
+    case CMD_SNAPSHOT:
+    {
+        //
+        // everything the ESP needs when it wakes in one transaction,
+        // we are in the i2c interrupt so position/adjustment can't change
+        // under us while we copy them.
+        //
+        uint8_t snapshot[SNAPSHOT_SIZE] = {
+            ID_VALUE,
+            I2C_ANALOG_CLOCK_VERSION,
+            reset_reason,
+            status,
+            control,
+            (uint8_t)(position & 0xff),
+            (uint8_t)(position >> 8),
+            (uint8_t)(adjustment & 0xff),
+            (uint8_t)(adjustment >> 8),
+        };
+        for (uint8_t i = 0; i < SNAPSHOT_SIZE; ++i)
+        {
+            Wire.write(snapshot[i]);
+        }
+        break;
+    }
 
     case CMD_CONTROL:
         Wire.write(control);
@@ -158,6 +219,13 @@ void i2crequest()
     case CMD_STATUS:
         Wire.write(status);
         break;
+    default:
+        // config block reads return everything from the register pointer to the end of the block
+        for (uint8_t reg = command; isConfigRegister(reg); ++reg)
+        {
+            Wire.write(configRegister(reg));
+        }
+        break;
     }
     command = 0xff;
 }
@@ -387,6 +455,48 @@ void startAdjust()
     }
 }
 
+//
+// called on the tick the target becomes valid, choose the faster of
+// fast forwarding or pausing so the clock shows target.  This tick
+// then runs the plan through the normal adjustment/pause handling.
+//
+void planTarget()
+{
+    if (target >= MAX_SECONDS)
+    {
+        return;
+    }
+
+    // extra steps beyond this tick's normal advance to reach target
+    uint16_t ff_steps = ((uint32_t)target + MAX_SECONDS - position - 1) % MAX_SECONDS;
+    if (ff_steps == 0)
+    {
+        adjustment = 0;
+        pause      = 0;
+        return;
+    }
+
+    // the other way round, hold the clock still until the target catches up
+    uint16_t pause_ticks = MAX_SECONDS - ff_steps;
+
+    //
+    // fast forward runs one step per step_ms but every second a tick is
+    // added, so it takes ff_steps*step_ms*1000/(1000-step_ms) ms against
+    // pause_ticks*1000 ms for pausing.  Compare without the division.
+    //
+    uint16_t step_ms = config.ap_duration + config.ap_delay;
+    if (step_ms < 1000 && (uint32_t)ff_steps * step_ms < (uint32_t)pause_ticks * (1000 - step_ms))
+    {
+        adjustment = ff_steps;
+        pause      = 0;
+    }
+    else
+    {
+        adjustment = 0;
+        pause      = pause_ticks;
+    }
+}
+
 //
 // ISR for 1hz interrupt
 //
@@ -399,7 +509,17 @@ void tick()
     digitalWrite(LED_PIN, !digitalRead(LED_PIN));
 #endif
 
-    if (isEnabled())
+    if (target_ticks != 0 && --target_ticks == 0 && isEnabled())
+    {
+        planTarget();
+    }
+
+    if (isEnabled() && pause != 0)
+    {
+        // hold the clock still for this tick, it falls back by one second
+        --pause;
+    }
+    else if (isEnabled())
     {
         if (adjustment != 0)
         {
@@ -488,6 +608,8 @@ void setup()
     loadConfig();
 
     adjustment      = 0;
+    pause           = 0;
+    target_ticks    = 0;
     adjust_active   = false;
     save_config     = false;
     factory_reset   = false;
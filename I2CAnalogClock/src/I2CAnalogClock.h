@@ -85,6 +85,16 @@
 #define CMD_RESET       0x0d
 #define CMD_RST_REASON  0x0e
 #define CMD_VERSION     0x0f
+#define CMD_SNAPSHOT    0x10 // id, version, reset reason, status, control, position & adjustment
+#define CMD_PAUSE       0x11 // number of ticks to hold the clock still
+#define CMD_TARGET      0x12 // target position & number of ticks until it is valid
+
+#define CMD_CONFIG      0x20 // start of the auto-incrementing config block, one register per Config field
+
+#define SNAPSHOT_SIZE   9    // bytes returned for CMD_SNAPSHOT (must fit the TWI transmit buffer)
+
+#define isConfigRegister(reg) ((reg) >= CMD_CONFIG && (reg) < CMD_CONFIG + sizeof(Config))
+#define configRegister(reg)   (((volatile uint8_t*)&config)[(reg) - CMD_CONFIG])
 
 // control register bits
 #define BIT_ENABLE      0x80
@@ -149,6 +159,9 @@
 #define DEFAULT_AP_DUTY        45  // duty cycle %.
 #define DEFAULT_AP_DELAY_MS    9   // delay between adjust pulses in ms.
 
+//
+// NOTE: the field order is the register order of the CMD_CONFIG block!
+//
 typedef struct config
 {
     volatile uint8_t tp_duration;
@@ -185,6 +198,7 @@ typedef struct ee_power_fail_data
 void startAdjust();
 void adjustClock();
 void advanceClock(uint16_t duration, uint8_t duty);
+void planTarget();
 void tick();
 
 uint32_t calculateCRC32(const uint8_t *data, size_t length);
@@ -44,5 +44,22 @@ void Logger::flush()
     fflush(stdout);
 }
 
+#define DLOG_SHIM(level) \
+void DLogShim::level(const char* tag, const char* fmt, ...) \
+{ \
+    va_list argp; \
+    va_start(argp, fmt); \
+    ::printf("%s: ", tag); \
+    vprintf(fmt, argp); \
+    ::printf("\n"); \
+    va_end(argp); \
+}
+
+DLOG_SHIM(error)
+DLOG_SHIM(warning)
+DLOG_SHIM(info)
+DLOG_SHIM(debug)
+DLOG_SHIM(trace)
 
 Logger logger;
+DLogShim dlog;
@@ -36,6 +36,24 @@ public:
 
 extern Logger logger;
 
+//
+// enough of DLog for the SynchroClock libraries built in here (NTPServer)
+//
+#define PROGMEM
+#define FPSTR(s) (s)
+#define F(s)     (s)
+
+class DLogShim {
+public:
+    void error(const char* tag, const char* fmt, ...);
+    void warning(const char* tag, const char* fmt, ...);
+    void info(const char* tag, const char* fmt, ...);
+    void debug(const char* tag, const char* fmt, ...);
+    void trace(const char* tag, const char* fmt, ...);
+};
+
+extern DLogShim dlog;
+
 #define DEBUG
 #ifdef DEBUG
 #define dbprintf(...)   logger.printf(__VA_ARGS__)
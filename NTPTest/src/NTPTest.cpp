@@ -7,20 +7,27 @@
 //============================================================================
 
 #include "NTP.h"
+#include "NTPServer.h"
+#include "Oscillator.h"
+#include "Stability.h"
 
 #include <sys/time.h>
 #include <unistd.h>
 #include <math.h>
+#include <getopt.h>
 
 #define SPEEDUP_FACTOR 100
 #define MAX_SLEEP      (3600 / SPEEDUP_FACTOR)
 #define PERSIST_FILE   "/tmp/ntp_persist.data"
 
-uint32_t start_time   = 0;
-uint32_t last_time    = 0;
+double start_time     = 0.0;
+double last_time      = 0.0;
 double current_offset = 0.0;
-double fake_drift_ppm = 1.0*SPEEDUP_FACTOR;
 uint32_t sleep_left   = 0;
+Oscillator* oscillator;
+double oscillator_phase = 0.0; // what the oscillator gained, the clock's error without NTP
+StabilityWriter records;
+std::vector<StabilityRecord> trace;
 
 NTPPersist persist;
 
@@ -57,25 +64,35 @@ void savePersist()
     fclose(fp);
 }
 
+//
+// add what the oscillator gained since the last call to the offset, each
+// real second is SPEEDUP_FACTOR seconds for the oscillator.
+//
 void adjustOffsetByDrift()
 {
     struct timeval tp;
     gettimeofday(&tp, NULL);
+    double now = (double)tp.tv_sec + (double)tp.tv_usec / 1000000.;
 
-    if (!start_time)
+    if (start_time == 0.0)
     {
-        start_time = (uint32_t)tp.tv_sec;
+        start_time = now;
     }
 
-    // add fake drift to offset
-    if (last_time)
+    if (last_time != 0.0)
     {
-        double drift = fake_drift_ppm * (((double)tp.tv_sec - (double)last_time) / 1000000.);
-        current_offset += drift;
-        double hours = (double)(tp.tv_sec - start_time) / (3600.0 / SPEEDUP_FACTOR);
-        printf("HOURS: %f applying fake drift: %lfms for %ld seconds current_offset: %f\n", hours, drift, tp.tv_sec - last_time, current_offset);
+        double drift = oscillator->advance((now - last_time) * SPEEDUP_FACTOR);
+        current_offset   += drift;
+        oscillator_phase += drift;
+        double hours = (now - start_time) / (3600.0 / SPEEDUP_FACTOR);
+        printf("HOURS: %f applying drift: %lfs for %f seconds current_offset: %f\n", hours, drift, now - last_time, current_offset);
+        oscillator->print();
     }
-    last_time =  (uint32_t)tp.tv_sec;
+    last_time = now;
+
+    StabilityRecord record = { (now - start_time) * SPEEDUP_FACTOR, oscillator_phase, current_offset, oscillator->getPPM() };
+    records.write(record);
+    trace.push_back(record);
 }
 
 int getTime(uint32_t *result)
@@ -98,24 +115,139 @@ int getTime(uint32_t *result)
     return 0;
 }
 
+//
+// the server mode's clock is the host clock
+//
+int getServerTime(uint32_t *seconds, uint32_t *usec)
+{
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    *seconds = (uint32_t)tp.tv_sec;
+    *usec    = (uint32_t)tp.tv_usec;
+    return 0;
+}
+
+//
+// run SynchroClock's NTPServer on port, as if the host clock was set from
+// a stratum 1 server on this host.
+//
+int serve(int port)
+{
+    NTPServer server(&getServerTime);
+    server.begin(port);
+
+    uint32_t seconds;
+    uint32_t usec;
+    getServerTime(&seconds, &usec);
+    server.setReference(IPAddress(htonl(INADDR_LOOPBACK)), 1, 0.0, 0.0, seconds, usec);
+
+    for (;;)
+    {
+        if (server.handle(1000))
+        {
+            printf("****** SERVER: requests: %u replies: %u\n", server.getRequests(), server.getReplies());
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+void usage(const char* name)
+{
+    printf("usage: %s [-o constant|rtc] [-d ppm] [-a ppm] [-p days] [-r seed] [-w records] [server [port]]\n", name);
+    printf("       %s -s [port]\n", name);
+    printf("  -o  oscillator model (default rtc)\n");
+    printf("  -d  constant model: frequency error (default 1.0ppm)\n");
+    printf("  -a  rtc model: aging per year (default %0.2fppm)\n", RTCOscillatorConfig(RTC_OSCILLATOR_DEFAULTS).aging);
+    printf("  -p  rtc model: mean days between power cycles, 0 for none (default %0.0f)\n",
+            RTCOscillatorConfig(RTC_OSCILLATOR_DEFAULTS).power_cycle_days);
+    printf("  -r  rtc model: random seed\n");
+    printf("  -w  write a record of the clock each loop (.bin for binary, CSV otherwise)\n");
+    printf("  -s  answer NTP requests on port with NTPServer instead\n");
+}
+
+//
+//   NTPTest [options] [server [port]]   poll server (at port) with the NTP class
+//   NTPTest -s [port]                   answer NTP requests on port with NTPServer
+//
 int main(int argc, char**argv)
 {
     const char *server = "192.168.0.31";
-    printf("argc: %d\n", argc);
-    if (argc > 1)
+    int port = NTP_PORT;
+    bool serving = false;
+    const char* model = "rtc";
+    double ppm = 1.0;
+    RTCOscillatorConfig rtc = RTC_OSCILLATOR_DEFAULTS;
+    int opt;
+    const char* output = NULL;
+    while ((opt = getopt(argc, argv, "o:d:a:p:r:w:sh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o': model = optarg; break;
+        case 'd': ppm = atof(optarg); break;
+        case 'a': rtc.aging = atof(optarg); break;
+        case 'p': rtc.power_cycle_days = atof(optarg); break;
+        case 'r': rtc.seed = strtoul(optarg, NULL, 0); break;
+        case 'w': output = optarg; break;
+        case 's': serving = true; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (serving)
+    {
+        return serve(optind < argc ? atoi(argv[optind]) : NTP_PORT);
+    }
+    if (optind < argc)
+    {
+        server = argv[optind];
+    }
+    if (optind + 1 < argc)
+    {
+        port = atoi(argv[optind + 1]);
+    }
+
+    if (!strcmp(model, "constant"))
+    {
+        oscillator = new ConstantOscillator(ppm);
+    }
+    else if (!strcmp(model, "rtc"))
+    {
+        oscillator = new RTCOscillator(rtc);
+    }
+    else
     {
-        server = argv[1];
+        usage(argv[0]);
+        return 1;
     }
+    oscillator->print();
+
+    if (output != NULL && records.open(output))
+    {
+        return 1;
+    }
+
     NTPRunTime runtime;
     memset(&persist, 0, sizeof(persist));
     memset(&runtime, 0, sizeof(runtime));
     loadPersist();
     NTP test(&runtime, &persist, &savePersist, SPEEDUP_FACTOR);
-    test.begin();
+    test.begin(port);
     for (int i = 0; i < 1000; ++i)
     {
         adjustOffsetByDrift();
 
+        // a power cycle loses the RTC memory with the runtime data
+        if (oscillator->powerCycled())
+        {
+            printf("****** POWER CYCLE\n");
+            memset(&runtime, 0, sizeof(runtime));
+            test.begin(port);
+            sleep_left = 0;
+        }
+
         double offset = 0.0;
         int err = test.getOffsetUsingDrift(&offset, &getTime);
         if (!err)
@@ -149,6 +281,18 @@ int main(int argc, char**argv)
         sleep(interval);
     }
 
+    // how the free running oscillator did, what the poll interval is up against
+    std::vector<double> phase;
+    double tau0 = Stability::spacing(trace);
+    if (!Stability::resample(trace, tau0, phase))
+    {
+        std::vector<StabilityPoint> points;
+        Stability::analyze(phase, tau0, 0, points);
+        Stability::print(stdout, points);
+    }
+    records.close();
+
+    delete oscillator;
     printf("Done!\n");
 	return 0;
 }
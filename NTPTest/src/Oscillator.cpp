@@ -0,0 +1,143 @@
+/*
+ * Oscillator.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Oscillator.h"
+#include <math.h>
+#include <stdio.h>
+
+#define SECONDS_PER_DAY  86400.0
+#define DAYS_PER_YEAR    365.25
+
+ConstantOscillator::ConstantOscillator(double ppm)
+{
+    _ppm = ppm;
+}
+
+double ConstantOscillator::advance(double seconds)
+{
+    return _ppm * seconds / 1000000.0;
+}
+
+double ConstantOscillator::getPPM()
+{
+    return _ppm;
+}
+
+void ConstantOscillator::print()
+{
+    printf("OSCILLATOR: constant %0.3fppm\n", _ppm);
+}
+
+RTCOscillator::RTCOscillator(const RTCOscillatorConfig& config) : _config(config), _random(config.seed)
+{
+    _t            = 0.0;
+    _next         = 0.0;
+    _temperature  = 0.0;
+    _tcxo         = 0.0;
+    _walk         = 0.0;
+    _retrace      = 0.0;
+    _power_cycles = 0;
+    _power_cycled = false;
+    convert();
+}
+
+//
+// frequency error of the compensated crystal at a temperature: the curve
+// compensation leaves plus the error of rounding the correction to a step.
+//
+double RTCOscillator::tcxo(double temperature)
+{
+    double dt       = temperature - RTC_TCXO_T0;
+    double crystal  = RTC_TCXO_CRYSTAL * dt * dt;
+    double residual = RTC_TCXO_RESIDUAL2 * dt * dt + RTC_TCXO_RESIDUAL3 * dt * dt * dt;
+    return residual + crystal - RTC_TCXO_STEP * round(crystal / RTC_TCXO_STEP);
+}
+
+double RTCOscillator::temperature(double t)
+{
+    double day  = _config.start_day + t / SECONDS_PER_DAY;
+    double hour = fmod(t / 3600.0, 24.0);
+    return _config.temp_mean
+         + _config.temp_season * cos(2.0 * M_PI * (day - _config.temp_season_peak) / DAYS_PER_YEAR)
+         + _config.temp_daily * cos(2.0 * M_PI * (hour - _config.temp_daily_peak) / 24.0);
+}
+
+void RTCOscillator::convert()
+{
+    _temperature = temperature(_t);
+    _tcxo        = tcxo(_temperature);
+    _next        = _t + RTC_TCXO_INTERVAL;
+}
+
+double RTCOscillator::getPPM()
+{
+    return _tcxo + _config.aging * _t / (SECONDS_PER_DAY * DAYS_PER_YEAR) + _walk + _retrace;
+}
+
+//
+// step from conversion to conversion, the frequency holds between them
+// except for the noise.
+//
+double RTCOscillator::advance(double seconds)
+{
+    double gained = 0.0;
+    while (seconds > 0.0)
+    {
+        double step = fmin(seconds, _next - _t);
+
+        // aging is linear, use its value in the middle of the step
+        double ppm = getPPM() + _config.aging * step / 2.0 / (SECONDS_PER_DAY * DAYS_PER_YEAR);
+        gained += ppm * step / 1000000.0;
+        gained += _config.white * sqrt(step) * _normal(_random) / 1000000.0;
+        _walk  += _config.random_walk * sqrt(step / SECONDS_PER_DAY) * _normal(_random);
+
+        if (_config.power_cycle_days > 0.0
+            && std::uniform_real_distribution<double>(0.0, 1.0)(_random) < step / (_config.power_cycle_days * SECONDS_PER_DAY))
+        {
+            _retrace += _config.retrace * _normal(_random);
+            ++_power_cycles;
+            _power_cycled = true;
+        }
+
+        _t      += step;
+        seconds -= step;
+        if (_t >= _next)
+        {
+            convert();
+        }
+    }
+    return gained;
+}
+
+bool RTCOscillator::powerCycled()
+{
+    bool cycled = _power_cycled;
+    _power_cycled = false;
+    return cycled;
+}
+
+void RTCOscillator::print()
+{
+    printf("OSCILLATOR: day: %0.3f temperature: %0.2fC ppm: %0.4f (tcxo: %0.4f aging: %0.4f walk: %0.4f retrace: %0.4f) power cycles: %u\n",
+            _t / SECONDS_PER_DAY, _temperature, getPPM(), _tcxo,
+            _config.aging * _t / (SECONDS_PER_DAY * DAYS_PER_YEAR), _walk, _retrace, _power_cycles);
+}
@@ -0,0 +1,122 @@
+/*
+ * Oscillator.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef OSCILLATOR_H_
+#define OSCILLATOR_H_
+
+#include <stdint.h>
+#include <random>
+
+//
+// The clock's oscillator for NTPTest: how far ahead of true time it gets
+// over an interval.  Times are simulated seconds, positive ppm is fast.
+//
+class Oscillator
+{
+public:
+    virtual ~Oscillator() {}
+    // run for seconds, returns the time gained (seconds)
+    virtual double advance(double seconds) = 0;
+    // frequency error now (ppm)
+    virtual double getPPM() = 0;
+    // true once for each power cycle since the last call
+    virtual bool   powerCycled() { return false; }
+    virtual void   print() = 0;
+};
+
+//
+// what NTPTest always did, a fixed frequency error
+//
+class ConstantOscillator : public Oscillator
+{
+public:
+    ConstantOscillator(double ppm);
+    double advance(double seconds);
+    double getPPM();
+    void   print();
+private:
+    double _ppm;
+};
+
+//
+// DS3231 model parameters, see RTCOscillator
+//
+typedef struct rtc_oscillator_config
+{
+    double   temp_mean;        // C
+    double   temp_season;      // C, amplitude of the yearly cycle
+    int      temp_season_peak; // day of the year it is warmest
+    double   temp_daily;       // C, amplitude of the daily cycle
+    int      temp_daily_peak;  // hour of the day it is warmest
+    int      start_day;        // day of the year the test starts
+    double   aging;            // ppm per year
+    double   white;            // white FM, Allan deviation at 1s (ppm)
+    double   random_walk;      // random walk FM, ppm per sqrt(day)
+    double   power_cycle_days; // mean days between power cycles, 0 for none
+    double   retrace;          // ppm, standard deviation of the jump after a power cycle
+    uint32_t seed;
+} RTCOscillatorConfig;
+
+#define RTC_OSCILLATOR_DEFAULTS { 21.0, 3.0, 200, 2.0, 16, 0, 1.0, 0.01, 0.02, 30.0, 0.1, 1 }
+
+#define RTC_TCXO_INTERVAL   64.0     // seconds between temperature conversions
+#define RTC_TCXO_T0         25.0     // C, turnover temperature of the crystal
+#define RTC_TCXO_CRYSTAL    -0.034   // ppm/C^2, the uncompensated tuning fork curve
+#define RTC_TCXO_STEP       0.12     // ppm, compensation is applied in steps of this
+#define RTC_TCXO_RESIDUAL2  -0.0015  // ppm/C^2, what compensation leaves of the curve
+#define RTC_TCXO_RESIDUAL3  0.00003  // ppm/C^3
+
+//
+// A DS3231: a crystal compensated from a temperature conversion every 64s.
+// The frequency is the compensation's residual curve and step at the
+// temperature of a daily and yearly profile, plus linear aging, white and
+// random walk frequency noise and a random retrace jump at each power
+// cycle (the RTC keeps time through them on its battery).
+//
+class RTCOscillator : public Oscillator
+{
+public:
+    RTCOscillator(const RTCOscillatorConfig& config);
+    double advance(double seconds);
+    double getPPM();
+    bool   powerCycled();
+    void   print();
+
+    static double tcxo(double temperature);
+private:
+    double temperature(double t);
+    void   convert();
+
+    RTCOscillatorConfig _config;
+    std::mt19937        _random;
+    std::normal_distribution<double> _normal;
+    double   _t;           // seconds since the start
+    double   _next;        // time of the next temperature conversion
+    double   _temperature; // at the last conversion
+    double   _tcxo;        // ppm, from the last conversion
+    double   _walk;        // ppm, random walk so far
+    double   _retrace;     // ppm, from power cycles so far
+    uint32_t _power_cycles;
+    bool     _power_cycled;
+};
+
+#endif /* OSCILLATOR_H_ */
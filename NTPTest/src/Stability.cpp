@@ -0,0 +1,374 @@
+/*
+ * Stability.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Stability.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+StabilityWriter::StabilityWriter()
+{
+    _fp     = NULL;
+    _binary = false;
+}
+
+StabilityWriter::~StabilityWriter()
+{
+    close();
+}
+
+int StabilityWriter::open(const char* path)
+{
+    size_t length = strlen(path);
+    _binary = length > 4 && !strcmp(path + length - 4, ".bin");
+    _fp     = fopen(path, _binary ? "wb" : "w");
+    if (_fp == NULL)
+    {
+        printf("StabilityWriter::open: failed to open '%s'!\n", path);
+        return -1;
+    }
+
+    if (_binary)
+    {
+        uint32_t header[2] = { STABILITY_MAGIC, STABILITY_VERSION };
+        fwrite(header, sizeof(header), 1, _fp);
+    }
+    else
+    {
+        fprintf(_fp, "%s\n", STABILITY_CSV);
+    }
+    return 0;
+}
+
+//
+// flushed as it goes so a run can be analyzed while it is still going
+//
+int StabilityWriter::write(const StabilityRecord& record)
+{
+    if (_fp == NULL)
+    {
+        return -1;
+    }
+
+    int ok;
+    if (_binary)
+    {
+        ok = fwrite(&record, sizeof(record), 1, _fp) == 1;
+    }
+    else
+    {
+        ok = fprintf(_fp, "%.3f,%.12g,%.12g,%.6g\n", record.time, record.phase, record.offset, record.drift) > 0;
+    }
+    fflush(_fp);
+    return ok ? 0 : -1;
+}
+
+void StabilityWriter::close()
+{
+    if (_fp != NULL)
+    {
+        fclose(_fp);
+        _fp = NULL;
+    }
+}
+
+//
+// CSV fields that are empty or "nan" are unknown
+//
+static double field(const char** p)
+{
+    char*  end;
+    double value = strtod(*p, &end);
+    if (end == *p)
+    {
+        value = NAN;
+    }
+    *p = strchr(end, ',');
+    *p = *p ? *p + 1 : end + strlen(end);
+    return value;
+}
+
+int Stability::read(const char* path, std::vector<StabilityRecord>& records)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        printf("Stability::read: failed to open '%s'!\n", path);
+        return -1;
+    }
+
+    uint32_t header[2];
+    if (fread(header, sizeof(header), 1, fp) == 1 && header[0] == STABILITY_MAGIC)
+    {
+        if (header[1] != STABILITY_VERSION)
+        {
+            printf("Stability::read: '%s' is version %u not %u!\n", path, header[1], STABILITY_VERSION);
+            fclose(fp);
+            return -1;
+        }
+        StabilityRecord chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, sizeof(chunk[0]), sizeof(chunk) / sizeof(chunk[0]), fp)) > 0)
+        {
+            records.insert(records.end(), chunk, chunk + n);
+        }
+        fclose(fp);
+        return 0;
+    }
+
+    rewind(fp);
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (!strncmp(line, STABILITY_CSV, strlen(STABILITY_CSV)))
+        {
+            continue;
+        }
+        const char* p = line;
+        StabilityRecord record;
+        record.time   = field(&p);
+        record.phase  = field(&p);
+        record.offset = field(&p);
+        record.drift  = field(&p);
+        if (!isnan(record.time))
+        {
+            records.push_back(record);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static bool usable(const StabilityRecord& record, bool phase)
+{
+    return phase ? !isnan(record.phase) : !isnan(record.drift);
+}
+
+static bool hasPhase(const std::vector<StabilityRecord>& records)
+{
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (!isnan(records[i].phase))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+double Stability::spacing(const std::vector<StabilityRecord>& records)
+{
+    bool phase = hasPhase(records);
+    std::vector<double> gaps;
+    double last = NAN;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (!usable(records[i], phase))
+        {
+            continue;
+        }
+        if (!isnan(last) && records[i].time > last)
+        {
+            gaps.push_back(records[i].time - last);
+        }
+        last = records[i].time;
+    }
+    if (gaps.empty())
+    {
+        return 0.0;
+    }
+    std::nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+    return gaps[gaps.size() / 2];
+}
+
+//
+// traces from the field come at the poll interval, not evenly, so the
+// phase is interpolated to an even tau0.  A trace with only drift (ppm)
+// is integrated to phase first.
+//
+int Stability::resample(const std::vector<StabilityRecord>& records, double tau0, std::vector<double>& phase)
+{
+    bool have_phase = hasPhase(records);
+    std::vector<std::pair<double, double> > points; // time, phase
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const StabilityRecord& r = records[i];
+        if (!usable(r, have_phase))
+        {
+            continue;
+        }
+        if (!points.empty() && r.time <= points.back().first)
+        {
+            continue; // out of order or duplicate
+        }
+        double value = r.phase;
+        if (!have_phase)
+        {
+            value = points.empty() ? 0.0 : points.back().second + records[i].drift * (r.time - points.back().first) / 1000000.0;
+        }
+        points.push_back(std::make_pair(r.time, value));
+    }
+
+    phase.clear();
+    if (points.size() < 2 || tau0 <= 0.0)
+    {
+        return -1;
+    }
+
+    size_t j     = 0;
+    size_t count = (size_t)((points.back().first - points.front().first) / tau0) + 1;
+    for (size_t k = 0; k < count; ++k)
+    {
+        double t = points.front().first + k * tau0;
+        while (points[j + 1].first < t)
+        {
+            ++j;
+        }
+        double span = points[j + 1].first - points[j].first;
+        double f    = (t - points[j].first) / span;
+        phase.push_back(points[j].second + f * (points[j + 1].second - points[j].second));
+    }
+    return 0;
+}
+
+//
+// overlapping Allan deviation and MTIE at m * tau0, both one pass over x
+//
+StabilityPoint Stability::point(const std::vector<double>& x, size_t m, double tau0)
+{
+    StabilityPoint p;
+    p.tau = m * tau0;
+
+    size_t n   = x.size() - 2 * m;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        double d = x[i + 2 * m] - 2.0 * x[i + m] + x[i];
+        sum += d * d;
+    }
+    p.adev = sqrt(sum / (2.0 * n * p.tau * p.tau));
+    p.n    = n;
+
+    // the largest peak to peak phase in any window of m + 1 samples,
+    // sliding window max & min kept in monotonic deques
+    std::deque<size_t> hi;
+    std::deque<size_t> lo;
+    double mtie = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        while (!hi.empty() && x[hi.back()] <= x[i])
+        {
+            hi.pop_back();
+        }
+        hi.push_back(i);
+        while (!lo.empty() && x[lo.back()] >= x[i])
+        {
+            lo.pop_back();
+        }
+        lo.push_back(i);
+        if (hi.front() + m < i)
+        {
+            hi.pop_front();
+        }
+        if (lo.front() + m < i)
+        {
+            lo.pop_front();
+        }
+        if (i >= m)
+        {
+            mtie = std::max(mtie, x[hi.front()] - x[lo.front()]);
+        }
+    }
+    p.mtie = mtie;
+    return p;
+}
+
+//
+// every tau is a pass over the whole trace, threads take the next tau
+// until there are none left.
+//
+void Stability::analyze(const std::vector<double>& phase, double tau0, unsigned threads, std::vector<StabilityPoint>& points)
+{
+    std::vector<size_t> ms;
+    for (size_t m = 1; 2 * m < phase.size(); m *= 2)
+    {
+        ms.push_back(m);
+    }
+    points.resize(ms.size());
+
+    std::atomic<size_t> next(0);
+    auto work = [&]()
+    {
+        size_t i;
+        while ((i = next++) < ms.size())
+        {
+            points[i] = point(phase, ms[i], tau0);
+        }
+    };
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads && t < ms.size(); ++t)
+    {
+        pool.push_back(std::thread(work));
+    }
+    work();
+    for (size_t t = 0; t < pool.size(); ++t)
+    {
+        pool[t].join();
+    }
+}
+
+//
+// between polls the clock runs on its drift corrected prediction, which
+// is off by about tau * adev(tau) after tau.
+//
+double Stability::maxInterval(const std::vector<StabilityPoint>& points, double budget)
+{
+    double best = 0.0;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        if (points[i].tau * points[i].adev > budget)
+        {
+            break;
+        }
+        best = points[i].tau;
+    }
+    return best;
+}
+
+void Stability::print(FILE* fp, const std::vector<StabilityPoint>& points)
+{
+    fprintf(fp, "%14s %12s %12s %12s %10s\n", "tau(s)", "adev", "tau*adev(s)", "mtie(s)", "n");
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const StabilityPoint& p = points[i];
+        fprintf(fp, "%14.1f %12.4e %12.4e %12.4e %10llu\n", p.tau, p.adev, p.tau * p.adev, p.mtie, (unsigned long long)p.n);
+    }
+}
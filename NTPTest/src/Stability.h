@@ -0,0 +1,91 @@
+/*
+ * Stability.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef STABILITY_H_
+#define STABILITY_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+//
+// One sample of a clock trace.  Phase is how far the free running
+// oscillator is ahead of true time, with the clock's corrections taken
+// out, it is what the stability is computed from.  Unknown values are NAN.
+//
+typedef struct stability_record
+{
+    double time;   // seconds
+    double phase;  // seconds, free running oscillator
+    double offset; // seconds, the measured (or true) offset of the disciplined clock
+    double drift;  // ppm
+} StabilityRecord;
+
+typedef struct stability_point
+{
+    double   tau;  // seconds
+    double   adev; // overlapping Allan deviation
+    double   mtie; // seconds, maximum time interval error
+    uint64_t n;    // terms in the Allan deviation sum
+} StabilityPoint;
+
+//
+// records are written as CSV, or binary when the file name ends in .bin:
+// STABILITY_MAGIC, STABILITY_VERSION then the records as 4 doubles each,
+// all in host byte order.
+//
+#define STABILITY_MAGIC   0x42415453 // "STAB"
+#define STABILITY_VERSION 1
+#define STABILITY_CSV     "time,phase,offset,drift"
+
+class StabilityWriter
+{
+public:
+    StabilityWriter();
+    ~StabilityWriter();
+    int  open(const char* path);
+    int  write(const StabilityRecord& record);
+    void close();
+private:
+    FILE* _fp;
+    bool  _binary;
+};
+
+class Stability
+{
+public:
+    // read a CSV or binary record file
+    static int    read(const char* path, std::vector<StabilityRecord>& records);
+    // median time between samples with a known phase (or drift)
+    static double spacing(const std::vector<StabilityRecord>& records);
+    // phase every tau0 seconds, interpolated, integrated from drift if there is no phase
+    static int    resample(const std::vector<StabilityRecord>& records, double tau0, std::vector<double>& phase);
+    // overlapping Allan deviation & MTIE at octave taus, spread across threads (0 for one per core)
+    static void   analyze(const std::vector<double>& phase, double tau0, unsigned threads, std::vector<StabilityPoint>& points);
+    // longest tau whose drift corrected time error (tau * adev) stays within budget, 0 if none
+    static double maxInterval(const std::vector<StabilityPoint>& points, double budget);
+    static void   print(FILE* fp, const std::vector<StabilityPoint>& points);
+private:
+    static StabilityPoint point(const std::vector<double>& x, size_t m, double tau0);
+};
+
+#endif /* STABILITY_H_ */
@@ -101,6 +101,79 @@ int UDPWrapper::recv(void* buffer, size_t size, unsigned int timeout_ms)
     return n;
 }
 
+//
+// bind a socket to the local port for recvFrom()
+//
+int UDPWrapper::listen()
+{
+    struct sockaddr_in addr;
+
+    _sockfd = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    if ( _sockfd < 0 )
+    {
+        dbprintln("socket() failed!");
+        return -1;
+    }
+
+    bzero( ( char* ) &addr, sizeof( addr ) );
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(_local_port);
+
+    if ( bind( _sockfd, ( struct sockaddr * ) &addr, sizeof( addr ) ) < 0 )
+    {
+        dbprintf("bind() port %d failed: %s\n", _local_port, strerror(errno));
+        ::close(_sockfd);
+        _sockfd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+int UDPWrapper::recvFrom(void* buffer, size_t size, IPAddress* address, uint16_t* port, unsigned int timeout_ms)
+{
+    struct pollfd      fd;
+    struct sockaddr_in from;
+    socklen_t          from_size = sizeof(from);
+
+    if (_sockfd == -1 && listen())
+    {
+        return -1;
+    }
+
+    fd.fd = _sockfd;
+    fd.events = POLLIN;
+    if (::poll(&fd, 1, timeout_ms) <= 0)
+    {
+        return 0;
+    }
+
+    int n = ::recvfrom(_sockfd, buffer, size, 0, ( struct sockaddr * ) &from, &from_size);
+    if (n > 0)
+    {
+        *address = from.sin_addr.s_addr;
+        *port    = ntohs(from.sin_port);
+    }
+    return n;
+}
+
+int UDPWrapper::sendTo(IPAddress address, uint16_t port, void* buffer, size_t size)
+{
+    struct sockaddr_in to;
+
+    bzero( ( char* ) &to, sizeof( to ) );
+    to.sin_family      = AF_INET;
+    to.sin_addr.s_addr = address;
+    to.sin_port        = htons(port);
+
+    int n = ::sendto(_sockfd, buffer, size, 0, ( struct sockaddr * ) &to, sizeof( to ));
+    if ( n < 0 )
+    {
+        dbprintf("sendto failed: %s\n", strerror(errno));
+    }
+    return n;
+}
+
 int UDPWrapper::close()
 {
     if (_sockfd != -1)
@@ -0,0 +1,184 @@
+/*
+ * StabilityTool.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// Allan deviation & MTIE of a clock trace, to pick poll bounds like
+// NTP_MAX_INTERVAL from how the RTC really wanders:
+//
+//   stability [-t tau0] [-b budget] [-j threads] [-w records] trace...
+//
+// A trace is a record file from NTPTest -w (CSV or .bin) or a clock's
+// syslog.  From the log the free running phase is the measured NTP offsets
+// with the corrections the clock made since taken out.  /metrics dumps are
+// not a source, the synchroclock_ntp_drift_ppm gauge is the NTP filter's
+// smoothed drift estimate so it would give the stability of the estimator,
+// not of the RTC.  One clock per run.  -w saves what was read as records.
+//
+#include "../src/Stability.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NTP_UNIX_OFFSET 2208988800.0 // 1900 to 1970
+#define DEFAULT_BUDGET  0.02         // seconds, NTP_OFFSET_THRESHOLD
+
+static bool isRecordFile(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    char head[sizeof(STABILITY_CSV)] = { 0 };
+    size_t n = fread(head, 1, sizeof(head) - 1, fp);
+    fclose(fp);
+    uint32_t magic;
+    memcpy(&magic, head, sizeof(magic));
+    return (n >= sizeof(magic) && magic == STABILITY_MAGIC) || !strncmp(head, STABILITY_CSV, strlen(STABILITY_CSV));
+}
+
+//
+// NTP's "::makeRequest: offset: O delay: D timestamp: T" is a sample of
+// the RTC against the server, setRTCfromOffset's "offset: O ... sync: true"
+// is a correction applied to the RTC (NTP and drift).
+//
+static int readLog(const char* path, std::vector<StabilityRecord>& records)
+{
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        printf("failed to open '%s'!\n", path);
+        return -1;
+    }
+
+    double corrected = 0.0;
+    char   line[512];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        const char* p;
+        double      offset;
+        double      delay;
+        unsigned    timestamp;
+        char        sync[8];
+
+        if ((p = strstr(line, "makeRequest: offset: ")) != NULL
+            && sscanf(p, "makeRequest: offset: %lf delay: %lf timestamp: %u", &offset, &delay, &timestamp) == 3)
+        {
+            StabilityRecord r;
+            r.time   = timestamp - NTP_UNIX_OFFSET;
+            r.phase  = -offset - corrected;
+            r.offset = offset;
+            r.drift  = NAN;
+            records.push_back(r);
+        }
+        else if ((p = strstr(line, "setRTCfromOffset")) != NULL && (p = strstr(p, "offset: ")) != NULL
+            && sscanf(p, "offset: %lf now: %*u.%*u at: %*u.%*u sync: %7s", &offset, sync) == 2)
+        {
+            if (!strcmp(sync, "true"))
+            {
+                corrected += offset;
+            }
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static void usage(const char* name)
+{
+    printf("usage: %s [-t tau0] [-b budget] [-j threads] [-w records] trace...\n", name);
+    printf("  -t  seconds between resampled phase points (default median sample spacing)\n");
+    printf("  -b  time error budget for the poll interval (default %0.3fs)\n", DEFAULT_BUDGET);
+    printf("  -j  threads (default one per core)\n");
+    printf("  -w  save the samples read as records (.bin for binary, CSV otherwise)\n");
+}
+
+int main(int argc, char** argv)
+{
+    double      tau0    = 0.0;
+    double      budget  = DEFAULT_BUDGET;
+    unsigned    threads = 0;
+    const char* output  = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:j:w:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 't': tau0 = atof(optarg); break;
+        case 'b': budget = atof(optarg); break;
+        case 'j': threads = atoi(optarg); break;
+        case 'w': output = optarg; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<StabilityRecord> records;
+    for (int i = optind; i < argc; ++i)
+    {
+        int err = isRecordFile(argv[i]) ? Stability::read(argv[i], records) : readLog(argv[i], records);
+        if (err)
+        {
+            return 1;
+        }
+    }
+    printf("samples: %zu\n", records.size());
+
+    if (output != NULL)
+    {
+        StabilityWriter writer;
+        if (writer.open(output))
+        {
+            return 1;
+        }
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            writer.write(records[i]);
+        }
+        writer.close();
+    }
+
+    if (tau0 <= 0.0)
+    {
+        tau0 = Stability::spacing(records);
+    }
+    std::vector<double> phase;
+    if (Stability::resample(records, tau0, phase))
+    {
+        printf("not enough samples with a phase or drift!\n");
+        return 1;
+    }
+    printf("tau0: %0.3fs points: %zu span: %0.1f days\n", tau0, phase.size(), tau0 * (phase.size() - 1) / 86400.0);
+
+    std::vector<StabilityPoint> points;
+    Stability::analyze(phase, tau0, threads, points);
+    Stability::print(stdout, points);
+    printf("longest poll interval within %0.3fs: %0.0fs\n", budget, Stability::maxInterval(points, budget));
+    return 0;
+}
@@ -32,14 +32,23 @@
 #include <EEPROM.h>
 #include "FeedbackLED.h"
 #include "NTP.h"
+#include "NTPServer.h"
 #include "Clock.h"
 #include "DS3231.h"
 #include "WireUtils.h"
 #include "TimeUtils.h"
+#include "TZData.h"
+#include "TimeBase.h"
 #include "ConfigParam.h"
+#include "Metrics.h"
+#include "Json.h"
+#include "DeltaOTA.h"
+#include "CpuGovernor.h"
+#include "Wait.h"
+#include "NetWake.h"
 #include "Logger.h"
 #include "DLogPrintWriter.h"
-#include "DLogSyslogWriter.h"
+#include "SyslogBuffer.h"
 #include "SynchroClockPins.h"
 #include <memory>
 #include <vector>
@@ -51,13 +60,25 @@
 #define STOP_THE_CLOCK_EXTRA   2      // extra seconds to leave the clock stopped
 
 #define DEFAULT_TZ_OFFSET      0      // default timzezone offset in seconds
+#ifndef DEFAULT_TZ_NAME
+#define DEFAULT_TZ_NAME        ""     // default time zone, empty to use the time changes
+#endif
 #ifndef DEFAULT_NTP_SERVER
 #define DEFAULT_NTP_SERVER     "0.zoddotcom.pool.ntp.org"
 #endif
 #define DEFAULT_SLEEP_DURATION 28800  // default is 8hrs when we are not using the poll estimate
 
 #define CLOCK_STRETCH_LIMIT    100000 // i2c clock stretch timeout in microseconds
-#define MAX_SLEEP_DURATION     3600   // we do multiple sleep of this to handle bigger sleeps
+#define CLOCK_CONFIG_RETRIES   3      // attempts to read the clock pulse config for the config portal
+#define MAX_SLEEP_DURATION     3600   // sleep this long before retrying a failed wifi connection
+#define SLEEP_CAL_MIN_MS       600000 // shorter sleeps are too short to measure with the RTC's whole seconds
+#define SLEEP_CAL_LIMIT        0.2    // ignore a measured sleep more than 20% off, it was cut short or the RTC was lost
+#define SLEEP_CAL_WEIGHT       4      // a measurement moves the calibration a quarter of the way to it
+#define DST_STAGE_WINDOW       600    // seconds, a wake this close to a time change stages it on the controller
+#define DST_WAKE_LEAD          120    // seconds, sleeps are cut short to wake this long before a time change
+#define NTP_SERVE_ANCHOR_AGE   10000000 // us, the NTP server re-anchors the timebase to an RTC edge this often
+#define NTP_SERVE_EDGE_LEAD    5      // ms, it starts waiting for that edge this long before it is due
+#define RTC_WRITE_MARGIN       0.005  // seconds, minimum lead time when scheduling an RTC write
 #define CONNECTION_TIMEOUT     30     // wifi connection timeout - we will deep sleep and try again later
 #define CONFIG_DELAY           1000   // how long to hold the button for config mode - light comes on after this time.
 #define FACTORY_RESET_DELAY    10000  // how long to hold the button for factory reset after LED is ON - 10 seconds (10,000 milliseconds)
@@ -143,6 +164,8 @@ typedef struct config
     char       ntp_server[64];           // host to use for ntp
     char       syslog_host[64];          // host for network logging
     NTPPersist ntp_persist;              // ntp persisted data
+    // new members go here, at the end, so loadConfig() can upgrade configs saved before them
+    char       tz_name[32];              // time zone from TZData, used instead of tc if set
 } Config;
 
 typedef struct ee_config
@@ -156,6 +179,14 @@ typedef struct deep_sleep_data
     uint32_t sleep_delay_left;          // number seconds still to sleep
     NTPRunTime ntp_runtime;             // NTP runtime data
     bool run_update;                    // do update if true
+    uint32_t tz_change;                 // UTC time of the next time change, 0 if there is none
+    int tz_offset;                      // offset in effect until tz_change
+    uint32_t tz_crc;                    // crc of the time zone or time change rules tz_change was computed from
+    MetricsData metrics;                // counters for /metrics
+    uint32_t sleep_until;               // RTC time the current sleep ends, 0 if not known
+    uint32_t sleep_start;               // RTC time we last went into deep sleep, 0 if not known
+    uint32_t sleep_timer_ms;            // what the deep sleep timer was asked for
+    float sleep_cal;                    // RTC seconds per deep sleep timer second, 0 until measured
 } DeepSleepData;
 
 typedef struct rtc_deep_sleep_data
@@ -164,10 +195,13 @@ typedef struct rtc_deep_sleep_data
     uint8_t data[sizeof(DeepSleepData)];
 } RTCDeepSleepData;
 
+static_assert(sizeof(RTCDeepSleepData) <= 512, "RTCDeepSleepData must fit in the 512 bytes of RTC user memory");
+
 typedef std::shared_ptr<ConfigParam> ConfigParamPtr;
 
 boolean parseBoolean(const char* value);
 uint8_t parseDuty(const char* value);
+ConfigParamPtr createClockParam(WiFiManager& wifi, const char* id, const char* placeholder, uint8_t value, int length, void (*applyCB)(const char* result));
 int getValidOffset(String name);
 uint16_t getValidPosition(String name);
 uint8_t getValidDuration(String name);
@@ -187,19 +221,36 @@ void handleEnable();
 void handleRTC();
 void handleNTP();
 void handleSave();
+void handleConfig();
+void handleConfigPost();
+void handleMetrics();
+#ifdef LOG_BINARY
+void handleLog();
+#endif
 void sleepFor(uint32_t sleep_duration);
-int getEdgeSyncedTime(DS3231DateTime& dt, unsigned int retries);
+uint32_t getPollInterval();
+uint32_t serveNTP();
+int getEdgeSyncedTime(DS3231DateTime& dt, uint32_t* edge_us, unsigned int retries);
 int setRTCfromOffset(double offset_ms, bool sync);
-int getTime(uint32_t *result);
+int syncTimeBase();
+int getTime(uint32_t *seconds, uint32_t *usec);
+int getTimeNoSync(uint32_t *seconds, uint32_t *usec);
 int setRTCfromDrift();
+void calibrateSleep();
 int setRTCfromNTP(const char* server, bool sync, double* result_offset, IPAddress* result_address);
 int setCLKfromRTC();
+bool updateTZOffset();
+int computeTZOffset(uint32_t when, int offset, time_t* next_change);
+void stageTimeChange();
 void saveConfig();
 boolean loadConfig();
 void eraseConfig();
 boolean readDeepSleepData();
 boolean writeDeepSleepData();
+uint32_t calculateCRC32(const uint8_t *data, size_t length);
 
+#if defined(ARDUINO_ARCH_ESP8266)
 extern unsigned int snprintf(char*, unsigned int, ...); // because esp8266 does not declare it in a header.
+#endif
 
 #endif /* _SynchroClock_H_ */
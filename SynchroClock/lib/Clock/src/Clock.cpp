@@ -20,14 +20,21 @@
  *      Author: liebman
  */
 
+#ifdef CLOCK_LOG_LEVEL
+#define LOGGER_LEVEL CLOCK_LOG_LEVEL
+#endif
+
 #include "Clock.h"
 #include "WireUtils.h"
+#include "Wait.h"
 
 static PROGMEM const char TAG[] = "Clock";
 
 Clock::Clock(int _pin)
 {
-    pin = _pin;
+    pin         = _pin;
+    version     = 0;
+    retry_count = 0;
 }
 
 int Clock::begin()
@@ -49,6 +56,7 @@ int Clock::begin(unsigned int retries)
         }
 
         dlog.warning(FPSTR(TAG), F("::begin: failed detect clock, %d retries left"), retries);
+        ++retry_count;
         WireUtils.clearBus();
     }
     return -1;
@@ -83,6 +91,73 @@ int Clock::writeAdjustment(uint16_t value)
 	return write(CMD_ADJUSTMENT, value);
 }
 
+//
+// hold the clock still for the next value ticks, the controller counts them
+// down itself so we don't need to stay awake.  Fails on controllers that
+// predate CMD_PAUSE.
+//
+int Clock::readPause(uint16_t *value)
+{
+    if (!hasFeature(CLOCK_VERSION_PAUSE))
+    {
+        return -1;
+    }
+    return read(CMD_PAUSE, value);
+}
+
+int Clock::writePause(uint16_t value)
+{
+    if (!hasFeature(CLOCK_VERSION_PAUSE))
+    {
+        return -1;
+    }
+    return write(CMD_PAUSE, value);
+}
+
+//
+// the clock should show position after tick number ticks (1 is the next
+// tick), the controller chooses between fast forward and pause itself and
+// starts the correction on that tick.  Fails on controllers that predate
+// CMD_TARGET.
+//
+int Clock::readTarget(uint16_t *position, uint16_t *ticks)
+{
+    if (!hasFeature(CLOCK_VERSION_TARGET))
+    {
+        return -1;
+    }
+
+    uint8_t buffer[4];
+    if (readBlock(CMD_TARGET, buffer, sizeof(buffer)))
+    {
+        return -1;
+    }
+    *position = buffer[0] | buffer[1] << 8;
+    *ticks    = buffer[2] | buffer[3] << 8;
+    return 0;
+}
+
+int Clock::writeTarget(uint16_t position, uint16_t ticks)
+{
+    if (position >= CLOCK_MAX)
+    {
+        dlog.error(FPSTR(TAG), F("::writeTarget: invalid position: %u"), position);
+        return -1;
+    }
+
+    if (!hasFeature(CLOCK_VERSION_TARGET))
+    {
+        return -1;
+    }
+
+    uint8_t buffer[4];
+    buffer[0] = position & 0xff;
+    buffer[1] = position >> 8;
+    buffer[2] = ticks & 0xff;
+    buffer[3] = ticks >> 8;
+    return writeBlock(CMD_TARGET, buffer, sizeof(buffer));
+}
+
 int Clock::readPosition(uint16_t *value)
 {
 	int err = read(CMD_POSITION, value);
@@ -108,6 +183,7 @@ int Clock::readPosition(uint16_t *value, unsigned int retries)
         }
 
         dlog.warning(FPSTR(TAG), F("::readPosition: failed, %d retries left"), retries);
+        ++retry_count;
         WireUtils.clearBus();
     }
     return -1;
@@ -203,6 +279,7 @@ int Clock::readStatus(uint8_t* value, unsigned int retries)
         }
 
         dlog.warning(FPSTR(TAG), F("::readStatus: failed, %d retries left"), retries);
+        ++retry_count;
         WireUtils.clearBus();
     }
     return -1;
@@ -228,6 +305,7 @@ int Clock::readResetReason(uint8_t* value, unsigned int retries)
         }
 
         dlog.warning(FPSTR(TAG), F("::readResetReason: failed, %d retries left"), retries);
+        ++retry_count;
         WireUtils.clearBus();
     }
     return -1;
@@ -235,7 +313,12 @@ int Clock::readResetReason(uint8_t* value, unsigned int retries)
 
 int Clock::readVersion(uint8_t* value)
 {
-    return read(CMD_VERSION, value);
+    int err = read(CMD_VERSION, value);
+    if (!err)
+    {
+        version = *value;
+    }
+    return err;
 }
 
 int Clock::readVersion(uint8_t* value, unsigned int retries)
@@ -248,11 +331,156 @@ int Clock::readVersion(uint8_t* value, unsigned int retries)
         }
 
         dlog.warning(FPSTR(TAG), F("::readVersion: failed, %d retries left"), retries);
+        ++retry_count;
+        WireUtils.clearBus();
+    }
+    return -1;
+}
+
+//
+// read id, version, reset reason, status, control, position and adjustment
+// in a single i2c transaction.  Controllers that predate CMD_SNAPSHOT don't
+// answer it so we fall back to reading each register.
+//
+int Clock::readSnapshot(ClockSnapshot* snapshot)
+{
+    if (version != 0 && version < CLOCK_VERSION_SNAPSHOT)
+    {
+        return readSnapshotSingle(snapshot);
+    }
+
+    uint8_t buffer[CLOCK_SNAPSHOT_SIZE];
+    if (readBlock(CMD_SNAPSHOT, buffer, sizeof(buffer)) || buffer[0] != CLOCK_ID_VALUE || buffer[1] < CLOCK_VERSION_SNAPSHOT)
+    {
+        dlog.warning(FPSTR(TAG), F("::readSnapshot: no snapshot support, reading registers"));
+        return readSnapshotSingle(snapshot);
+    }
+
+    snapshot->id           = buffer[0];
+    snapshot->version      = buffer[1];
+    snapshot->reset_reason = buffer[2];
+    snapshot->status       = buffer[3];
+    snapshot->control      = buffer[4];
+    snapshot->position     = buffer[5] | buffer[6] << 8;
+    snapshot->adjustment   = buffer[7] | buffer[8] << 8;
+
+    if (snapshot->position >= CLOCK_MAX)
+    {
+        dlog.error(FPSTR(TAG), F("::readSnapshot: INVALID POSITION RETURNED: %u"), snapshot->position);
+        return -1;
+    }
+
+    version = snapshot->version;
+    return 0;
+}
+
+int Clock::readSnapshot(ClockSnapshot* snapshot, unsigned int retries)
+{
+    while(retries-- > 0)
+    {
+        if (readSnapshot(snapshot) == 0)
+        {
+            return 0;
+        }
+
+        dlog.warning(FPSTR(TAG), F("::readSnapshot: failed, %d retries left"), retries);
+        ++retry_count;
         WireUtils.clearBus();
     }
     return -1;
 }
 
+int Clock::readSnapshotSingle(ClockSnapshot* snapshot)
+{
+    if (read(CMD_ID, &snapshot->id) || snapshot->id != CLOCK_ID_VALUE)
+    {
+        return -1;
+    }
+
+    if (readVersion(&snapshot->version)
+     || readResetReason(&snapshot->reset_reason)
+     || readStatus(&snapshot->status)
+     || read(CMD_CONTROL, &snapshot->control)
+     || readPosition(&snapshot->position)
+     || readAdjustment(&snapshot->adjustment))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+uint16_t Clock::getRetryCount()
+{
+    return retry_count;
+}
+
+uint8_t Clock::getVersion()
+{
+    return version;
+}
+
+//
+// read the whole pulse config in one transaction using the auto-incrementing
+// CMD_CONFIG block, older controllers are read one register at a time.
+//
+int Clock::readConfig(ClockConfig* config)
+{
+    if (!hasFeature(CLOCK_VERSION_CONFIG))
+    {
+        if (readTPDuration(&config->tp_duration)
+         || readTPDuty(&config->tp_duty)
+         || readAPDuration(&config->ap_duration)
+         || readAPDuty(&config->ap_duty)
+         || readAPDelay(&config->ap_delay)
+         || readAPStartDuration(&config->ap_start_duration)
+         || readPWMTop(&config->pwm_top))
+        {
+            return -1;
+        }
+        return 0;
+    }
+
+    return readBlock(CMD_CONFIG, (uint8_t*)config, sizeof(ClockConfig));
+}
+
+int Clock::writeConfig(const ClockConfig* config)
+{
+    if (!hasFeature(CLOCK_VERSION_CONFIG))
+    {
+        if (writeTPDuration(config->tp_duration)
+         || writeTPDuty(config->tp_duty)
+         || writeAPDuration(config->ap_duration)
+         || writeAPDuty(config->ap_duty)
+         || writeAPDelay(config->ap_delay)
+         || writeAPStartDuration(config->ap_start_duration)
+         || writePWMTop(config->pwm_top))
+        {
+            return -1;
+        }
+        return 0;
+    }
+
+    return writeBlock(CMD_CONFIG, (const uint8_t*)config, sizeof(ClockConfig));
+}
+
+//
+// true if the controller firmware is at least first_version, reads the
+// version if we don't know it yet.
+//
+bool Clock::hasFeature(uint8_t first_version)
+{
+    if (version == 0)
+    {
+        uint8_t value;
+        if (readVersion(&value))
+        {
+            return false;
+        }
+    }
+    return version >= first_version;
+}
+
 bool Clock::getEnable()
 {
     return getCommandBit(BIT_ENABLE);
@@ -388,6 +616,59 @@ int Clock::write(uint8_t command, uint8_t value)
     return 0;
 }
 
+int Clock::readBlock(uint8_t command, uint8_t *buffer, size_t size)
+{
+    Wire.beginTransmission(I2C_ADDRESS);
+    if (Wire.write(command) != 1)
+    {
+        Wire.endTransmission();
+        dlog.error(FPSTR(TAG), F("::readBlock: Wire.write(command=%d) failed!"), command);
+        return -1;
+    }
+    int err = Wire.endTransmission();
+    if (err)
+    {
+        dlog.error(FPSTR(TAG), F("::readBlock: Wire.endTransmission() returned: %d"), err);
+        return -1;
+    }
+    size_t count = Wire.requestFrom((uint8_t)I2C_ADDRESS, size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        buffer[i] = Wire.read();
+    }
+    if (count != size)
+    {
+        dlog.error(FPSTR(TAG), F("::readBlock: Wire.requestFrom() returns %u, expected %u"), count, size);
+        return -1;
+    }
+    return 0;
+}
+
+int Clock::writeBlock(uint8_t command, const uint8_t *buffer, size_t size)
+{
+    Wire.beginTransmission(I2C_ADDRESS);
+    if (Wire.write(command) != 1)
+    {
+        Wire.endTransmission();
+        dlog.error(FPSTR(TAG), F("::writeBlock: Wire.write(command=%d) failed!"), command);
+        return -1;
+    }
+    size_t count = Wire.write(buffer, size);
+    if (count != size)
+    {
+        Wire.endTransmission();
+        dlog.error(FPSTR(TAG), F("::writeBlock: Wire.write() returns %u, expected %u"), count, size);
+        return -1;
+    }
+    int err = Wire.endTransmission();
+    if (err)
+    {
+        dlog.error(FPSTR(TAG), F("::writeBlock: Wire.endTransmission() returned: %d"), err);
+        return -1;
+    }
+    return 0;
+}
+
 int Clock::read(uint8_t command, uint16_t *value)
 {
     Wire.beginTransmission(I2C_ADDRESS);
@@ -440,14 +721,69 @@ int Clock::write(uint8_t command, uint16_t value)
     return 0;
 }
 
-void Clock::waitForEdge(int edge)
+//
+// edge capture, set from the pin interrupt while waitForEdge is waiting
+//
+static volatile bool     edge_seen;
+static volatile uint32_t edge_time;
+
+static void ICACHE_RAM_ATTR edgeISR()
 {
-    while (digitalRead(pin) == edge)
+    if (!edge_seen)
     {
-        delay(1);
+        edge_time = micros();
+        edge_seen = true;
+    }
+}
+
+int Clock::waitForEdge(int edge)
+{
+    return waitForEdge(edge, NULL, CLOCK_EDGE_TIMEOUT);
+}
+
+int Clock::waitForEdge(int edge, uint32_t* edge_us)
+{
+    return waitForEdge(edge, edge_us, CLOCK_EDGE_TIMEOUT);
+}
+
+//
+// wait for the next rising or falling edge on the sync pin.  The edge is
+// caught by a pin interrupt that records micros() so the caller gets the
+// exact edge time, we just idle in delay() until it happens.  Until the
+// pin gets to the level the edge leaves we may light sleep, waking on that
+// level, its wake up is too slow to time the edge itself.
+// returns -1 if no edge is seen in timeout_ms.
+//
+int Clock::waitForEdge(int edge, uint32_t* edge_us, uint32_t timeout_ms)
+{
+    // the level wait and the edge wait share timeout_ms
+    uint32_t start = millis();
+    if (Wait::pin(pin, edge == CLOCK_EDGE_RISING ? LOW : HIGH, timeout_ms))
+    {
+        dlog.error(FPSTR(TAG), F("::waitForEdge: sync pin stuck %s for %u ms!"), edge == CLOCK_EDGE_RISING ? "high" : "low", timeout_ms);
+        return -1;
     }
-    while (digitalRead(pin) != edge)
+
+    edge_seen = false;
+    attachInterrupt(digitalPinToInterrupt(pin), edgeISR, edge == CLOCK_EDGE_RISING ? RISING : FALLING);
+
+    while (!edge_seen && (millis() - start) < timeout_ms)
     {
         delay(1);
     }
+
+    detachInterrupt(digitalPinToInterrupt(pin));
+
+    if (!edge_seen)
+    {
+        dlog.error(FPSTR(TAG), F("::waitForEdge: no %s edge after %u ms!"), edge == CLOCK_EDGE_RISING ? "rising" : "falling", timeout_ms);
+        return -1;
+    }
+
+    if (edge_us != NULL)
+    {
+        *edge_us = edge_time;
+    }
+
+    return 0;
 }
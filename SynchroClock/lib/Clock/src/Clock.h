@@ -46,6 +46,10 @@
 #define CMD_RESET       0x0d // factory reset
 #define CMD_RST_REASON  0x0e // last reset reason
 #define CMD_VERSION     0x0f // Clock firmware version
+#define CMD_SNAPSHOT    0x10 // id, version, reset reason, status, control, position & adjustment
+#define CMD_PAUSE       0x11 // ticks to hold the clock still, counted down by the controller
+#define CMD_TARGET      0x12 // target position & ticks until valid, the controller plans the correction
+#define CMD_CONFIG      0x20 // auto-incrementing config block, laid out as ClockConfig
 
 // control register bits
 #define BIT_ENABLE      0x80
@@ -57,12 +61,49 @@
 
 #define CLOCK_ID_VALUE  0x42
 
+// first clock controller firmware versions supporting a feature
+#define CLOCK_VERSION_SNAPSHOT  2
+#define CLOCK_VERSION_CONFIG    3
+#define CLOCK_VERSION_PAUSE     4
+#define CLOCK_VERSION_TARGET    5
+
 #define CLOCK_EDGE_RISING  1
 #define CLOCK_EDGE_FALLING 0
+#define CLOCK_EDGE_TIMEOUT 2000 // ms to wait for an edge, the SQW period is 1 second
 
 #define CLOCK_ERROR     0xffff
 #define CLOCK_MAX       43200
 
+#define CLOCK_SNAPSHOT_SIZE 9
+
+//
+// Clock controller state as read at wake time
+//
+typedef struct clock_snapshot
+{
+    uint8_t  id;
+    uint8_t  version;
+    uint8_t  reset_reason;
+    uint8_t  status;
+    uint8_t  control;
+    uint16_t position;
+    uint16_t adjustment;
+} ClockSnapshot;
+
+//
+// Clock controller pulse config, field order matches the CMD_CONFIG block
+//
+typedef struct clock_config
+{
+    uint8_t tp_duration;
+    uint8_t tp_duty;
+    uint8_t ap_duration;
+    uint8_t ap_duty;
+    uint8_t ap_delay;
+    uint8_t ap_start_duration;
+    uint8_t pwm_top;
+} ClockConfig;
+
 class Clock
 {
 public:
@@ -72,6 +113,10 @@ public:
     bool isClockPresent();
     int readAdjustment(uint16_t *value);
     int writeAdjustment(uint16_t value);
+    int readPause(uint16_t *value);
+    int writePause(uint16_t value);
+    int readTarget(uint16_t *position, uint16_t *ticks);
+    int writeTarget(uint16_t position, uint16_t ticks);
     int readPosition(uint16_t* value);
     int readPosition(uint16_t* value, unsigned int retries);
     int writePosition(uint16_t value);
@@ -96,15 +141,29 @@ public:
     int readResetReason(uint8_t* value, unsigned int retries);
     int readVersion(uint8_t* value);
     int readVersion(uint8_t* value, unsigned int retries);
+    int readSnapshot(ClockSnapshot* snapshot);
+    int readSnapshot(ClockSnapshot* snapshot, unsigned int retries);
+    uint8_t getVersion();
+    uint16_t getRetryCount(); // transfers retried by the retries variants
+    int readConfig(ClockConfig* config);
+    int writeConfig(const ClockConfig* config);
 
     bool getEnable();
     void setEnable(bool enable);
     int saveConfig();
     bool getCommandBit(uint8_t);
     int setCommandBit(bool value, uint8_t bit);
-    void waitForEdge(int edge);
+    int waitForEdge(int edge);
+    int waitForEdge(int edge, uint32_t* edge_us);
+    int waitForEdge(int edge, uint32_t* edge_us, uint32_t timeout_ms);
 private:
-    int pin;
+    int     pin;
+    uint8_t version; // controller firmware version, 0 until we have read it
+    uint16_t retry_count;
+    int readSnapshotSingle(ClockSnapshot* snapshot);
+    bool hasFeature(uint8_t first_version);
+    int readBlock(uint8_t command, uint8_t *buffer, size_t size);
+    int writeBlock(uint8_t command, const uint8_t *buffer, size_t size);
     int read(uint8_t  command, uint16_t *value);
     int write(uint8_t command, uint16_t  value);
     int read(uint8_t  command, uint8_t *value);
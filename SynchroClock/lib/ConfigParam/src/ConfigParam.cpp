@@ -20,6 +20,10 @@
  *      Author: chris.l
  */
 
+#ifdef CONFIGPARAM_LOG_LEVEL
+#define LOGGER_LEVEL CONFIGPARAM_LOG_LEVEL
+#endif
+
 #include "ConfigParam.h"
 
 static PROGMEM const char TAG[] = "ConfigParam";
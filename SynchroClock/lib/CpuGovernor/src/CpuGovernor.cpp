@@ -0,0 +1,130 @@
+/*
+ * CpuGovernor.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef CPUGOVERNOR_LOG_LEVEL
+#define LOGGER_LEVEL CPUGOVERNOR_LOG_LEVEL
+#endif
+
+#include "CpuGovernor.h"
+extern "C" {
+#include <user_interface.h>
+}
+
+static PROGMEM const char TAG[] = "CpuGovernor";
+
+// indexed by CpuPhase
+static PROGMEM const char    phase_names[CPU_PHASE_COUNT][6] = { "boot", "wifi", "ota", "ntp", "clock", "log", "idle" };
+static PROGMEM const uint8_t phase_mhz[CPU_PHASE_COUNT]      = { 80, 80, 160, 80, 80, 160, 80 };
+
+static CpuPhase current;
+static bool     radio;
+static uint32_t start_us;
+static uint32_t phase_us[CPU_PHASE_COUNT];
+static double   phase_charge[CPU_PHASE_COUNT];
+
+//
+// start the timers at the wake, radio is false when the wake has the RF disabled
+//
+void CpuGovernor::begin(bool _radio)
+{
+    memset(phase_us, 0, sizeof(phase_us));
+    memset(phase_charge, 0, sizeof(phase_charge));
+    radio    = _radio;
+    current  = CPU_PHASE_BOOT;
+    start_us = micros();
+    phase(CPU_PHASE_BOOT);
+}
+
+void CpuGovernor::settle()
+{
+    uint32_t now     = micros();
+    uint32_t elapsed = now - start_us;
+    double   ma      = pgm_read_byte(&phase_mhz[current]) == 160 ? CPU_GOVERNOR_160MHZ_MA : CPU_GOVERNOR_80MHZ_MA;
+    if (radio)
+    {
+        ma += CPU_GOVERNOR_RADIO_MA;
+    }
+    phase_us[current]     += elapsed;
+    phase_charge[current] += ma * elapsed / 1000000.0;
+    start_us               = now;
+}
+
+void CpuGovernor::phase(CpuPhase phase)
+{
+    settle();
+    current = phase;
+    uint8_t mhz = pgm_read_byte(&phase_mhz[phase]);
+    if (system_get_cpu_freq() != mhz)
+    {
+        system_update_cpu_freq(mhz);
+    }
+}
+
+CpuPhase CpuGovernor::getPhase()
+{
+    return current;
+}
+
+uint8_t CpuGovernor::getMHz(CpuPhase phase)
+{
+    return pgm_read_byte(&phase_mhz[phase]);
+}
+
+uint32_t CpuGovernor::getMicros(CpuPhase phase)
+{
+    settle();
+    return phase_us[phase];
+}
+
+double CpuGovernor::getCharge()
+{
+    settle();
+    double total = 0.0;
+    for (int i = 0; i < CPU_PHASE_COUNT; ++i)
+    {
+        total += phase_charge[i];
+    }
+    return total;
+}
+
+//
+// one line with the phases that ran and the estimated charge for the wake
+//
+void CpuGovernor::report()
+{
+    char line[128];
+    size_t len = 0;
+    line[0] = '\0';
+    settle();
+    for (int i = 0; i < CPU_PHASE_COUNT && len < sizeof(line); ++i)
+    {
+        if (phase_us[i] == 0)
+        {
+            continue;
+        }
+        char name[6];
+        strncpy_P(name, phase_names[i], sizeof(name));
+        len += snprintf_P(&line[len], sizeof(line) - len, PSTR(" %s %lums@%u %.1fmAs"), name,
+                (unsigned long)phase_us[i] / 1000, pgm_read_byte(&phase_mhz[i]), phase_charge[i]);
+    }
+    dlog.info(FPSTR(TAG), F("wake %.1fmAs:%s"), getCharge(), line);
+}
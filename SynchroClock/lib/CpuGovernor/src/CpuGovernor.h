@@ -0,0 +1,69 @@
+/*
+ * CpuGovernor.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef CPUGOVERNOR_H_
+#define CPUGOVERNOR_H_
+#include <Arduino.h>
+#include "Logger.h"
+
+//
+// Runs each phase of a wake at the CPU clock that suits it: 160MHz where
+// the CPU is the bottleneck (TLS for OTA, formatting and sending the log
+// before sleeping) and 80MHz where we wait on the radio, the RTC or the
+// clock controller.  setup() marks the phases, the time spent in each is
+// kept and turned into a charge estimate for the wake.
+//
+// Ballpark ESP8266 supply currents, the radio adds to the CPU current when
+// the wake has it enabled.
+//
+#define CPU_GOVERNOR_80MHZ_MA   15.0
+#define CPU_GOVERNOR_160MHZ_MA  23.0
+#define CPU_GOVERNOR_RADIO_MA   55.0
+
+typedef enum cpu_phase
+{
+    CPU_PHASE_BOOT,     // config, RTC and controller reads
+    CPU_PHASE_WIFI,     // waiting to associate
+    CPU_PHASE_OTA,      // TLS handshake and flashing
+    CPU_PHASE_NTP,      // waiting on the server
+    CPU_PHASE_CLOCK,    // waiting on RTC edges, controller writes
+    CPU_PHASE_LOG,      // formatting and sending the log before sleeping
+    CPU_PHASE_IDLE,     // stay awake, serving http
+    CPU_PHASE_COUNT
+} CpuPhase;
+
+class CpuGovernor
+{
+public:
+    static void     begin(bool radio);
+    static void     phase(CpuPhase phase);
+    static CpuPhase getPhase();
+    static uint8_t  getMHz(CpuPhase phase);
+    static uint32_t getMicros(CpuPhase phase);  // time spent in phase this wake
+    static double   getCharge();                // estimated mA*s this wake
+    static void     report();
+
+private:
+    static void     settle();
+};
+
+#endif /* CPUGOVERNOR_H_ */
@@ -20,7 +20,12 @@
  *      Author: chris.l
  */
 
+#ifdef DS3231_LOG_LEVEL
+#define LOGGER_LEVEL DS3231_LOG_LEVEL
+#endif
+
 #include "DS3231.h"
+#include "Wait.h"
 
 static PROGMEM const char TAG[] = "DS3231";
 
@@ -41,7 +46,7 @@ int DS3231::begin()
     }
 
     dlog.info(FPSTR(TAG),F("::begin: small delay"));
-    delay(100);
+    Wait::ms(100);
 
     dlog.info(FPSTR(TAG),F("::begin: reading HOUR register to insure 24hr format"));
     // set the clock to 24hr format
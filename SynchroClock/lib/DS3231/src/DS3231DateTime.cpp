@@ -20,6 +20,10 @@
  *      Author: chris.l
  */
 
+#ifdef DS3231_LOG_LEVEL
+#define LOGGER_LEVEL DS3231_LOG_LEVEL
+#endif
+
 #include "DS3231DateTime.h"
 
 static PROGMEM const char TAG[] = "DS3231DateTime";
@@ -94,37 +98,35 @@ boolean DS3231DateTime::isValid()
     return true;
 }
 
+//
+// The RTC fields convert straight to/from days since the epoch, there is no
+// need to go thru a struct tm.
+//
 void DS3231DateTime::setUnixTime(unsigned long time)
 {
-    struct tm tm;
-    TimeUtils::gmtime_r((time_t*)&time, &tm);
-
-    dlog.debug(FPSTR(TAG), F("::setUnixTime month: %d"), tm.tm_mon);
-
-    seconds = tm.tm_sec;
-    minutes = tm.tm_min;
-    hours   = tm.tm_hour;
-    day     = tm.tm_wday;
-    date    = tm.tm_mday;
-    month   = tm.tm_mon  + 1;
-    year    = tm.tm_year - 100;
+    unsigned long days   = time / 86400;
+    unsigned long clock  = time % 86400;
+
+    int y, m, d;
+    TimeUtils::civilFromDays(days, &y, &m, &d);
+
+    dlog.debug(FPSTR(TAG), F("::setUnixTime month: %d"), m - 1);
+
+    seconds = clock % 60;
+    minutes = (clock % 3600) / 60;
+    hours   = clock / 3600;
+    day     = (days + 4) % 7; // Day 0 was a thursday
+    date    = d;
+    month   = m;
+    year    = y - 2000;
     century = 0;
     dbvalue("setUnixTime new value:");
 }
 
 unsigned long DS3231DateTime::getUnixTime()
 {
-    struct tm tm;
-    tm.tm_sec   = seconds;
-    tm.tm_min   = minutes;
-    tm.tm_hour  = hours;
-    tm.tm_mday  = date;
-    tm.tm_mon   = month - 1;
-    tm.tm_year  = year  + 100;
-    tm.tm_isdst = 0;
-    tm.tm_wday  = 0;
-    tm.tm_yday  = 0;
-    unsigned long unix = TimeUtils::mktime(&tm);
+    unsigned long days = TimeUtils::daysFromCivil(year + 2000, month, date);
+    unsigned long unix = days * 86400 + hours * 3600UL + minutes * 60 + seconds;
     dlog.debug(FPSTR(TAG), F("::getUnixTime: returning unix time: %lu"), unix);
     return unix;
 }
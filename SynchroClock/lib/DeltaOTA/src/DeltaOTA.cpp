@@ -0,0 +1,106 @@
+/*
+ * DeltaOTA.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef DELTAOTA_LOG_LEVEL
+#define LOGGER_LEVEL DELTAOTA_LOG_LEVEL
+#endif
+
+#include "DeltaOTA.h"
+#include <Updater.h>
+
+static PROGMEM const char TAG[] = "DeltaOTA";
+
+static void toHex(const uint8_t* md5, char* hex)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        snprintf_P(&hex[i*2], 3, PSTR("%02x"), md5[i]);
+    }
+}
+
+static int beginUpdate(const DeltaHeader* header)
+{
+    char md5[33];
+    toHex(header->source_md5, md5);
+    if (header->source_size != ESP.getSketchSize() || strcmp(md5, ESP.getSketchMD5().c_str()))
+    {
+        dlog.error(FPSTR(TAG), F("::beginUpdate: patch is for %u bytes md5 %s, not the running image"),
+                header->source_size, md5);
+        return -1;
+    }
+    if (!Update.begin(header->target_size))
+    {
+        dlog.error(FPSTR(TAG), F("::beginUpdate: no room for %u bytes!"), header->target_size);
+        return -1;
+    }
+    toHex(header->target_md5, md5);
+    Update.setMD5(md5);
+    return 0;
+}
+
+//
+// the image starts at flash offset 0, flashRead wants whole aligned words
+//
+static int readSketch(uint32_t offset, uint8_t* data, size_t len)
+{
+    uint32_t words[DELTA_COPY_SIZE/4 + 2];
+    uint32_t start = offset & ~3;
+    uint32_t end   = (offset + len + 3) & ~3;
+    if (end - start > sizeof(words) || !ESP.flashRead(start, words, end - start))
+    {
+        return -1;
+    }
+    memcpy(data, (uint8_t*)words + (offset - start), len);
+    return 0;
+}
+
+static int writeUpdate(const uint8_t* data, size_t len)
+{
+    return Update.write((uint8_t*)data, len) == len ? 0 : -1;
+}
+
+int DeltaOTA::update(WiFiClient& client, const char* url)
+{
+    DeltaPatch patch(beginUpdate, readSketch, writeUpdate);
+    int result = patch.fetch([&](uint32_t offset)
+    {
+        HTTPClient http;
+        fetchRange(http, client, url, offset, patch);
+    }, DELTA_OTA_RETRIES, DELTA_OTA_RETRY_DELAY);
+
+    if (result)
+    {
+        if (Update.isRunning())
+        {
+            Update.end(false);
+        }
+        return -1;
+    }
+
+    if (!Update.end())
+    {
+        dlog.error(FPSTR(TAG), F("::update: finishing update failed: %u"), Update.getError());
+        return -1;
+    }
+    dlog.info(FPSTR(TAG), F("::update: %u bytes from a %u byte patch"), patch.getTargetSize(), patch.getOffset());
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * DeltaOTA.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef DELTAOTA_H_
+#define DELTAOTA_H_
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#include "DeltaPatch.h"
+
+//
+// Download a delta patch (see DeltaPatch.h) and apply it against the
+// running image straight into the OTA partition.  An interrupted transfer
+// is resumed with a Range request from where the patch left off.
+//
+#define DELTA_OTA_RETRIES      5      // attempts in a row without progress
+#define DELTA_OTA_RETRY_DELAY  2000   // milliseconds between attempts
+#define DELTA_OTA_TIMEOUT      10000  // milliseconds without data before giving up on a connection
+#define DELTA_OTA_BUFFER_SIZE  512
+
+class DeltaOTA
+{
+public:
+    static int update(WiFiClient& client, const char* url);
+
+    // one GET from offset on with http (an HTTPClient, or a stand-in in the tests)
+    template <typename HTTP>
+    static void fetchRange(HTTP& http, WiFiClient& client, const char* url, uint32_t offset, DeltaPatch& patch);
+};
+
+//
+// feeds whatever arrives to the patch.  A 206 is the patch from offset, a
+// 200 is the whole patch (the Range was ignored) and the patch skips what it
+// already has.  Ends when the connection drops or no data comes for
+// DELTA_OTA_TIMEOUT, patch.fetch() decides whether to try again.
+//
+template <typename HTTP>
+void DeltaOTA::fetchRange(HTTP& http, WiFiClient& client, const char* url, uint32_t offset, DeltaPatch& patch)
+{
+    http.useHTTP10(true); // no chunked encoding, the stream is the patch
+    http.setTimeout(DELTA_OTA_TIMEOUT);
+    if (!http.begin(client, url))
+    {
+        dlog.error(F("DeltaOTA"), F("::fetchRange: bad url '%s'"), url);
+        return;
+    }
+    if (offset)
+    {
+        char range[24];
+        snprintf_P(range, sizeof(range), PSTR("bytes=%u-"), offset);
+        http.addHeader(F("Range"), range);
+    }
+
+    int code = http.GET();
+    uint32_t pos;
+    if (code == HTTP_CODE_PARTIAL_CONTENT)
+    {
+        pos = offset;
+    }
+    else if (code == HTTP_CODE_OK)
+    {
+        pos = 0; // the Range was ignored, the patch skips what it has
+    }
+    else
+    {
+        dlog.error(F("DeltaOTA"), F("::fetchRange: GET from %u failed: %d"), offset, code);
+        http.end();
+        return;
+    }
+    dlog.info(F("DeltaOTA"), F("::fetchRange: %d from %u"), code, pos);
+
+    auto*    stream = http.getStreamPtr();
+    uint8_t  buf[DELTA_OTA_BUFFER_SIZE];
+    uint32_t last = millis();
+    while (!patch.isDone() && !patch.isFailed() && millis() - last < DELTA_OTA_TIMEOUT)
+    {
+        size_t available = stream->available();
+        if (available == 0)
+        {
+            if (!stream->connected())
+            {
+                break;
+            }
+            delay(1);
+            continue;
+        }
+        size_t n = stream->read(buf, std::min(available, sizeof(buf)));
+        if (patch.write(pos, buf, n))
+        {
+            break;
+        }
+        pos += n;
+        last = millis();
+    }
+    http.end();
+}
+
+#endif /* DELTAOTA_H_ */
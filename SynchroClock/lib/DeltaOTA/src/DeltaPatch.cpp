@@ -0,0 +1,297 @@
+/*
+ * DeltaPatch.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef DELTAOTA_LOG_LEVEL
+#define LOGGER_LEVEL DELTAOTA_LOG_LEVEL
+#endif
+
+#include "DeltaPatch.h"
+
+static PROGMEM const char TAG[] = "DeltaPatch";
+
+static uint32_t get32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+DeltaPatch::DeltaPatch(DeltaBegin begin, DeltaRead read, DeltaWrite write)
+: _begin(begin),
+  _read(read),
+  _write(write),
+  _state(StateHeader),
+  _have(0),
+  _need(DELTA_HEADER_SIZE),
+  _op(DELTA_OP_END),
+  _insert_left(0),
+  _offset(0),
+  _target(0)
+{
+    memset(&_header, 0, sizeof(_header));
+}
+
+uint32_t DeltaPatch::getOffset()
+{
+    return _offset;
+}
+
+uint32_t DeltaPatch::getTargetSize()
+{
+    return _target;
+}
+
+bool DeltaPatch::isDone()
+{
+    return _state == StateDone;
+}
+
+bool DeltaPatch::isFailed()
+{
+    return _state == StateFailed;
+}
+
+int DeltaPatch::fail()
+{
+    _state = StateFailed;
+    return -1;
+}
+
+int DeltaPatch::write(uint32_t offset, const uint8_t* data, size_t len)
+{
+    if (_state == StateFailed)
+    {
+        return -1;
+    }
+
+    // skip anything we already have, a gap means bytes were lost
+    if (offset > _offset)
+    {
+        dlog.error(FPSTR(TAG), F("::write: got offset %u expected %u"), offset, _offset);
+        return fail();
+    }
+    uint32_t skip = _offset - offset;
+    if (skip >= len)
+    {
+        return 0;
+    }
+    data += skip;
+    len  -= skip;
+
+    while (len > 0)
+    {
+        size_t n;
+        switch (_state)
+        {
+        case StateHeader:
+        case StateOp:
+        case StateArgs:
+            n = std::min(len, _need - _have);
+            memcpy(&_buf[_have], data, n);
+            _have += n;
+            break;
+
+        case StateInsert:
+            n = std::min((uint32_t)len, _insert_left);
+            if (_write(data, n))
+            {
+                dlog.error(FPSTR(TAG), F("::write: target write failed at %u"), _offset);
+                return fail();
+            }
+            _target      += n;
+            _insert_left -= n;
+            break;
+
+        default:
+            dlog.error(FPSTR(TAG), F("::write: data after the end at %u"), _offset);
+            return fail();
+        }
+
+        data    += n;
+        len     -= n;
+        _offset += n;
+
+        if (_state == StateInsert)
+        {
+            if (_insert_left == 0)
+            {
+                _state = StateOp;
+                _have  = 0;
+                _need  = 1;
+            }
+        }
+        else if (_have == _need)
+        {
+            int result = _state == StateHeader ? parseHeader() : runOp();
+            if (result)
+            {
+                return result;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int DeltaPatch::parseHeader()
+{
+    if (get32(&_buf[0]) != DELTA_MAGIC || get32(&_buf[4]) != DELTA_VERSION)
+    {
+        dlog.error(FPSTR(TAG), F("::parseHeader: not a version %u delta patch!"), DELTA_VERSION);
+        return fail();
+    }
+    _header.source_size = get32(&_buf[8]);
+    memcpy(_header.source_md5, &_buf[12], sizeof(_header.source_md5));
+    _header.target_size = get32(&_buf[28]);
+    memcpy(_header.target_md5, &_buf[32], sizeof(_header.target_md5));
+    dlog.info(FPSTR(TAG), F("::parseHeader: source %u bytes target %u bytes"), _header.source_size, _header.target_size);
+
+    if (_begin(&_header))
+    {
+        dlog.error(FPSTR(TAG), F("::parseHeader: patch refused!"));
+        return fail();
+    }
+    _state = StateOp;
+    _have  = 0;
+    _need  = 1;
+    return 0;
+}
+
+//
+// called with the op byte and again once its arguments are collected
+//
+int DeltaPatch::runOp()
+{
+    if (_state == StateOp)
+    {
+        _op = _buf[0];
+        switch (_op)
+        {
+        case DELTA_OP_END:
+            if (_target != _header.target_size)
+            {
+                dlog.error(FPSTR(TAG), F("::runOp: target is %u bytes expected %u"), _target, _header.target_size);
+                return fail();
+            }
+            dlog.info(FPSTR(TAG), F("::runOp: done, %u patch bytes %u target bytes"), _offset, _target);
+            _state = StateDone;
+            return 0;
+        case DELTA_OP_COPY:
+            _need = 8;
+            break;
+        case DELTA_OP_INSERT:
+            _need = 4;
+            break;
+        default:
+            dlog.error(FPSTR(TAG), F("::runOp: unknown op 0x%02x at %u"), _op, _offset);
+            return fail();
+        }
+        _state = StateArgs;
+        _have  = 0;
+        return 0;
+    }
+
+    uint32_t len = _op == DELTA_OP_COPY ? get32(&_buf[4]) : get32(&_buf[0]);
+    if (len > _header.target_size - _target)
+    {
+        dlog.error(FPSTR(TAG), F("::runOp: op past the target size at %u"), _offset);
+        return fail();
+    }
+
+    if (_op == DELTA_OP_COPY)
+    {
+        int result = copy(get32(&_buf[0]), len);
+        if (result)
+        {
+            return result;
+        }
+        _state = StateOp;
+    }
+    else
+    {
+        _insert_left = len;
+        _state       = len ? StateInsert : StateOp;
+    }
+    _have = 0;
+    _need = 1;
+    return 0;
+}
+
+int DeltaPatch::copy(uint32_t from, uint32_t len)
+{
+    if (from > _header.source_size || len > _header.source_size - from)
+    {
+        dlog.error(FPSTR(TAG), F("::copy: past the source size at %u"), _offset);
+        return fail();
+    }
+
+    uint8_t buf[DELTA_COPY_SIZE];
+    while (len > 0)
+    {
+        size_t n = std::min(len, (uint32_t)sizeof(buf));
+        if (_read(from, buf, n))
+        {
+            dlog.error(FPSTR(TAG), F("::copy: source read failed at %u"), _offset);
+            return fail();
+        }
+        if (_write(buf, n))
+        {
+            dlog.error(FPSTR(TAG), F("::copy: target write failed at %u"), _offset);
+            return fail();
+        }
+        from    += n;
+        len     -= n;
+        _target += n;
+    }
+    return 0;
+}
+
+//
+// fetch until the patch is done, an attempt that gets nothing new counts
+// against retries, one that makes progress starts the count over.
+//
+int DeltaPatch::fetch(DeltaFetch fetch, unsigned int retries, uint32_t retry_delay_ms)
+{
+    unsigned int failures = 0;
+    for (;;)
+    {
+        uint32_t start = _offset;
+        fetch(start);
+        if (_state == StateDone)
+        {
+            return 0;
+        }
+        if (_state == StateFailed)
+        {
+            return -1;
+        }
+        if (_offset > start)
+        {
+            failures = 0;
+        }
+        else if (++failures > retries)
+        {
+            dlog.error(FPSTR(TAG), F("::fetch: giving up at patch offset %u"), _offset);
+            return -1;
+        }
+        dlog.warning(FPSTR(TAG), F("::fetch: interrupted at patch offset %u, resuming"), _offset);
+        delay(retry_delay_ms);
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * DeltaPatch.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef DELTAPATCH_H_
+#define DELTAPATCH_H_
+#include <Arduino.h>
+#include <functional>
+#include "Logger.h"
+
+//
+// Applies a delta patch made by mkdelta.py as it streams in.  The patch is
+// a header followed by ops that build the new image from pieces of the
+// running one (COPY) and new bytes carried in the patch (INSERT), all
+// values little endian:
+//
+//   header: magic, version, source size, source md5[16], target size, target md5[16]
+//   COPY:   0x01, source offset, length
+//   INSERT: 0x02, length, the bytes
+//   END:    0x00
+//
+// write() takes the patch offset of each piece so the download can be
+// resumed from getOffset() with a Range request, bytes it already has
+// (a server that ignored the Range) are skipped.
+//
+#define DELTA_MAGIC        0x50444353  // "SCDP"
+#define DELTA_VERSION      1
+#define DELTA_HEADER_SIZE  48
+#define DELTA_OP_END       0x00
+#define DELTA_OP_COPY      0x01
+#define DELTA_OP_INSERT    0x02
+#define DELTA_COPY_SIZE    256         // bytes read from the source at a time
+
+typedef struct delta_header
+{
+    uint32_t source_size;
+    uint8_t  source_md5[16];
+    uint32_t target_size;
+    uint8_t  target_md5[16];
+} DeltaHeader;
+
+// called once with the header, return -1 to refuse the patch
+typedef std::function<int(const DeltaHeader* header)>                  DeltaBegin;
+// read from the running image
+typedef std::function<int(uint32_t offset, uint8_t* data, size_t len)> DeltaRead;
+// append to the new image
+typedef std::function<int(const uint8_t* data, size_t len)>            DeltaWrite;
+// deliver the patch from offset on with write()
+typedef std::function<void(uint32_t offset)>                           DeltaFetch;
+
+class DeltaPatch
+{
+public:
+    DeltaPatch(DeltaBegin begin, DeltaRead read, DeltaWrite write);
+    int      write(uint32_t offset, const uint8_t* data, size_t len);
+    int      fetch(DeltaFetch fetch, unsigned int retries, uint32_t retry_delay_ms);
+    uint32_t getOffset();       // patch bytes used, where to resume
+    uint32_t getTargetSize();   // new image bytes written
+    bool     isDone();
+    bool     isFailed();
+
+private:
+    enum State
+    {
+        StateHeader,
+        StateOp,
+        StateArgs,
+        StateInsert,
+        StateDone,
+        StateFailed
+    };
+
+    int      fail();
+    int      parseHeader();
+    int      runOp();
+    int      copy(uint32_t from, uint32_t len);
+
+    DeltaBegin  _begin;
+    DeltaRead   _read;
+    DeltaWrite  _write;
+    State       _state;
+    uint8_t     _buf[DELTA_HEADER_SIZE]; // header or op being collected
+    size_t      _have;
+    size_t      _need;
+    uint8_t     _op;
+    uint32_t    _insert_left;
+    uint32_t    _offset;
+    uint32_t    _target;
+    DeltaHeader _header;
+};
+
+#endif /* DELTAPATCH_H_ */
@@ -0,0 +1,225 @@
+/*
+ * Json.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Json.h"
+
+static const char* skipSpace(const char* p)
+{
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+    {
+        ++p;
+    }
+    return p;
+}
+
+//
+// copy the string starting after the opening quote into value, returns
+// a pointer past the closing quote or NULL.  \u escapes are only
+// accepted for ASCII.
+//
+static const char* parseString(const char* p, char* value, size_t size)
+{
+    size_t len = 0;
+    while (*p != '"')
+    {
+        char c = *p++;
+        if (c == '\0' || (uint8_t)c < 0x20)
+        {
+            return NULL;
+        }
+        if (c == '\\')
+        {
+            c = *p++;
+            switch (c)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'n': c = '\n'; break;
+            case 'r': c = '\r'; break;
+            case 't': c = '\t'; break;
+            case 'u':
+            {
+                char hex[5];
+                char* end;
+                strncpy(hex, p, 4);
+                hex[4] = '\0';
+                long u = strtol(hex, &end, 16);
+                if (end != hex + 4 || u < 0x01 || u > 0x7f)
+                {
+                    return NULL;
+                }
+                c = (char)u;
+                p += 4;
+                break;
+            }
+            default:
+                return NULL;
+            }
+        }
+        if (len >= size - 1)
+        {
+            return NULL;
+        }
+        value[len++] = c;
+    }
+    value[len] = '\0';
+    return p + 1;
+}
+
+// a bare number, true, false or null
+static const char* parseLiteral(const char* p, char* value, size_t size)
+{
+    size_t len = 0;
+    while ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') || *p == '-' || *p == '+' || *p == '.' || *p == 'E')
+    {
+        if (len >= size - 1)
+        {
+            return NULL;
+        }
+        value[len++] = *p++;
+    }
+    value[len] = '\0';
+    return len ? p : NULL;
+}
+
+int JsonReader::parse(const char* json, JsonMember member)
+{
+    char name[JSON_NAME_SIZE];
+    char value[JSON_VALUE_SIZE];
+
+    const char* p = skipSpace(json);
+    if (*p++ != '{')
+    {
+        return -1;
+    }
+    p = skipSpace(p);
+    if (*p == '}')
+    {
+        return *skipSpace(p + 1) ? -1 : 0;
+    }
+
+    for (;;)
+    {
+        if (*p != '"' || (p = parseString(p + 1, name, sizeof(name))) == NULL)
+        {
+            return -1;
+        }
+        p = skipSpace(p);
+        if (*p++ != ':')
+        {
+            return -1;
+        }
+        p = skipSpace(p);
+        bool quoted = *p == '"';
+        p = quoted ? parseString(p + 1, value, sizeof(value)) : parseLiteral(p, value, sizeof(value));
+        if (p == NULL)
+        {
+            return -1;
+        }
+        member(name, value, quoted);
+        p = skipSpace(p);
+        if (*p == '}')
+        {
+            break;
+        }
+        if (*p++ != ',')
+        {
+            return -1;
+        }
+        p = skipSpace(p);
+    }
+
+    return *skipSpace(p + 1) ? -1 : 0;
+}
+
+JsonWriter::JsonWriter(String& out) : _out(out), _first(true)
+{
+}
+
+void JsonWriter::begin()
+{
+    _out += "{";
+    _first = true;
+}
+
+void JsonWriter::end()
+{
+    _out += "\n}\n";
+}
+
+void JsonWriter::name(PGM_P name)
+{
+    char buf[JSON_NAME_SIZE + 8];
+    char n[JSON_NAME_SIZE];
+    strncpy_P(n, name, sizeof(n) - 1);
+    n[sizeof(n) - 1] = '\0';
+    snprintf_P(buf, sizeof(buf), PSTR("%s\n  \"%s\": "), _first ? "" : ",", n);
+    _out += buf;
+    _first = false;
+}
+
+void JsonWriter::addString(PGM_P name, const char* value)
+{
+    this->name(name);
+    char buf[32];
+    size_t len = 0;
+    buf[len++] = '"';
+    for (const char* p = value; *p; ++p)
+    {
+        // room for the longest escape
+        if (len > sizeof(buf) - 8)
+        {
+            buf[len] = '\0';
+            _out += buf;
+            len = 0;
+        }
+        uint8_t c = (uint8_t)*p;
+        if (c == '"' || c == '\\')
+        {
+            buf[len++] = '\\';
+            buf[len++] = (char)c;
+        }
+        else if (c < 0x20)
+        {
+            len += snprintf_P(&buf[len], sizeof(buf) - len, PSTR("\\u%04x"), c);
+        }
+        else
+        {
+            buf[len++] = (char)c;
+        }
+    }
+    buf[len++] = '"';
+    buf[len] = '\0';
+    _out += buf;
+}
+
+void JsonWriter::addNumber(PGM_P name, long value)
+{
+    this->name(name);
+    char buf[16];
+    snprintf_P(buf, sizeof(buf), PSTR("%ld"), value);
+    _out += buf;
+}
@@ -0,0 +1,61 @@
+/*
+ * Json.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef JSON_H_
+#define JSON_H_
+#include <Arduino.h>
+#include <functional>
+
+//
+// Just enough JSON for /config: a writer for a flat object and a reader
+// that hands back each member of a flat object as text.  Nested objects
+// and arrays are rejected, names and values longer than the buffers below
+// are syntax errors.
+//
+#define JSON_NAME_SIZE  32
+#define JSON_VALUE_SIZE 80
+
+// value is unescaped, quoted tells a string from a number/true/false/null
+typedef std::function<void(const char* name, const char* value, bool quoted)> JsonMember;
+
+class JsonReader
+{
+public:
+    static int parse(const char* json, JsonMember member);
+};
+
+class JsonWriter
+{
+public:
+    JsonWriter(String& out);
+    void begin();
+    void end();
+    void addString(PGM_P name, const char* value);
+    void addNumber(PGM_P name, long value);
+
+private:
+    void name(PGM_P name);
+    String& _out;
+    bool    _first;
+};
+
+#endif /* JSON_H_ */
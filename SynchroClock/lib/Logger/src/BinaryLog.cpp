@@ -0,0 +1,160 @@
+/*
+ * BinaryLog.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "BinaryLog.h"
+
+#ifdef LOG_BINARY
+#include <FS.h>
+
+// record addresses are relative to this so logdecode.py can find them in the ELF
+extern "C" const char binary_log_anchor[] PROGMEM = "BinaryLog";
+
+static uint32_t ring[BINARY_LOG_RING_SIZE];
+static uint32_t ring_head;     // next word to write
+static uint32_t ring_used;     // words in use
+static uint32_t ring_dropped;  // records overwritten or too big
+
+static inline uint32_t relative(const void* p)
+{
+    return (uint32_t)((uintptr_t)p - (uintptr_t)binary_log_anchor);
+}
+
+static inline void ringPut(uint32_t word)
+{
+    ring[ring_head] = word;
+    ring_head = (ring_head + 1) % BINARY_LOG_RING_SIZE;
+    ++ring_used;
+}
+
+void BinaryLog::put(Record& r, uint8_t type, const void* data, size_t size)
+{
+    size_t words = (size + 3) / 4;
+    if (r.args >= BINARY_LOG_MAX_ARGS || r.words + words > BINARY_LOG_MAX_WORDS)
+    {
+        return;
+    }
+    r.types |= (uint32_t)type << (r.args * 2);
+    r.data[r.words + words - 1] = 0;
+    memcpy(&r.data[r.words], data, size);
+    r.args  += 1;
+    r.words += words;
+}
+
+void BinaryLog::putString(Record& r, const char* s)
+{
+    uint32_t buffer[1 + (BINARY_LOG_MAX_STRING + 3) / 4];
+    uint32_t length = s != NULL ? strnlen_P(s, BINARY_LOG_MAX_STRING) : 0;
+    buffer[0] = length;
+    if (length > 0)
+    {
+        memcpy_P(&buffer[1], s, length);
+    }
+    put(r, BINARY_LOG_ARG_STRING, buffer, 4 + length);
+}
+
+void BinaryLog::append(uint8_t level, const __FlashStringHelper* tag, const __FlashStringHelper* fmt, Record& r)
+{
+    uint32_t size = BINARY_LOG_HEADER_WORDS + r.words;
+
+    // make room by dropping the oldest records
+    while (BINARY_LOG_RING_SIZE - ring_used < size)
+    {
+        uint32_t tail = (ring_head + BINARY_LOG_RING_SIZE - ring_used) % BINARY_LOG_RING_SIZE;
+        uint32_t info = ring[(tail + 3) % BINARY_LOG_RING_SIZE];
+        ring_used -= BINARY_LOG_HEADER_WORDS + (info & 0xffff);
+        ++ring_dropped;
+    }
+
+    ringPut(relative(fmt));
+    ringPut(relative(tag));
+    ringPut(micros());
+    ringPut((uint32_t)level << 24 | (uint32_t)r.args << 16 | r.words);
+    ringPut(r.types);
+    for (uint8_t i = 0; i < r.words; ++i)
+    {
+        ringPut(r.data[i]);
+    }
+}
+
+uint32_t BinaryLog::dropped()
+{
+    return ring_dropped;
+}
+
+//
+// append the ring to BINARY_LOG_FILE, when that gets too big it replaces
+// BINARY_LOG_OLD_FILE so at most two files worth of wakes are kept.
+//
+int BinaryLog::flush()
+{
+    if (ring_used == 0)
+    {
+        return 0;
+    }
+
+    if (!SPIFFS.begin())
+    {
+        return -1;
+    }
+
+    size_t size = 0;
+    File f = SPIFFS.open(BINARY_LOG_FILE, "r");
+    if (f)
+    {
+        size = f.size();
+        f.close();
+    }
+
+    if (size > 0 && size + ring_used * 4 > BINARY_LOG_FILE_MAX)
+    {
+        SPIFFS.remove(BINARY_LOG_OLD_FILE);
+        SPIFFS.rename(BINARY_LOG_FILE, BINARY_LOG_OLD_FILE);
+        size = 0;
+    }
+
+    f = SPIFFS.open(BINARY_LOG_FILE, "a");
+    if (!f)
+    {
+        return -1;
+    }
+
+    if (size == 0)
+    {
+        uint32_t header[] = { BINARY_LOG_MAGIC, BINARY_LOG_VERSION };
+        f.write((const uint8_t*)header, sizeof(header));
+    }
+
+    uint32_t wake[] = { BINARY_LOG_WAKE, ring_used * 4, ring_dropped };
+    f.write((const uint8_t*)wake, sizeof(wake));
+
+    uint32_t tail  = (ring_head + BINARY_LOG_RING_SIZE - ring_used) % BINARY_LOG_RING_SIZE;
+    uint32_t first = std::min(ring_used, BINARY_LOG_RING_SIZE - tail);
+    f.write((const uint8_t*)&ring[tail], first * 4);
+    f.write((const uint8_t*)&ring[0], (ring_used - first) * 4);
+    f.close();
+
+    ring_used    = 0;
+    ring_dropped = 0;
+    return 0;
+}
+
+#endif
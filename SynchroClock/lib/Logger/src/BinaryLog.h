@@ -0,0 +1,139 @@
+/*
+ * BinaryLog.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef BINARYLOG_H_
+#define BINARYLOG_H_
+#include <Arduino.h>
+#include <type_traits>
+
+//
+// Deferred log records: instead of formatting, a log call saves the
+// address of its format string and its raw arguments in a RAM ring that
+// flush() appends to a SPIFFS file at the end of the wake.  logdecode.py
+// formats them on the host using the firmware ELF for the strings.
+//
+// Record (32 bit words):
+//   [0] format address - binary_log_anchor
+//   [1] tag address    - binary_log_anchor
+//   [2] micros()
+//   [3] level << 24 | arg count << 16 | arg words
+//   [4] arg types, 2 bits each (BINARY_LOG_ARG_*), first arg in the low bits
+//   [5...] arg words
+//
+#define BINARY_LOG_MAGIC        0x474f4c42  // "BLOG" file header
+#define BINARY_LOG_WAKE         0x454b4157  // "WAKE" flush header
+#define BINARY_LOG_VERSION      1
+#define BINARY_LOG_FILE         "/log.bin"
+#define BINARY_LOG_OLD_FILE     "/log.old"
+#define BINARY_LOG_HEADER_WORDS 5
+#define BINARY_LOG_MAX_ARGS     16
+#define BINARY_LOG_MAX_WORDS    32          // arg words in one record
+#define BINARY_LOG_MAX_STRING   32          // %s args are truncated to this
+
+#ifndef BINARY_LOG_RING_SIZE
+#define BINARY_LOG_RING_SIZE    512         // words
+#endif
+
+#ifndef BINARY_LOG_FILE_MAX
+#define BINARY_LOG_FILE_MAX     32768       // bytes, then it is moved to BINARY_LOG_OLD_FILE
+#endif
+
+#define BINARY_LOG_ARG_32       0           // 1 word integer
+#define BINARY_LOG_ARG_64       1           // 2 word integer
+#define BINARY_LOG_ARG_DOUBLE   2           // 2 word double
+#define BINARY_LOG_ARG_STRING   3           // length word then the bytes
+
+extern "C" const char binary_log_anchor[];
+
+class BinaryLog
+{
+public:
+    template <typename... Args>
+    static void record(uint8_t level, const __FlashStringHelper* tag, const __FlashStringHelper* fmt, Args... args)
+    {
+        Record r;
+        r.args  = 0;
+        r.words = 0;
+        r.types = 0;
+        encode(r, args...);
+        append(level, tag, fmt, r);
+    }
+
+    static int      flush();
+    static uint32_t dropped();
+
+private:
+    typedef struct
+    {
+        uint8_t  args;
+        uint8_t  words;
+        uint32_t types;
+        uint32_t data[BINARY_LOG_MAX_WORDS];
+    } Record;
+
+    static void append(uint8_t level, const __FlashStringHelper* tag, const __FlashStringHelper* fmt, Record& r);
+    static void put(Record& r, uint8_t type, const void* data, size_t size);
+    static void putString(Record& r, const char* s);
+
+    static void encode(Record& r) { (void)r; }
+
+    template <typename T, typename... Args>
+    static void encode(Record& r, T value, Args... args)
+    {
+        encodeArg(r, value);
+        encode(r, args...);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type encodeArg(Record& r, T value)
+    {
+        if (sizeof(T) > 4)
+        {
+            uint64_t v = (uint64_t)value;
+            put(r, BINARY_LOG_ARG_64, &v, sizeof(v));
+        }
+        else
+        {
+            uint32_t v = (uint32_t)value;
+            put(r, BINARY_LOG_ARG_32, &v, sizeof(v));
+        }
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type encodeArg(Record& r, T value)
+    {
+        double v = (double)value;
+        put(r, BINARY_LOG_ARG_DOUBLE, &v, sizeof(v));
+    }
+
+    static void encodeArg(Record& r, const char* value)                  { putString(r, value); }
+    static void encodeArg(Record& r, const __FlashStringHelper* value)   { putString(r, (const char*)value); }
+
+    template <typename T>
+    static void encodeArg(Record& r, const T* value)
+    {
+        uint32_t v = (uint32_t)(uintptr_t)value;
+        put(r, BINARY_LOG_ARG_32, &v, sizeof(v));
+    }
+};
+
+#endif /* BINARYLOG_H_ */
@@ -24,7 +24,69 @@
 #define LOGGER_H_
 
 #include "DLog.h"
+#include "BinaryLog.h"
 
-extern DLog& dlog;
+//
+// Compile time log filtering: calls more verbose than the level of the
+// translation unit compile to nothing, format strings included.  The level
+// is LOGGER_LEVEL_MAX for the whole build, a module can pick its own by
+// defining LOGGER_LEVEL before its first include (see the <MODULE>_LOG_LEVEL
+// flags at the top of each module).
+//
+// With LOG_BINARY defined the calls that remain are recorded as
+// (format, args) by BinaryLog instead of being formatted, see logdecode.py.
+//
+#ifndef LOGGER_LEVEL_MAX
+#define LOGGER_LEVEL_MAX DLOG_LEVEL_TRACE
+#endif
+
+#ifndef LOGGER_LEVEL
+#define LOGGER_LEVEL LOGGER_LEVEL_MAX
+#endif
+
+#ifdef LOG_BINARY
+#define LOG_CALL(level, func) BinaryLog::record(level, tag, fmt, args...)
+#else
+#define LOG_CALL(level, func) DLog::getLog().func(tag, fmt, args...)
+#endif
+
+#define LOG_FUNC(level, func) \
+    template <typename... Args> \
+    void func(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, Args... args) \
+    { \
+        if (level <= LEVEL) \
+        { \
+            LOG_CALL(level, func); \
+        } \
+    }
+
+template <int LEVEL>
+class LogFilter
+{
+public:
+    void begin(DLogWriter* writer)                              { DLog::getLog().begin(writer); }
+    void setPreFunc(DLogPreFunc func)                           { DLog::getLog().setPreFunc(func); }
+    void setLevel(const __FlashStringHelper* tag, DLogLevel level) { DLog::getLog().setLevel(tag, level); }
+
+    // end of a wake (sleep or restart follows)
+    void end()
+    {
+#ifdef LOG_BINARY
+        BinaryLog::flush();
+#endif
+        DLog::getLog().end();
+    }
+
+    LOG_FUNC(DLOG_LEVEL_ERROR,   error)
+    LOG_FUNC(DLOG_LEVEL_WARNING, warning)
+    LOG_FUNC(DLOG_LEVEL_INFO,    info)
+    LOG_FUNC(DLOG_LEVEL_DEBUG,   debug)
+    LOG_FUNC(DLOG_LEVEL_TRACE,   trace)
+};
+
+#undef LOG_FUNC
+#undef LOG_CALL
+
+static LogFilter<LOGGER_LEVEL> dlog __attribute__((unused));
 
 #endif /* LOGGER_H_ */
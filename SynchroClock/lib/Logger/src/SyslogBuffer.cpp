@@ -0,0 +1,190 @@
+/*
+ * SyslogBuffer.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SyslogBuffer.h"
+
+SyslogBuffer::SyslogBuffer()
+: _used(0),
+  _dropped(0),
+  _host(NULL),
+  _port(0),
+  _name(NULL),
+  _app(NULL),
+  _resolved(false)
+{
+    _buffer = (char*)malloc(SYSLOG_BUFFER_SIZE);
+}
+
+SyslogBuffer::~SyslogBuffer()
+{
+    free(_buffer);
+}
+
+void SyslogBuffer::begin(const char* host, uint16_t port, const char* name, const char* app)
+{
+    _host     = host;
+    _port     = port;
+    _name     = name;
+    _app      = app;
+    _resolved = false;
+}
+
+void SyslogBuffer::write(const char* message)
+{
+    if (_buffer == NULL)
+    {
+        return;
+    }
+
+    // a line always fits in one datagram with the header
+    size_t size = std::min(strlen(message), (size_t)SYSLOG_PACKET_SIZE / 2);
+    bool   newline = size > 0 && message[size-1] == '\n';
+
+    if (_used + size + (newline ? 0 : 1) > SYSLOG_BUFFER_SIZE)
+    {
+        flush();
+        dropOldest(size + 1);
+    }
+
+    memcpy(_buffer + _used, message, size);
+    _used += size;
+    if (!newline)
+    {
+        _buffer[_used++] = '\n';
+    }
+}
+
+//
+// send the queued lines, as many whole lines per datagram as fit
+//
+void SyslogBuffer::flush()
+{
+    if (_used == 0 || !ready())
+    {
+        return;
+    }
+
+    char header[80];
+    size_t header_size = snprintf(header, sizeof(header), "<%d>1 - %s %s - - - ", SYSLOG_PRI, _name, _app);
+    header_size = std::min(header_size, sizeof(header) - 1);
+
+    if (_dropped)
+    {
+        char note[48];
+        size_t note_size = snprintf(note, sizeof(note), "syslog: %u lines dropped", (unsigned)_dropped);
+        if (send(header, header_size, note, note_size) == 0)
+        {
+            _dropped = 0;
+        }
+    }
+
+    size_t start = 0;
+    while (start < _used)
+    {
+        size_t end = start;
+        while (end < _used)
+        {
+            const char* nl = (const char*)memchr(_buffer + end, '\n', _used - end);
+            size_t next = nl != NULL ? nl - _buffer + 1 : _used;
+            if (end > start && header_size + next - start > SYSLOG_PACKET_SIZE)
+            {
+                break;
+            }
+            end = next;
+        }
+
+        // the last newline is implied by the end of the datagram
+        if (send(header, header_size, _buffer + start, end - start - 1))
+        {
+            break; // still can't send, keep the rest
+        }
+        start = end;
+    }
+
+    memmove(_buffer, _buffer + start, _used - start);
+    _used -= start;
+}
+
+void SyslogBuffer::end()
+{
+    flush();
+}
+
+bool SyslogBuffer::ready()
+{
+    if (_host == NULL || _port == 0 || !WiFi.isConnected())
+    {
+        return false;
+    }
+
+    if (!_resolved)
+    {
+        if (!WiFi.hostByName(_host, _address))
+        {
+            _host = NULL; // don't keep paying for the lookup
+            return false;
+        }
+        _resolved = true;
+    }
+    return true;
+}
+
+//
+// send one datagram, when the transmit buffers are full wait for them to
+// drain rather than dropping it.
+//
+int SyslogBuffer::send(const char* header, size_t header_size, const char* data, size_t size)
+{
+    uint32_t start = millis();
+    for (;;)
+    {
+        if (_udp.beginPacket(_address, _port)
+         && _udp.write((const uint8_t*)header, header_size) == header_size
+         && _udp.write((const uint8_t*)data, size) == size
+         && _udp.endPacket())
+        {
+            return 0;
+        }
+
+        if (millis() - start >= SYSLOG_SEND_TIMEOUT)
+        {
+            return -1;
+        }
+        delay(SYSLOG_SEND_RETRY);
+    }
+}
+
+//
+// make room for size bytes by dropping whole lines from the front
+//
+void SyslogBuffer::dropOldest(size_t size)
+{
+    size_t start = 0;
+    while (start < _used && _used - start + size > SYSLOG_BUFFER_SIZE)
+    {
+        const char* nl = (const char*)memchr(_buffer + start, '\n', _used - start);
+        start = nl != NULL ? nl - _buffer + 1 : _used;
+        ++_dropped;
+    }
+    memmove(_buffer, _buffer + start, _used - start);
+    _used -= start;
+}
@@ -0,0 +1,77 @@
+/*
+ * SyslogBuffer.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SYSLOGBUFFER_H_
+#define SYSLOGBUFFER_H_
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include "DLog.h"
+
+//
+// A syslog writer that sends once per wake: lines are queued in RAM from
+// the start of setup() (before WiFi is up) and flush(), called by
+// dlog.end() before sleeping, packs them into a few datagrams.  Each
+// datagram is one RFC 5424 message holding as many whole lines as fit.
+// A full transmit buffer is waited out instead of dropping the datagram,
+// and a full queue is sent early when it can be, otherwise the oldest
+// lines are dropped and counted.
+//
+#ifndef SYSLOG_BUFFER_SIZE
+#define SYSLOG_BUFFER_SIZE    4096  // bytes of queued lines
+#endif
+#define SYSLOG_PACKET_SIZE    1400  // datagram payload, under the MTU
+#define SYSLOG_SEND_TIMEOUT   500   // ms to wait for transmit buffers per datagram
+#define SYSLOG_SEND_RETRY     5     // ms between tries
+#define SYSLOG_PRI            14    // facility user, severity info
+
+class SyslogBuffer : public DLogWriter
+{
+public:
+    SyslogBuffer();
+    virtual ~SyslogBuffer();
+
+    // start sending, the strings must outlive the writer
+    void begin(const char* host, uint16_t port, const char* name, const char* app);
+
+    virtual void write(const char* message);
+    virtual void flush();
+    virtual void end();
+
+private:
+    bool   ready();
+    int    send(const char* header, size_t header_size, const char* data, size_t size);
+    void   dropOldest(size_t size);
+
+    char*       _buffer;
+    size_t      _used;
+    uint32_t    _dropped;
+    const char* _host;
+    uint16_t    _port;
+    const char* _name;
+    const char* _app;
+    IPAddress   _address;
+    bool        _resolved;
+    WiFiUDP     _udp;
+};
+
+#endif /* SYSLOGBUFFER_H_ */
@@ -0,0 +1,188 @@
+/*
+ * Metrics.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Metrics.h"
+#include <math.h>
+#include <stdarg.h>
+
+// upper bounds of all but the +Inf bucket
+static const uint32_t ntp_rtt_us[METRICS_NTP_RTT_BUCKETS-1]       PROGMEM = { 10000, 25000, 50000, 100000, 250000 };
+static const uint32_t ntp_offset_us[METRICS_NTP_OFFSET_BUCKETS-1] PROGMEM = { 1000, 5000, 20000, 50000, 200000 };
+static const uint32_t poll_s[METRICS_POLL_BUCKETS-1]              PROGMEM = { 900, 3600, 14400, 43200, 129600 };
+static const uint32_t wake_ms[METRICS_WAKE_BUCKETS-1]             PROGMEM = { 250, 500, 1000, 2500, 5000, 10000 };
+
+static void add16(uint16_t* value, uint32_t n)
+{
+    *value = (uint16_t)std::min((uint32_t)*value + n, (uint32_t)UINT16_MAX);
+}
+
+static void add32(uint32_t* value, uint32_t n)
+{
+    *value = n > UINT32_MAX - *value ? UINT32_MAX : *value + n;
+}
+
+static uint32_t toMicros(double seconds)
+{
+    double us = fabs(seconds) * 1000000.0;
+    return us >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+}
+
+static void count(uint16_t* buckets, const uint32_t* bounds, size_t size, uint32_t value)
+{
+    size_t i = 0;
+    while (i < size - 1 && value > pgm_read_dword(&bounds[i]))
+    {
+        ++i;
+    }
+    add16(&buckets[i], 1);
+}
+
+void Metrics::recordWake(MetricsData* m, uint32_t awake_ms, uint32_t free_heap)
+{
+    add32(&m->wakes, 1);
+    add32(&m->wake_ms_sum, awake_ms);
+    count(m->wake_ms, wake_ms, METRICS_WAKE_BUCKETS, awake_ms);
+    recordHeap(m, free_heap);
+}
+
+void Metrics::recordHeap(MetricsData* m, uint32_t free_heap)
+{
+    uint16_t heap = (uint16_t)std::min(free_heap, (uint32_t)UINT16_MAX);
+    if (m->heap_min == 0 || heap < m->heap_min)
+    {
+        m->heap_min = heap;
+    }
+}
+
+void Metrics::recordNTP(MetricsData* m, double offset, double delay, bool used)
+{
+    add16(&m->ntp_requests, 1);
+    if (!used)
+    {
+        add16(&m->ntp_rejected, 1);
+    }
+    add32(&m->ntp_rtt_us_sum, toMicros(delay));
+    count(m->ntp_rtt, ntp_rtt_us, METRICS_NTP_RTT_BUCKETS, toMicros(delay));
+    add32(&m->ntp_offset_us_sum, toMicros(offset));
+    count(m->ntp_offset, ntp_offset_us, METRICS_NTP_OFFSET_BUCKETS, toMicros(offset));
+}
+
+void Metrics::recordNTPFailure(MetricsData* m)
+{
+    add16(&m->ntp_requests, 1);
+    add16(&m->ntp_failures, 1);
+}
+
+void Metrics::recordPoll(MetricsData* m, uint32_t interval)
+{
+    add32(&m->poll_sum, interval);
+    count(m->poll, poll_s, METRICS_POLL_BUCKETS, interval);
+}
+
+void Metrics::recordI2C(MetricsData* m, uint16_t retries, uint16_t clear_bus)
+{
+    add16(&m->i2c_retries, retries);
+    add16(&m->i2c_clear_bus, clear_bus);
+}
+
+static void append(String& out, PGM_P fmt, ...)
+{
+    char line[128];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf_P(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    out += line;
+}
+
+//
+// the HELP and TYPE lines, name and help are copied out of flash for %s
+//
+static void header(String& out, char* name, size_t size, PGM_P name_P, PGM_P help_P, PGM_P type_P)
+{
+    char help[64];
+    char type[16];
+    strncpy_P(name, name_P, size - 1);
+    name[size - 1] = '\0';
+    strncpy_P(help, help_P, sizeof(help) - 1);
+    help[sizeof(help) - 1] = '\0';
+    strncpy_P(type, type_P, sizeof(type) - 1);
+    type[sizeof(type) - 1] = '\0';
+    append(out, PSTR("# HELP %s %s\n# TYPE %s %s\n"), name, help, name, type);
+}
+
+static void counter(String& out, PGM_P name_P, PGM_P help_P, uint32_t value)
+{
+    char name[48];
+    header(out, name, sizeof(name), name_P, help_P, PSTR("counter"));
+    append(out, PSTR("%s %u\n"), name, value);
+}
+
+static void histogram(String& out, PGM_P name_P, PGM_P help_P, const uint32_t* bounds, const uint16_t* buckets,
+                      size_t size, double scale, uint32_t sum)
+{
+    char name[48];
+    header(out, name, sizeof(name), name_P, help_P, PSTR("histogram"));
+    uint32_t total = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        total += buckets[i];
+        if (i < size - 1)
+        {
+            append(out, PSTR("%s_bucket{le=\"%g\"} %u\n"), name, pgm_read_dword(&bounds[i]) * scale, total);
+        }
+        else
+        {
+            append(out, PSTR("%s_bucket{le=\"+Inf\"} %u\n"), name, total);
+        }
+    }
+    append(out, PSTR("%s_sum %.6f\n%s_count %u\n"), name, sum * scale, name, total);
+}
+
+void Metrics::writeGauge(String& out, PGM_P name_P, PGM_P help_P, double value)
+{
+    char name[48];
+    header(out, name, sizeof(name), name_P, help_P, PSTR("gauge"));
+    append(out, PSTR("%s %.9g\n"), name, value);
+}
+
+void Metrics::write(const MetricsData* m, String& out)
+{
+    counter(out, PSTR("synchroclock_wakes_total"), PSTR("Wakes that went back to deep sleep."), m->wakes);
+    histogram(out, PSTR("synchroclock_wake_duration_seconds"), PSTR("Time from setup() to deep sleep."),
+            wake_ms, m->wake_ms, METRICS_WAKE_BUCKETS, 0.001, m->wake_ms_sum);
+    if (m->heap_min != 0)
+    {
+        writeGauge(out, PSTR("synchroclock_heap_free_min_bytes"), PSTR("Lowest free heap seen."), m->heap_min);
+    }
+    counter(out, PSTR("synchroclock_ntp_requests_total"), PSTR("NTP polls, including failures."), m->ntp_requests);
+    counter(out, PSTR("synchroclock_ntp_failures_total"), PSTR("NTP polls without an answer."), m->ntp_failures);
+    counter(out, PSTR("synchroclock_ntp_rejected_total"), PSTR("NTP answers not used by the filter."), m->ntp_rejected);
+    histogram(out, PSTR("synchroclock_ntp_rtt_seconds"), PSTR("NTP round trip delay."),
+            ntp_rtt_us, m->ntp_rtt, METRICS_NTP_RTT_BUCKETS, 0.000001, m->ntp_rtt_us_sum);
+    histogram(out, PSTR("synchroclock_ntp_offset_abs_seconds"), PSTR("Absolute NTP offset of the RTC."),
+            ntp_offset_us, m->ntp_offset, METRICS_NTP_OFFSET_BUCKETS, 0.000001, m->ntp_offset_us_sum);
+    histogram(out, PSTR("synchroclock_ntp_poll_interval_seconds"), PSTR("Sleep chosen after an NTP wake."),
+            poll_s, m->poll, METRICS_POLL_BUCKETS, 1.0, m->poll_sum);
+    counter(out, PSTR("synchroclock_i2c_retries_total"), PSTR("I2C transfers retried."), m->i2c_retries);
+    counter(out, PSTR("synchroclock_i2c_clear_bus_total"), PSTR("I2C bus clears."), m->i2c_clear_bus);
+}
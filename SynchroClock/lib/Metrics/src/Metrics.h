@@ -0,0 +1,72 @@
+/*
+ * Metrics.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+#include <Arduino.h>
+
+//
+// Counters and histograms kept in RTC memory (DeepSleepData) so they add
+// up across deep sleeps, write() formats them for /metrics in Prometheus
+// text format.  Everything is 16 or 32 bits and saturates rather than
+// wrapping, a DeepSleepData reset (power loss) starts them over which
+// Prometheus treats as a counter reset.
+//
+#define METRICS_NTP_RTT_BUCKETS    6   // 10, 25, 50, 100, 250ms, +Inf
+#define METRICS_NTP_OFFSET_BUCKETS 6   // |offset| 1, 5, 20, 50, 200ms, +Inf
+#define METRICS_POLL_BUCKETS       6   // 15m, 1h, 4h, 12h, 36h, +Inf
+#define METRICS_WAKE_BUCKETS       7   // 0.25, 0.5, 1, 2.5, 5, 10s, +Inf
+
+typedef struct metrics_data
+{
+    uint32_t wakes;                               // wakes that went back to deep sleep
+    uint32_t wake_ms_sum;
+    uint16_t wake_ms[METRICS_WAKE_BUCKETS];
+    uint16_t heap_min;                            // lowest free heap seen, 0 if none yet
+    uint16_t ntp_requests;
+    uint16_t ntp_failures;                        // no answer
+    uint16_t ntp_rejected;                        // answered but the sample was not used
+    uint32_t ntp_rtt_us_sum;
+    uint16_t ntp_rtt[METRICS_NTP_RTT_BUCKETS];
+    uint32_t ntp_offset_us_sum;
+    uint16_t ntp_offset[METRICS_NTP_OFFSET_BUCKETS];
+    uint32_t poll_sum;                            // seconds
+    uint16_t poll[METRICS_POLL_BUCKETS];
+    uint16_t i2c_retries;
+    uint16_t i2c_clear_bus;
+} MetricsData;
+
+class Metrics
+{
+public:
+    static void recordWake(MetricsData* m, uint32_t awake_ms, uint32_t free_heap);
+    static void recordHeap(MetricsData* m, uint32_t free_heap);
+    static void recordNTP(MetricsData* m, double offset, double delay, bool used);
+    static void recordNTPFailure(MetricsData* m);
+    static void recordPoll(MetricsData* m, uint32_t interval);
+    static void recordI2C(MetricsData* m, uint16_t retries, uint16_t clear_bus);
+
+    static void write(const MetricsData* m, String& out);
+    static void writeGauge(String& out, PGM_P name, PGM_P help, double value);
+};
+
+#endif /* METRICS_H_ */
@@ -5,6 +5,10 @@
  *      Author: chris.l
  */
 
+#ifdef NTP_LOG_LEVEL
+#define LOGGER_LEVEL NTP_LOG_LEVEL
+#endif
+
 #include "NTP.h"
 
 #include "NTPPrivate.h"
@@ -43,13 +47,16 @@ NTP::NTP(NTPRunTime *runtime, NTPPersist *persist, void (*savePersist)(), int fa
     _savePersist = savePersist;
     _port        = NTP_PORT;
     _factor      = factor;
+    _stratum     = 0;
+    _root_delay  = 0.0;
+    _root_dispersion = 0.0;
     dlog.debug(FPSTR(TAG), F("****** sizeof(NTPRunTime): %d"), sizeof(NTPRunTime));
 }
 
 void NTP::begin(int port)
 {
     _port   = port;
-    _udp.begin(port);
+    _udp.begin(NTP_LOCAL_PORT);
     dlog.info(FPSTR(TAG), F("::begin: nsamples: %d nadjustments: %d, drift: %f"), _runtime->nsamples, _persist->nadjustments, _persist->drift);
     if (_runtime->nsamples == 0 && _runtime->drifted == 0.0)
     {
@@ -65,6 +72,18 @@ IPAddress NTP::getAddress()
     return _runtime->ip;
 }
 
+int NTP::getServerRoot(uint8_t* stratum, double* root_delay, double* root_dispersion)
+{
+    if (_stratum == 0)
+    {
+        return -1;
+    }
+    *stratum         = _stratum;
+    *root_delay      = _root_delay;
+    *root_dispersion = _root_dispersion;
+    return 0;
+}
+
 int NTP::getLastOffset(double *offset)
 {
     if (_runtime->nsamples > 0)
@@ -75,6 +94,16 @@ int NTP::getLastOffset(double *offset)
     return -1;
 }
 
+int NTP::getLastDelay(double *delay)
+{
+    if (_runtime->nsamples > 0)
+    {
+        *delay = _runtime->samples[0].delay;
+        return 0;
+    }
+    return -1;
+}
+
 uint32_t NTP::getPollInterval()
 {
     double seconds = 3600/_factor;
@@ -136,7 +165,7 @@ uint32_t NTP::getPollInterval()
     return (uint32_t)seconds;
 }
 
-int NTP::getOffsetUsingDrift(double *offset_result, int (*getTime)(uint32_t *result))
+int NTP::getOffsetUsingDrift(double *offset_result, int (*getTime)(uint32_t *seconds, uint32_t *usec))
 {
     if (_persist->drift == 0.0)
     {
@@ -145,7 +174,7 @@ int NTP::getOffsetUsingDrift(double *offset_result, int (*getTime)(uint32_t *res
     }
 
     uint32_t now;
-    if (getTime(&now))
+    if (getTime(&now, NULL))
     {
         dlog.error(FPSTR(TAG), F("::getOffsetUsingDrift: failed to getTime() failed!"));
         return -1;
@@ -184,7 +213,7 @@ int NTP::getOffsetUsingDrift(double *offset_result, int (*getTime)(uint32_t *res
     return 0;
 }
 
-int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *result))
+int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *seconds, uint32_t *usec))
 {
     Timer timer;
     NTPTime now;
@@ -195,16 +224,18 @@ int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t
     ntp.poll  = MINPOLL;
 
     uint32_t start;
-    if (getTime(&start))
+    uint32_t start_us;
+    if (getTime(&start, &start_us))
     {
         dlog.error(FPSTR(TAG), F("::makeRequest: failed to getTime() failed!"));
         return -1;
     }
+    uint32_t start_micros = micros();
 
     timer.start();
 
-    now.seconds = toNTP(start);
-    now.fraction = 0;
+    now.seconds  = toNTP(start);
+    now.fraction = us2fraction(start_us);
 
     ntp.orig_time = now;
 
@@ -220,7 +251,15 @@ int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t
     memset(&ntp, 0, sizeof(ntp));
 
     int size = _udp.recv(&ntp, sizeof(ntp), 1000);
+
+    //
+    // the receive time is the transmit time plus the micros() since, calling
+    // getTime() again could re-sync its clock (and wait) before the stamp.
+    //
+    uint32_t elapsed_us = micros() - start_micros;
     uint32_t duration = timer.stop();
+    uint32_t end      = start + (start_us + elapsed_us) / 1000000;
+    uint32_t end_us   = (start_us + elapsed_us) % 1000000;
 
     dlog.info(FPSTR(TAG), F("::makeRequest: used server: %s address: %s"), _runtime->server, address.toString().c_str());
     dlog.info(FPSTR(TAG), F("::makeRequest: packet size: %d"), size);
@@ -244,10 +283,8 @@ int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t
 
     dumpNTPPacket(&ntp, "makeRequest");
 
-    //
-    // assumes start at second start and less than 1 second duration
-    //
-    now.fraction = ms2fraction(duration);
+    now.seconds  = toNTP(end);
+    now.fraction = us2fraction(end_us);
 
     if (ntp.stratum == 0)
     {
@@ -279,10 +316,14 @@ int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t
         dlog.error(FPSTR(TAG), F("::makeRequest: delay (%0.6lf) less than 0!"), *delay);
         return -1;
     }
+
+    _stratum         = ntp.stratum;
+    _root_delay      = FP2D(ntp.delay);
+    _root_dispersion = FP2D(ntp.dispersion);
     return 0;
 }
 
-int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *result), const unsigned int bestof)
+int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *seconds, uint32_t *usec), const unsigned int bestof)
 {
     double this_offset;
     double this_delay;
@@ -309,7 +350,7 @@ int NTP::makeRequest(IPAddress address, double *offset, double *delay, uint32_t
 
 
 // return 0 on success or -1 on error.
-int NTP::getOffset(const char* server, double *offsetp, int (*getTime)(uint32_t *result))
+int NTP::getOffset(const char* server, double *offsetp, int (*getTime)(uint32_t *seconds, uint32_t *usec))
 {
     _runtime->reach <<= 1;
 
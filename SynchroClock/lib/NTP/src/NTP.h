@@ -15,6 +15,9 @@
 #include "Logger.h"
 
 #define NTP_PORT 123
+#ifndef NTP_LOCAL_PORT
+#define NTP_LOCAL_PORT 0 // requests go out from any free port, NTP_PORT is left for NTPServer
+#endif
 
 #ifndef NTP_REQUEST_COUNT
 #define NTP_REQUEST_COUNT 1
@@ -113,14 +116,17 @@ public:
     void begin(int port = NTP_PORT);
 
     uint32_t getPollInterval();
-    int getOffsetUsingDrift(double *offset, int (*getTime)(uint32_t *result));
+    int getOffsetUsingDrift(double *offset, int (*getTime)(uint32_t *seconds, uint32_t *usec));
     // return next poll delay or -1 on error.
-    int getOffset(const char* server, double* offset, int (*getTime)(uint32_t *result));
+    int getOffset(const char* server, double* offset, int (*getTime)(uint32_t *seconds, uint32_t *usec));
     int getLastOffset(double* offset);
+    int getLastDelay(double* delay);
+    // the server's stratum, root delay & root dispersion from its last good reply
+    int getServerRoot(uint8_t* stratum, double* root_delay, double* root_dispersion);
     IPAddress getAddress();
 protected:
-    int  makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *result));
-    int  makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *result), const unsigned int bestof);
+    int  makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *seconds, uint32_t *usec));
+    int  makeRequest(IPAddress address, double *offset, double *delay, uint32_t *timestamp, int (*getTime)(uint32_t *seconds, uint32_t *usec), const unsigned int bestof);
     int  process(uint32_t timestamp, double offset, double delay);
     void clock();
     void computeDrift(double* drift_result);
@@ -132,6 +138,9 @@ private:
     UDPWrapper _udp;
     int        _port;
     int        _factor; // only used when testing to reduce fixed poll interval values by factor
+    uint8_t    _stratum; // from the last good reply, 0 if none since boot
+    double     _root_delay;
+    double     _root_dispersion;
 };
 
 
@@ -42,8 +42,10 @@
 #define toUINT64(x)     (((uint64_t)(x.seconds)<<32) + x.fraction)
 
 #define FP2D(x)         ((double)(x)/65536)
+#define D2FP(x)         ((uint32_t)((x) * 65536.0))
 #define LFP2D(x)        (((double)(x))/4294967296L)
 #define ms2fraction(x)  ((uint32_t)((double)(x) / 1000.0 * (double)4294967296L))
+#define us2fraction(x)  ((uint32_t)((double)(x) / 1000000.0 * (double)4294967296L))
 #define LOG2D(a)        ((a) < 0 ? 1. / (1L << -(a)) : 1L << (a))
 #define SQUARE(x)       ((x) * (x))
 #define SQRT(x)         (sqrt(x))
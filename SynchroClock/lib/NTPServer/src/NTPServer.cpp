@@ -0,0 +1,182 @@
+/*
+ * NTPServer.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef NTPSERVER_LOG_LEVEL
+#define LOGGER_LEVEL NTPSERVER_LOG_LEVEL
+#endif
+
+#include "NTPServer.h"
+#include "NTPPrivate.h"
+#ifdef ESP8266
+#include <lwip/def.h> // htonl() & ntohl()
+#endif
+
+static PROGMEM const char TAG[] = "NTPServer";
+
+static NTPTime hton(NTPTime time)
+{
+    time.seconds  = htonl(time.seconds);
+    time.fraction = htonl(time.fraction);
+    return time;
+}
+
+NTPServer::NTPServer(int (*getTime)(uint32_t *seconds, uint32_t *usec))
+{
+    _getTime         = getTime;
+    _running         = false;
+    _stratum         = 0;
+    _root_delay      = 0.0;
+    _root_dispersion = 0.0;
+    _requests        = 0;
+    _replies         = 0;
+    memset(_ref_id, 0, sizeof(_ref_id));
+    memset(&_ref_time, 0, sizeof(_ref_time));
+}
+
+void NTPServer::begin(int port)
+{
+    dlog.info(FPSTR(TAG), F("::begin: port: %d"), port);
+    _udp.begin(port);
+    _running = true;
+}
+
+void NTPServer::setReference(IPAddress server, uint8_t stratum, double root_delay, double root_dispersion,
+                             uint32_t seconds, uint32_t usec)
+{
+    uint32_t address = server;
+    memcpy(_ref_id, &address, sizeof(_ref_id));
+    _stratum           = stratum;
+    _root_delay        = root_delay;
+    _root_dispersion   = root_dispersion;
+    _ref_time.seconds  = toNTP(seconds);
+    _ref_time.fraction = us2fraction(usec);
+    dlog.info(FPSTR(TAG), F("::setReference: stratum: %u root delay: %0.6lf root dispersion: %0.6lf"),
+            stratum, root_delay, root_dispersion);
+}
+
+//
+// answer every request that is waiting, the receive time is taken as soon
+// as each one is read so it only misses how long it sat in the queue.
+//
+int NTPServer::handle(unsigned int timeout_ms)
+{
+    if (!_running)
+    {
+        return 0;
+    }
+
+    int       answered = 0;
+    NTPPacket packet;
+    IPAddress address;
+    uint16_t  port;
+    int       size;
+    while ((size = _udp.recvFrom(&packet, sizeof(packet), &address, &port, timeout_ms)) > 0)
+    {
+        timeout_ms = 0;
+        NTPTime recv;
+        if (now(&recv))
+        {
+            dlog.error(FPSTR(TAG), F("::handle: getTime() failed!"));
+            break;
+        }
+        ++_requests;
+
+        if (size < (int)sizeof(packet) || getMODE(packet.flags) != MODE_CLIENT)
+        {
+            dlog.debug(FPSTR(TAG), F("::handle: ignoring size: %d mode: %u"), size, getMODE(packet.flags));
+            continue;
+        }
+
+        reply(&packet, recv);
+
+        NTPTime xmit;
+        if (now(&xmit))
+        {
+            dlog.error(FPSTR(TAG), F("::handle: getTime() failed!"));
+            break;
+        }
+        packet.xmit_time = hton(xmit);
+
+        if (_udp.sendTo(address, port, &packet, sizeof(packet)) != (int)sizeof(packet))
+        {
+            dlog.error(FPSTR(TAG), F("::handle: failed to reply to %s:%u!"), address.toString().c_str(), port);
+            continue;
+        }
+        ++_replies;
+        ++answered;
+        dlog.debug(FPSTR(TAG), F("::handle: replied to %s:%u stratum: %u"), address.toString().c_str(), port, packet.stratum);
+    }
+    return answered;
+}
+
+uint32_t NTPServer::getRequests()
+{
+    return _requests;
+}
+
+uint32_t NTPServer::getReplies()
+{
+    return _replies;
+}
+
+int NTPServer::now(NTPTime* time)
+{
+    uint32_t seconds;
+    uint32_t usec;
+    if (_getTime(&seconds, &usec))
+    {
+        return -1;
+    }
+    time->seconds  = toNTP(seconds);
+    time->fraction = us2fraction(usec);
+    return 0;
+}
+
+//
+// the upstream dispersion plus what our clock can have drifted since it was
+// set and how well we can read it.
+//
+double NTPServer::rootDispersion(NTPTime now)
+{
+    double age = LFP2D((int64_t)(toUINT64(now) - toUINT64(_ref_time)));
+    return _root_dispersion + LOG2D(NTP_SERVER_PRECISION) + NTP_SERVER_PHI * (age > 0.0 ? age : 0.0);
+}
+
+//
+// turn a client request into the reply, all but the transmit time.  The
+// version and poll are the client's.
+//
+void NTPServer::reply(NTPPacket* packet, NTPTime recv)
+{
+    double dispersion = rootDispersion(recv);
+    bool   synced     = _stratum != 0 && _stratum < NTP_SERVER_MAX_STRATUM && dispersion < NTP_SERVER_MAX_DISPERSION;
+
+    packet->flags      = setLI(synced ? LI_NONE : LI_NOSYNC) | setVERS(getVERS(packet->flags)) | setMODE(MODE_SERVER);
+    packet->stratum    = synced ? _stratum + 1 : NTP_SERVER_UNSYNC_STRATUM;
+    packet->precision  = NTP_SERVER_PRECISION;
+    packet->delay      = htonl(D2FP(_root_delay));
+    packet->dispersion = htonl(D2FP(dispersion));
+    memcpy(packet->ref_id, _ref_id, sizeof(packet->ref_id));
+    packet->ref_time   = hton(_ref_time);
+    packet->orig_time  = packet->xmit_time; // still in network order
+    packet->recv_time  = hton(recv);
+}
@@ -0,0 +1,71 @@
+/*
+ * NTPServer.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef NTPSERVER_H_
+#define NTPSERVER_H_
+
+#include "NTP.h"
+#include "Logger.h"
+
+//
+// Answers NTP clients from a clock that NTP keeps set, the RTC plus the
+// sub-second timebase here, so one stay awake clock can serve the others on
+// the LAN.  Replies have the upstream server's stratum + 1 and add this hop
+// to its root delay & dispersion.  The dispersion grows at NTP_SERVER_PHI
+// from when the reference was last set, past NTP_SERVER_MAX_DISPERSION (or
+// before there is a reference) replies are marked unsynchronized.
+//
+#define NTP_SERVER_PRECISION      -16    // log2 seconds, ~15us, timebase reads are micros() from an RTC edge
+#define NTP_SERVER_PHI            15e-6  // frequency tolerance (RFC 5905), covers the DS3231 and its aging
+#define NTP_SERVER_MAX_DISPERSION 16.0   // seconds (RFC 5905 MAXDISP)
+#define NTP_SERVER_MAX_STRATUM    15     // highest stratum we reply as
+#define NTP_SERVER_UNSYNC_STRATUM 16
+
+class NTPServer
+{
+public:
+    NTPServer(int (*getTime)(uint32_t *seconds, uint32_t *usec));
+    void     begin(int port = NTP_PORT);
+    // the local clock was set from this server at seconds.usec
+    void     setReference(IPAddress server, uint8_t stratum, double root_delay, double root_dispersion,
+                          uint32_t seconds, uint32_t usec);
+    int      handle(unsigned int timeout_ms = 0); // answer requests, waiting timeout_ms for the first, returns how many
+    uint32_t getRequests();
+    uint32_t getReplies();
+protected:
+    int      now(NTPTime* time);
+    double   rootDispersion(NTPTime now);
+    void     reply(NTPPacket* packet, NTPTime recv);
+private:
+    int      (*_getTime)(uint32_t *seconds, uint32_t *usec);
+    UDPWrapper _udp;
+    bool       _running;
+    uint8_t    _ref_id[4];       // upstream server's IPv4 address
+    uint8_t    _stratum;         // upstream server's, 0 until setReference()
+    double     _root_delay;      // seconds
+    double     _root_dispersion; // seconds, when the reference was set
+    NTPTime    _ref_time;
+    uint32_t   _requests;
+    uint32_t   _replies;
+};
+
+#endif /* NTPSERVER_H_ */
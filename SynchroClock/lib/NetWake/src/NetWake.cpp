@@ -0,0 +1,133 @@
+/*
+ * NetWake.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef NETWAKE_LOG_LEVEL
+#define LOGGER_LEVEL NETWAKE_LOG_LEVEL
+#endif
+
+#include "NetWake.h"
+#include <ESP8266WiFi.h>
+#include <lwip/netif.h>
+
+extern "C" void esp_schedule();
+
+static PROGMEM const char TAG[] = "NetWake";
+
+static netif_input_fn lwip_input;
+static uint32_t       wakes;
+static uint32_t       timeouts;
+static volatile bool  idling;   // in idle()'s delay(), a frame may end it
+static volatile bool  received; // a frame came in since the last idle()
+
+//
+// lwIP gets the frame first so the accept or data is queued for the
+// server before loop() runs again.  Ending delay() is just scheduling the
+// loop task, it is safe from here.  Only idle()'s delay() is ended, the
+// core's own waits (hostByName(), connect()) count on nothing else
+// scheduling the loop task while they delay().
+//
+static err_t wakeInput(struct pbuf* p, struct netif* inp)
+{
+    err_t err = lwip_input(p, inp);
+    received = true;
+    if (idling)
+    {
+        esp_schedule();
+    }
+    return err;
+}
+
+//
+// hook the station interface and turn on automatic light sleep, call once
+// WiFi is connected.  Without light_sleep the radio stays on instead.
+//
+int NetWake::begin(uint8_t listen_interval, bool light_sleep)
+{
+    if (netif_default == NULL)
+    {
+        dlog.error(FPSTR(TAG), F("::begin: no network interface!"));
+        return -1;
+    }
+
+    if (lwip_input == NULL)
+    {
+        lwip_input           = netif_default->input;
+        netif_default->input = wakeInput;
+    }
+
+    if (!light_sleep)
+    {
+        if (!WiFi.setSleepMode(WIFI_NONE_SLEEP))
+        {
+            dlog.warning(FPSTR(TAG), F("::begin: failed to turn off sleep"));
+        }
+        dlog.info(FPSTR(TAG), F("::begin: no sleep"));
+        return 0;
+    }
+
+    if (!WiFi.setSleepMode(WIFI_LIGHT_SLEEP, listen_interval))
+    {
+        dlog.warning(FPSTR(TAG), F("::begin: failed to set light sleep, listen interval %u"), listen_interval);
+    }
+
+    dlog.info(FPSTR(TAG), F("::begin: light sleep, listen interval %u"), listen_interval);
+    return 0;
+}
+
+//
+// delay() returns as soon as the loop task is scheduled, which is what
+// wakeInput() does while we are idling.  A frame that came in since the
+// last idle may not have been handled yet, don't wait at all then.
+//
+void NetWake::idle(uint32_t max_ms)
+{
+    uint32_t start = millis();
+    idling = true;
+    if (received)
+    {
+        received = false;
+        idling   = false;
+        ++wakes;
+        return;
+    }
+    delay(max_ms);
+    idling   = false;
+    received = false;
+    if (millis() - start < max_ms)
+    {
+        ++wakes;
+    }
+    else
+    {
+        ++timeouts;
+    }
+}
+
+uint32_t NetWake::getWakes()
+{
+    return wakes;
+}
+
+uint32_t NetWake::getTimeouts()
+{
+    return timeouts;
+}
@@ -0,0 +1,49 @@
+/*
+ * NetWake.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef NETWAKE_H_
+#define NETWAKE_H_
+#include <Arduino.h>
+#include "Logger.h"
+
+//
+// Lets loop() idle in a long delay() between http requests and still answer
+// them right away: every frame lwIP receives ends the idle early.  While we
+// idle the station is in automatic light sleep, the SDK stops the CPU and
+// the radio between the DTIM beacons it wakes for, frames the access point
+// buffered for us arrive on those wake ups.  That can hold a frame for a
+// beacon interval or more, begin() without light sleep keeps the radio on
+// for things that can't wait like answering NTP.
+//
+#define NET_WAKE_LISTEN_INTERVAL 0     // wake for each DTIM beacon, 1-10 for every Nth beacon
+#define NET_WAKE_IDLE_MS         1000  // longest idle, for the work loop() does on its own
+
+class NetWake
+{
+public:
+    static int      begin(uint8_t listen_interval, bool light_sleep = true);
+    static void     idle(uint32_t max_ms);
+    static uint32_t getWakes();     // idles ended by a frame
+    static uint32_t getTimeouts();  // idles that ran to max_ms
+};
+
+#endif /* NETWAKE_H_ */
@@ -0,0 +1,74 @@
+/*
+ * TZData.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "TZData.h"
+
+//
+// binary search the zones (sorted by name) for the given name, returns 0 and
+// fills in zone if found, -1 if not.
+//
+int TZData::find(const char* name, TimeZone* zone)
+{
+    uint16_t lo = 0;
+    uint16_t hi = tz_zone_count;
+    while (lo < hi)
+    {
+        uint16_t mid = (lo + hi) / 2;
+        TimeZone tz;
+        memcpy_P(&tz, &tz_zones[mid], sizeof(TimeZone));
+        int cmp = strcmp_P(name, tz.name);
+        if (cmp == 0)
+        {
+            *zone = tz;
+            return 0;
+        }
+        if (cmp < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return -1;
+}
+
+int TZData::get(uint16_t index, TimeZone* zone)
+{
+    if (index >= tz_zone_count)
+    {
+        return -1;
+    }
+    memcpy_P(zone, &tz_zones[index], sizeof(TimeZone));
+    return 0;
+}
+
+uint16_t TZData::count()
+{
+    return tz_zone_count;
+}
+
+const char* TZData::version()
+{
+    return tz_version;
+}
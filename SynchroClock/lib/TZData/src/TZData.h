@@ -0,0 +1,45 @@
+/*
+ * TZData.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef TZDATA_H_
+#define TZDATA_H_
+#include <Arduino.h>
+#include "TimeUtils.h"
+
+//
+// Time zones compiled from tzdata by mktz.py, the tables themselves are
+// generated into TZZones.cpp.
+//
+extern const char     tz_version[] PROGMEM;
+extern const TimeZone tz_zones[] PROGMEM;
+extern const uint16_t tz_zone_count;
+
+class TZData
+{
+public:
+    static int         find(const char* name, TimeZone* zone);
+    static int         get(uint16_t index, TimeZone* zone);
+    static uint16_t    count();
+    static const char* version();
+};
+
+#endif /* TZDATA_H_ */
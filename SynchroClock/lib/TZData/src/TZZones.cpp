@@ -0,0 +1,410 @@
+/*
+ * TZZones.cpp
+ *
+ * Generated by mktz.py from tzdata 2025b for 2024 thru 2037 - DO NOT EDIT!
+ */
+
+#include "TZData.h"
+
+const char tz_version[] PROGMEM = "2025b";
+
+// Africa/Casablanca
+static const char     tz_Africa_Casablanca_name[] PROGMEM = "Africa/Casablanca";
+static const uint32_t tz_Africa_Casablanca_times[] PROGMEM = {
+    1710036000, 1713060000, 1740276000, 1743904800, 1771120800, 1774144800,
+    1801965600, 1804989600, 1832205600, 1835834400, 1863050400, 1866074400,
+    1893290400, 1896919200, 1924135200, 1927159200, 1954980000, 1958004000,
+    1985220000, 1988848800, 2016064800, 2019088800, 2046304800, 2049933600,
+    2077149600, 2080778400, 2107994400, 2111018400, 2138234400, 2141863200,
+};
+static const int16_t  tz_Africa_Casablanca_offsets[] PROGMEM = {
+    60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0,
+    60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0,
+    60, 0, 60, 0, 60, 0, 60,
+};
+
+// America/Anchorage
+static const char     tz_America_Anchorage_name[] PROGMEM = "America/Anchorage";
+static const uint32_t tz_America_Anchorage_times[] PROGMEM = {
+    1710068400, 1730628000, 1741518000, 1762077600, 1772967600, 1793527200,
+    1805022000, 1825581600, 1836471600, 1857031200, 1867921200, 1888480800,
+    1899370800, 1919930400, 1930820400, 1951380000, 1962874800, 1983434400,
+    1994324400, 2014884000, 2025774000, 2046333600, 2057223600, 2077783200,
+    2088673200, 2109232800, 2120122800, 2140682400,
+};
+static const int16_t  tz_America_Anchorage_offsets[] PROGMEM = {
+    -540, -480, -540, -480, -540, -480, -540, -480, -540, -480, -540, -480,
+    -540, -480, -540, -480, -540, -480, -540, -480, -540, -480, -540, -480,
+    -540, -480, -540, -480, -540,
+};
+
+// America/Chicago
+static const char     tz_America_Chicago_name[] PROGMEM = "America/Chicago";
+static const uint32_t tz_America_Chicago_times[] PROGMEM = {
+    1710057600, 1730617200, 1741507200, 1762066800, 1772956800, 1793516400,
+    1805011200, 1825570800, 1836460800, 1857020400, 1867910400, 1888470000,
+    1899360000, 1919919600, 1930809600, 1951369200, 1962864000, 1983423600,
+    1994313600, 2014873200, 2025763200, 2046322800, 2057212800, 2077772400,
+    2088662400, 2109222000, 2120112000, 2140671600,
+};
+static const int16_t  tz_America_Chicago_offsets[] PROGMEM = {
+    -360, -300, -360, -300, -360, -300, -360, -300, -360, -300, -360, -300,
+    -360, -300, -360, -300, -360, -300, -360, -300, -360, -300, -360, -300,
+    -360, -300, -360, -300, -360,
+};
+
+// America/Denver
+static const char     tz_America_Denver_name[] PROGMEM = "America/Denver";
+static const uint32_t tz_America_Denver_times[] PROGMEM = {
+    1710061200, 1730620800, 1741510800, 1762070400, 1772960400, 1793520000,
+    1805014800, 1825574400, 1836464400, 1857024000, 1867914000, 1888473600,
+    1899363600, 1919923200, 1930813200, 1951372800, 1962867600, 1983427200,
+    1994317200, 2014876800, 2025766800, 2046326400, 2057216400, 2077776000,
+    2088666000, 2109225600, 2120115600, 2140675200,
+};
+static const int16_t  tz_America_Denver_offsets[] PROGMEM = {
+    -420, -360, -420, -360, -420, -360, -420, -360, -420, -360, -420, -360,
+    -420, -360, -420, -360, -420, -360, -420, -360, -420, -360, -420, -360,
+    -420, -360, -420, -360, -420,
+};
+
+// America/Halifax
+static const char     tz_America_Halifax_name[] PROGMEM = "America/Halifax";
+static const uint32_t tz_America_Halifax_times[] PROGMEM = {
+    1710050400, 1730610000, 1741500000, 1762059600, 1772949600, 1793509200,
+    1805004000, 1825563600, 1836453600, 1857013200, 1867903200, 1888462800,
+    1899352800, 1919912400, 1930802400, 1951362000, 1962856800, 1983416400,
+    1994306400, 2014866000, 2025756000, 2046315600, 2057205600, 2077765200,
+    2088655200, 2109214800, 2120104800, 2140664400,
+};
+static const int16_t  tz_America_Halifax_offsets[] PROGMEM = {
+    -240, -180, -240, -180, -240, -180, -240, -180, -240, -180, -240, -180,
+    -240, -180, -240, -180, -240, -180, -240, -180, -240, -180, -240, -180,
+    -240, -180, -240, -180, -240,
+};
+
+// America/Los_Angeles
+static const char     tz_America_Los_Angeles_name[] PROGMEM = "America/Los_Angeles";
+static const uint32_t tz_America_Los_Angeles_times[] PROGMEM = {
+    1710064800, 1730624400, 1741514400, 1762074000, 1772964000, 1793523600,
+    1805018400, 1825578000, 1836468000, 1857027600, 1867917600, 1888477200,
+    1899367200, 1919926800, 1930816800, 1951376400, 1962871200, 1983430800,
+    1994320800, 2014880400, 2025770400, 2046330000, 2057220000, 2077779600,
+    2088669600, 2109229200, 2120119200, 2140678800,
+};
+static const int16_t  tz_America_Los_Angeles_offsets[] PROGMEM = {
+    -480, -420, -480, -420, -480, -420, -480, -420, -480, -420, -480, -420,
+    -480, -420, -480, -420, -480, -420, -480, -420, -480, -420, -480, -420,
+    -480, -420, -480, -420, -480,
+};
+
+// America/Mexico_City
+static const char     tz_America_Mexico_City_name[] PROGMEM = "America/Mexico_City";
+static const int16_t  tz_America_Mexico_City_offsets[] PROGMEM = {
+    -360,
+};
+
+// America/New_York
+static const char     tz_America_New_York_name[] PROGMEM = "America/New_York";
+static const uint32_t tz_America_New_York_times[] PROGMEM = {
+    1710054000, 1730613600, 1741503600, 1762063200, 1772953200, 1793512800,
+    1805007600, 1825567200, 1836457200, 1857016800, 1867906800, 1888466400,
+    1899356400, 1919916000, 1930806000, 1951365600, 1962860400, 1983420000,
+    1994310000, 2014869600, 2025759600, 2046319200, 2057209200, 2077768800,
+    2088658800, 2109218400, 2120108400, 2140668000,
+};
+static const int16_t  tz_America_New_York_offsets[] PROGMEM = {
+    -300, -240, -300, -240, -300, -240, -300, -240, -300, -240, -300, -240,
+    -300, -240, -300, -240, -300, -240, -300, -240, -300, -240, -300, -240,
+    -300, -240, -300, -240, -300,
+};
+
+// America/Phoenix
+static const char     tz_America_Phoenix_name[] PROGMEM = "America/Phoenix";
+static const int16_t  tz_America_Phoenix_offsets[] PROGMEM = {
+    -420,
+};
+
+// America/Santiago
+static const char     tz_America_Santiago_name[] PROGMEM = "America/Santiago";
+static const uint32_t tz_America_Santiago_times[] PROGMEM = {
+    1712458800, 1725768000, 1743908400, 1757217600, 1775358000, 1788667200,
+    1806807600, 1820116800, 1838257200, 1851566400, 1870311600, 1883016000,
+    1901761200, 1915070400, 1933210800, 1946520000, 1964660400, 1977969600,
+    1996110000, 2009419200, 2027559600, 2040868800, 2059614000, 2072318400,
+    2091063600, 2104372800, 2122513200, 2135822400,
+};
+static const int16_t  tz_America_Santiago_offsets[] PROGMEM = {
+    -180, -240, -180, -240, -180, -240, -180, -240, -180, -240, -180, -240,
+    -180, -240, -180, -240, -180, -240, -180, -240, -180, -240, -180, -240,
+    -180, -240, -180, -240, -180,
+};
+
+// America/Sao_Paulo
+static const char     tz_America_Sao_Paulo_name[] PROGMEM = "America/Sao_Paulo";
+static const int16_t  tz_America_Sao_Paulo_offsets[] PROGMEM = {
+    -180,
+};
+
+// America/St_Johns
+static const char     tz_America_St_Johns_name[] PROGMEM = "America/St_Johns";
+static const uint32_t tz_America_St_Johns_times[] PROGMEM = {
+    1710048600, 1730608200, 1741498200, 1762057800, 1772947800, 1793507400,
+    1805002200, 1825561800, 1836451800, 1857011400, 1867901400, 1888461000,
+    1899351000, 1919910600, 1930800600, 1951360200, 1962855000, 1983414600,
+    1994304600, 2014864200, 2025754200, 2046313800, 2057203800, 2077763400,
+    2088653400, 2109213000, 2120103000, 2140662600,
+};
+static const int16_t  tz_America_St_Johns_offsets[] PROGMEM = {
+    -210, -150, -210, -150, -210, -150, -210, -150, -210, -150, -210, -150,
+    -210, -150, -210, -150, -210, -150, -210, -150, -210, -150, -210, -150,
+    -210, -150, -210, -150, -210,
+};
+
+// Asia/Bangkok
+static const char     tz_Asia_Bangkok_name[] PROGMEM = "Asia/Bangkok";
+static const int16_t  tz_Asia_Bangkok_offsets[] PROGMEM = {
+    420,
+};
+
+// Asia/Dubai
+static const char     tz_Asia_Dubai_name[] PROGMEM = "Asia/Dubai";
+static const int16_t  tz_Asia_Dubai_offsets[] PROGMEM = {
+    240,
+};
+
+// Asia/Jerusalem
+static const char     tz_Asia_Jerusalem_name[] PROGMEM = "Asia/Jerusalem";
+static const uint32_t tz_Asia_Jerusalem_times[] PROGMEM = {
+    1711670400, 1729983600, 1743120000, 1761433200, 1774569600, 1792882800,
+    1806019200, 1824937200, 1837468800, 1856386800, 1868918400, 1887836400,
+    1900972800, 1919286000, 1932422400, 1950735600, 1963872000, 1982790000,
+    1995321600, 2014239600, 2026771200, 2045689200, 2058220800, 2077138800,
+    2090275200, 2108588400, 2121724800, 2140038000,
+};
+static const int16_t  tz_Asia_Jerusalem_offsets[] PROGMEM = {
+    120, 180, 120, 180, 120, 180, 120, 180, 120, 180, 120, 180,
+    120, 180, 120, 180, 120, 180, 120, 180, 120, 180, 120, 180,
+    120, 180, 120, 180, 120,
+};
+
+// Asia/Kolkata
+static const char     tz_Asia_Kolkata_name[] PROGMEM = "Asia/Kolkata";
+static const int16_t  tz_Asia_Kolkata_offsets[] PROGMEM = {
+    330,
+};
+
+// Asia/Shanghai
+static const char     tz_Asia_Shanghai_name[] PROGMEM = "Asia/Shanghai";
+static const int16_t  tz_Asia_Shanghai_offsets[] PROGMEM = {
+    480,
+};
+
+// Asia/Tehran
+static const char     tz_Asia_Tehran_name[] PROGMEM = "Asia/Tehran";
+static const int16_t  tz_Asia_Tehran_offsets[] PROGMEM = {
+    210,
+};
+
+// Asia/Tokyo
+static const char     tz_Asia_Tokyo_name[] PROGMEM = "Asia/Tokyo";
+static const int16_t  tz_Asia_Tokyo_offsets[] PROGMEM = {
+    540,
+};
+
+// Australia/Adelaide
+static const char     tz_Australia_Adelaide_name[] PROGMEM = "Australia/Adelaide";
+static const uint32_t tz_Australia_Adelaide_times[] PROGMEM = {
+    1712421000, 1728145800, 1743870600, 1759595400, 1775320200, 1791045000,
+    1806769800, 1822494600, 1838219400, 1853944200, 1869669000, 1885998600,
+    1901723400, 1917448200, 1933173000, 1948897800, 1964622600, 1980347400,
+    1996072200, 2011797000, 2027521800, 2043246600, 2058971400, 2075301000,
+    2091025800, 2106750600, 2122475400, 2138200200,
+};
+static const int16_t  tz_Australia_Adelaide_offsets[] PROGMEM = {
+    630, 570, 630, 570, 630, 570, 630, 570, 630, 570, 630, 570,
+    630, 570, 630, 570, 630, 570, 630, 570, 630, 570, 630, 570,
+    630, 570, 630, 570, 630,
+};
+
+// Australia/Perth
+static const char     tz_Australia_Perth_name[] PROGMEM = "Australia/Perth";
+static const int16_t  tz_Australia_Perth_offsets[] PROGMEM = {
+    480,
+};
+
+// Australia/Sydney
+static const char     tz_Australia_Sydney_name[] PROGMEM = "Australia/Sydney";
+static const uint32_t tz_Australia_Sydney_times[] PROGMEM = {
+    1712419200, 1728144000, 1743868800, 1759593600, 1775318400, 1791043200,
+    1806768000, 1822492800, 1838217600, 1853942400, 1869667200, 1885996800,
+    1901721600, 1917446400, 1933171200, 1948896000, 1964620800, 1980345600,
+    1996070400, 2011795200, 2027520000, 2043244800, 2058969600, 2075299200,
+    2091024000, 2106748800, 2122473600, 2138198400,
+};
+static const int16_t  tz_Australia_Sydney_offsets[] PROGMEM = {
+    660, 600, 660, 600, 660, 600, 660, 600, 660, 600, 660, 600,
+    660, 600, 660, 600, 660, 600, 660, 600, 660, 600, 660, 600,
+    660, 600, 660, 600, 660,
+};
+
+// Europe/Athens
+static const char     tz_Europe_Athens_name[] PROGMEM = "Europe/Athens";
+static const uint32_t tz_Europe_Athens_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_Athens_offsets[] PROGMEM = {
+    120, 180, 120, 180, 120, 180, 120, 180, 120, 180, 120, 180,
+    120, 180, 120, 180, 120, 180, 120, 180, 120, 180, 120, 180,
+    120, 180, 120, 180, 120,
+};
+
+// Europe/Berlin
+static const char     tz_Europe_Berlin_name[] PROGMEM = "Europe/Berlin";
+static const uint32_t tz_Europe_Berlin_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_Berlin_offsets[] PROGMEM = {
+    60, 120, 60, 120, 60, 120, 60, 120, 60, 120, 60, 120,
+    60, 120, 60, 120, 60, 120, 60, 120, 60, 120, 60, 120,
+    60, 120, 60, 120, 60,
+};
+
+// Europe/Dublin
+static const char     tz_Europe_Dublin_name[] PROGMEM = "Europe/Dublin";
+static const uint32_t tz_Europe_Dublin_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_Dublin_offsets[] PROGMEM = {
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0,
+};
+
+// Europe/Lisbon
+static const char     tz_Europe_Lisbon_name[] PROGMEM = "Europe/Lisbon";
+static const uint32_t tz_Europe_Lisbon_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_Lisbon_offsets[] PROGMEM = {
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0,
+};
+
+// Europe/London
+static const char     tz_Europe_London_name[] PROGMEM = "Europe/London";
+static const uint32_t tz_Europe_London_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_London_offsets[] PROGMEM = {
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0, 60, 0, 60, 0, 60, 0, 60,
+    0, 60, 0, 60, 0,
+};
+
+// Europe/Moscow
+static const char     tz_Europe_Moscow_name[] PROGMEM = "Europe/Moscow";
+static const int16_t  tz_Europe_Moscow_offsets[] PROGMEM = {
+    180,
+};
+
+// Europe/Paris
+static const char     tz_Europe_Paris_name[] PROGMEM = "Europe/Paris";
+static const uint32_t tz_Europe_Paris_times[] PROGMEM = {
+    1711846800, 1729990800, 1743296400, 1761440400, 1774746000, 1792890000,
+    1806195600, 1824944400, 1837645200, 1856394000, 1869094800, 1887843600,
+    1901149200, 1919293200, 1932598800, 1950742800, 1964048400, 1982797200,
+    1995498000, 2014246800, 2026947600, 2045696400, 2058397200, 2077146000,
+    2090451600, 2108595600, 2121901200, 2140045200,
+};
+static const int16_t  tz_Europe_Paris_offsets[] PROGMEM = {
+    60, 120, 60, 120, 60, 120, 60, 120, 60, 120, 60, 120,
+    60, 120, 60, 120, 60, 120, 60, 120, 60, 120, 60, 120,
+    60, 120, 60, 120, 60,
+};
+
+// Pacific/Auckland
+static const char     tz_Pacific_Auckland_name[] PROGMEM = "Pacific/Auckland";
+static const uint32_t tz_Pacific_Auckland_times[] PROGMEM = {
+    1712412000, 1727532000, 1743861600, 1758981600, 1775311200, 1790431200,
+    1806760800, 1821880800, 1838210400, 1853330400, 1869660000, 1885384800,
+    1901714400, 1916834400, 1933164000, 1948284000, 1964613600, 1979733600,
+    1996063200, 2011183200, 2027512800, 2042632800, 2058962400, 2074687200,
+    2091016800, 2106136800, 2122466400, 2137586400,
+};
+static const int16_t  tz_Pacific_Auckland_offsets[] PROGMEM = {
+    780, 720, 780, 720, 780, 720, 780, 720, 780, 720, 780, 720,
+    780, 720, 780, 720, 780, 720, 780, 720, 780, 720, 780, 720,
+    780, 720, 780, 720, 780,
+};
+
+// Pacific/Honolulu
+static const char     tz_Pacific_Honolulu_name[] PROGMEM = "Pacific/Honolulu";
+static const int16_t  tz_Pacific_Honolulu_offsets[] PROGMEM = {
+    -600,
+};
+
+// UTC
+static const char     tz_UTC_name[] PROGMEM = "UTC";
+static const int16_t  tz_UTC_offsets[] PROGMEM = {
+    0,
+};
+
+// sorted by name for TZData::find()
+const TimeZone tz_zones[] PROGMEM = {
+    { tz_Africa_Casablanca_name, tz_Africa_Casablanca_times, tz_Africa_Casablanca_offsets, 30 },
+    { tz_America_Anchorage_name, tz_America_Anchorage_times, tz_America_Anchorage_offsets, 28 },
+    { tz_America_Chicago_name, tz_America_Chicago_times, tz_America_Chicago_offsets, 28 },
+    { tz_America_Denver_name, tz_America_Denver_times, tz_America_Denver_offsets, 28 },
+    { tz_America_Halifax_name, tz_America_Halifax_times, tz_America_Halifax_offsets, 28 },
+    { tz_America_Los_Angeles_name, tz_America_Los_Angeles_times, tz_America_Los_Angeles_offsets, 28 },
+    { tz_America_Mexico_City_name, NULL, tz_America_Mexico_City_offsets, 0 },
+    { tz_America_New_York_name, tz_America_New_York_times, tz_America_New_York_offsets, 28 },
+    { tz_America_Phoenix_name, NULL, tz_America_Phoenix_offsets, 0 },
+    { tz_America_Santiago_name, tz_America_Santiago_times, tz_America_Santiago_offsets, 28 },
+    { tz_America_Sao_Paulo_name, NULL, tz_America_Sao_Paulo_offsets, 0 },
+    { tz_America_St_Johns_name, tz_America_St_Johns_times, tz_America_St_Johns_offsets, 28 },
+    { tz_Asia_Bangkok_name, NULL, tz_Asia_Bangkok_offsets, 0 },
+    { tz_Asia_Dubai_name, NULL, tz_Asia_Dubai_offsets, 0 },
+    { tz_Asia_Jerusalem_name, tz_Asia_Jerusalem_times, tz_Asia_Jerusalem_offsets, 28 },
+    { tz_Asia_Kolkata_name, NULL, tz_Asia_Kolkata_offsets, 0 },
+    { tz_Asia_Shanghai_name, NULL, tz_Asia_Shanghai_offsets, 0 },
+    { tz_Asia_Tehran_name, NULL, tz_Asia_Tehran_offsets, 0 },
+    { tz_Asia_Tokyo_name, NULL, tz_Asia_Tokyo_offsets, 0 },
+    { tz_Australia_Adelaide_name, tz_Australia_Adelaide_times, tz_Australia_Adelaide_offsets, 28 },
+    { tz_Australia_Perth_name, NULL, tz_Australia_Perth_offsets, 0 },
+    { tz_Australia_Sydney_name, tz_Australia_Sydney_times, tz_Australia_Sydney_offsets, 28 },
+    { tz_Europe_Athens_name, tz_Europe_Athens_times, tz_Europe_Athens_offsets, 28 },
+    { tz_Europe_Berlin_name, tz_Europe_Berlin_times, tz_Europe_Berlin_offsets, 28 },
+    { tz_Europe_Dublin_name, tz_Europe_Dublin_times, tz_Europe_Dublin_offsets, 28 },
+    { tz_Europe_Lisbon_name, tz_Europe_Lisbon_times, tz_Europe_Lisbon_offsets, 28 },
+    { tz_Europe_London_name, tz_Europe_London_times, tz_Europe_London_offsets, 28 },
+    { tz_Europe_Moscow_name, NULL, tz_Europe_Moscow_offsets, 0 },
+    { tz_Europe_Paris_name, tz_Europe_Paris_times, tz_Europe_Paris_offsets, 28 },
+    { tz_Pacific_Auckland_name, tz_Pacific_Auckland_times, tz_Pacific_Auckland_offsets, 28 },
+    { tz_Pacific_Honolulu_name, NULL, tz_Pacific_Honolulu_offsets, 0 },
+    { tz_UTC_name, NULL, tz_UTC_offsets, 0 },
+};
+
+const uint16_t tz_zone_count = sizeof(tz_zones) / sizeof(tz_zones[0]);
@@ -0,0 +1,92 @@
+/*
+ * TimeBase.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "TimeBase.h"
+
+TimeBase::TimeBase()
+{
+    invalidate();
+}
+
+//
+// seconds is the RTC time that started at the edge seen at edge_us
+//
+void TimeBase::anchor(uint32_t seconds, uint32_t edge_us)
+{
+    _seconds = seconds;
+    _edge_us = edge_us;
+    _valid   = true;
+}
+
+void TimeBase::invalidate()
+{
+    _valid   = false;
+    _seconds = 0;
+    _edge_us = 0;
+}
+
+bool TimeBase::isValid()
+{
+    // unsigned math handles a micros() wrap since the anchor
+    return _valid && (micros() - _edge_us) < TIMEBASE_MAX_AGE;
+}
+
+uint32_t TimeBase::getAge()
+{
+    return micros() - _edge_us;
+}
+
+void TimeBase::now(uint32_t* seconds, uint32_t* usec)
+{
+    uint32_t elapsed = micros() - _edge_us;
+    *seconds = _seconds + elapsed / 1000000;
+    if (usec != NULL)
+    {
+        *usec = elapsed % 1000000;
+    }
+}
+
+//
+// microseconds from now until the given time, negative if it has passed.
+// the time must be within ~35 minutes of the anchor (int32 microseconds)
+//
+int32_t TimeBase::usUntil(uint32_t seconds, uint32_t usec)
+{
+    int32_t target = (int32_t)(seconds - _seconds) * 1000000 + (int32_t)usec;
+    return target - (int32_t)(micros() - _edge_us);
+}
+
+void TimeBase::waitUntil(uint32_t seconds, uint32_t usec)
+{
+    int32_t remaining = usUntil(seconds, usec);
+    if (remaining <= 0)
+    {
+        return;
+    }
+
+    delay(remaining / 1000);
+
+    // finish the last partial millisecond spinning on micros()
+    while (usUntil(seconds, usec) > 0)
+    {
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * TimeBase.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <Arduino.h>
+
+//
+// max age of an anchor before it needs to be re-synced to an RTC edge, the
+// ESP8266 crystal is only good for ~20ppm so this keeps the error well below 1ms.
+//
+#ifndef TIMEBASE_MAX_AGE
+#define TIMEBASE_MAX_AGE 30000000 // us
+#endif
+
+//
+// Sub-second time of day: an RTC second anchored to the micros() of the
+// SQW edge that started it, extended with micros().
+//
+class TimeBase
+{
+public:
+    TimeBase();
+    void     anchor(uint32_t seconds, uint32_t edge_us);
+    void     invalidate();
+    bool     isValid();
+    uint32_t getAge();   // us since the anchor edge
+    void     now(uint32_t* seconds, uint32_t* usec);
+    int32_t  usUntil(uint32_t seconds, uint32_t usec);
+    void     waitUntil(uint32_t seconds, uint32_t usec);
+
+private:
+    bool     _valid;
+    uint32_t _seconds; // RTC time at the anchor edge
+    uint32_t _edge_us; // micros() at the anchor edge
+};
+
+#endif /* TIMEBASE_H_ */
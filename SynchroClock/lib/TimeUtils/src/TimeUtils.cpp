@@ -20,6 +20,10 @@
  *      Author: liebman
  */
 
+#ifdef TIMEUTILS_LOG_LEVEL
+#define LOGGER_LEVEL TIMEUTILS_LOG_LEVEL
+#endif
+
 #include "TimeUtils.h"
 
 static PROGMEM const char TAG[] = "TimeUtils";
@@ -175,29 +179,48 @@ uint16_t TimeUtils::parsePosition(const char* position_string)
 
 
 //
-// Modified code from: http://www.jbox.dk/sanos/source/lib/time.c.html
+// Constant time civil date conversions from:
+//
+//   http://howardhinnant.github.io/date_algorithms.html
+//
+// Days are counted from 1970-01-01, years are shifted to start in March so
+// the leap day is the last day of the year.
 //
 
 #define YEAR0                   1900
 #define EPOCH_YR                1970
 #define SECS_DAY                (24L * 60L * 60L)
-#define LEAPYEAR(year)          (!((year) % 4) && (((year) % 100) || !((year) % 400)))
-#define YEARSIZE(year)          (LEAPYEAR(year) ? 366 : 365)
 #define TIME_MAX                2147483647L
+#define DAYS_0000_TO_1970       719468L   // days from 0000-03-01 to 1970-01-01
+#define DAYS_PER_ERA            146097L   // days in 400 years
+
+long TimeUtils::daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    long     era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);                                // [0, 399]
+    unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                        // [0, 146096]
+    return era * DAYS_PER_ERA + (long)doe - DAYS_0000_TO_1970;
+}
 
-const int _ytab[2][12] =
+void TimeUtils::civilFromDays(long days, int* year, int* month, int* day)
 {
-{ 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 },
-{ 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 } };
+    days += DAYS_0000_TO_1970;
+    long     era = (days >= 0 ? days : days - (DAYS_PER_ERA - 1)) / DAYS_PER_ERA;
+    unsigned doe = (unsigned)(days - era * DAYS_PER_ERA);                        // [0, 146096]
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;        // [0, 399]
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                      // [0, 365]
+    unsigned mp  = (5 * doy + 2) / 153;                                          // [0, 11]
+    *day   = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year  = (int)(yoe + era * 400) + (*month <= 2);
+}
 
 // esp version is broken :-(
 time_t TimeUtils::mktime(struct tm *tmbuf)
 {
-    long day, year;
-    int tm_year;
-    int yday, month;
-    /*unsigned*/long seconds;
-    int overflow;
+    long day;
 
     tmbuf->tm_min += tmbuf->tm_sec / 60;
     tmbuf->tm_sec %= 60;
@@ -227,106 +250,52 @@ time_t TimeUtils::mktime(struct tm *tmbuf)
         tmbuf->tm_mon += 12;
         tmbuf->tm_year--;
     }
-    day += (tmbuf->tm_mday - 1);
-    while (day < 0)
-    {
-        if (--tmbuf->tm_mon < 0)
-        {
-            tmbuf->tm_year--;
-            tmbuf->tm_mon = 11;
-        }
-        day += _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon];
-    }
-    while (day >= _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon])
+
+    // the days from the epoch, this normalizes an out of range tm_mday
+    day += daysFromCivil(tmbuf->tm_year + YEAR0, tmbuf->tm_mon + 1, 1) + tmbuf->tm_mday - 1;
+
+    int year, month, mday;
+    civilFromDays(day, &year, &month, &mday);
+    tmbuf->tm_year = year - YEAR0;
+    tmbuf->tm_mon  = month - 1;
+    tmbuf->tm_mday = mday;
+    if (year < EPOCH_YR)
     {
-        day -= _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon];
-        if (++(tmbuf->tm_mon) == 12)
-        {
-            tmbuf->tm_mon = 0;
-            tmbuf->tm_year++;
-        }
-    }
-    tmbuf->tm_mday = day + 1;
-    year = EPOCH_YR;
-    if (tmbuf->tm_year < year - YEAR0)
         return (time_t) -1;
-    seconds = 0;
-    day = 0;                      // Means days since day 0 now
-    overflow = 0;
-
-    // Assume that when day becomes negative, there will certainly
-    // be overflow on seconds.
-    // The check for overflow needs not to be done for leapyears
-    // divisible by 400.
-    // The code only works when year (1970) is not a leapyear.
-    tm_year = tmbuf->tm_year + YEAR0;
-
-    if (TIME_MAX / 365 < tm_year - year)
-        overflow++;
-    day = (tm_year - year) * 365;
-    if (TIME_MAX - day < (tm_year - year) / 4 + 1)
-        overflow++;
-    day += (tm_year - year) / 4 + ((tm_year % 4) && tm_year % 4 < year % 4);
-    day -= (tm_year - year) / 100
-            + ((tm_year % 100) && tm_year % 100 < year % 100);
-    day += (tm_year - year) / 400
-            + ((tm_year % 400) && tm_year % 400 < year % 400);
-
-    yday = month = 0;
-    while (month < tmbuf->tm_mon)
-    {
-        yday += _ytab[LEAPYEAR(tm_year)][month];
-        month++;
     }
-    yday += (tmbuf->tm_mday - 1);
-    if (day + yday < 0)
-        overflow++;
-    day += yday;
 
-    tmbuf->tm_yday = yday;
+    tmbuf->tm_yday = day - daysFromCivil(year, 1, 1);
     tmbuf->tm_wday = (day + 4) % 7;               // Day 0 was thursday (4)
 
-    seconds = ((tmbuf->tm_hour * 60L) + tmbuf->tm_min) * 60L + tmbuf->tm_sec;
-
+    long seconds = ((tmbuf->tm_hour * 60L) + tmbuf->tm_min) * 60L + tmbuf->tm_sec;
     if ((TIME_MAX - seconds) / SECS_DAY < day)
-        overflow++;
-    seconds += day * SECS_DAY;
-
-    if (overflow)
-        return (time_t) -1;
-
-    if ((time_t) seconds != seconds)
+    {
         return (time_t) -1;
-    return (time_t) seconds;
+    }
+    return (time_t) (seconds + day * SECS_DAY);
 }
 
 struct tm *TimeUtils::gmtime_r(const time_t *timer, struct tm *tmbuf)
 {
-  time_t time = *timer;
-  unsigned long dayclock, dayno;
-  int year = EPOCH_YR;
-
-  dayclock = (unsigned long) time % SECS_DAY;
-  dayno = (unsigned long) time / SECS_DAY;
-
-  tmbuf->tm_sec = dayclock % 60;
-  tmbuf->tm_min = (dayclock % 3600) / 60;
-  tmbuf->tm_hour = dayclock / 3600;
-  tmbuf->tm_wday = (dayno + 4) % 7; // Day 0 was a thursday
-  while (dayno >= (unsigned long) YEARSIZE(year)) {
-    dayno -= YEARSIZE(year);
-    year++;
-  }
-  tmbuf->tm_year = year - YEAR0;
-  tmbuf->tm_yday = dayno;
-  tmbuf->tm_mon = 0;
-  while (dayno >= (unsigned long) _ytab[LEAPYEAR(year)][tmbuf->tm_mon]) {
-    dayno -= _ytab[LEAPYEAR(year)][tmbuf->tm_mon];
-    tmbuf->tm_mon++;
-  }
-  tmbuf->tm_mday = dayno + 1;
-  tmbuf->tm_isdst = 0;
-  return tmbuf;
+    time_t time = *timer;
+    unsigned long dayclock, dayno;
+
+    dayclock = (unsigned long) time % SECS_DAY;
+    dayno = (unsigned long) time / SECS_DAY;
+
+    tmbuf->tm_sec = dayclock % 60;
+    tmbuf->tm_min = (dayclock % 3600) / 60;
+    tmbuf->tm_hour = dayclock / 3600;
+    tmbuf->tm_wday = (dayno + 4) % 7; // Day 0 was a thursday
+
+    int year, month, mday;
+    civilFromDays(dayno, &year, &month, &mday);
+    tmbuf->tm_year = year - YEAR0;
+    tmbuf->tm_yday = dayno - daysFromCivil(year, 1, 1);
+    tmbuf->tm_mon = month - 1;
+    tmbuf->tm_mday = mday;
+    tmbuf->tm_isdst = 0;
+    return tmbuf;
 }
 
 char* TimeUtils::time2str(const time_t t)
@@ -411,7 +380,7 @@ uint8_t TimeUtils::findDateForWeek(uint16_t year, uint8_t month, uint8_t dow, in
 {
     dlog.debug(FPSTR(TAG), F("::findDateForWeek: year:%u month:%u, dow:%u week:%d"), year, month, dow, week);
 
-    uint8_t weeks[5];
+    uint8_t weeks[6]; // up to 5 in the month plus the first one past it
     uint8_t max_day = daysInMonth(year, month);
     int last = 0;
 
@@ -440,7 +409,51 @@ uint8_t TimeUtils::findDateForWeek(uint16_t year, uint8_t month, uint8_t dow, in
     return weeks[last+week];
 }
 
+//
+// UTC time of a time change in the given year, tz_offset is the offset in
+// effect just before the change.
+//
+time_t TimeUtils::computeTimeChange(int year, int tz_offset, TimeChange* tc)
+{
+    struct tm tm;
+
+    dlog.debug(FPSTR(TAG), F("::computeTimeChange: offset:%d month:%u dow:%u occurrence:%d hour:%u day_offset:%d"),
+            tc->tz_offset,
+            tc->month,
+            tc->day_of_week,
+            tc->occurrence,
+            tc->hour,
+            tc->day_offset);
+
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_hour   = tc->hour;
+    tm.tm_mday   = TimeUtils::findDateForWeek(year, tc->month, tc->day_of_week, tc->occurrence);
+    tm.tm_mon    = tc->month-1;
+    tm.tm_year   = year-1900;
+
+    dlog.debug(FPSTR(TAG), F("::computeTimeChange: tm: %04d/%02d/%02d %02d:%02d:%02d + %d days"), tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, tc->day_offset);
+
+    // convert to seconds
+    time_t tc_time = mktime(&tm);
+    // convert to UTC
+    tc_time -= tz_offset;
+    // add in days offset
+    tc_time += tc->day_offset*86400;
+    dlog.debug(FPSTR(TAG), F("::computeTimeChange: tc_time: %ld (UTC)"), tc_time);
+
+    return tc_time;
+}
+
 int TimeUtils::computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int tc_count)
+{
+    return computeUTCOffset(now, tz_offset, tc, tc_count, NULL);
+}
+
+//
+// If next_change is not NULL it is set to the UTC time of the next time change
+// after now (0 if there isn't one) so callers can skip this until then.
+//
+int TimeUtils::computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int tc_count, time_t* next_change)
 {
     struct tm tm;
 
@@ -448,7 +461,7 @@ int TimeUtils::computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int t
     // get the current year
     //
     gmtime_r(&now, &tm);
-    int year = tm.tm_year;
+    int year = tm.tm_year+1900;
 
     //
     // pre-set the offset to the last timechange of the year
@@ -462,31 +475,7 @@ int TimeUtils::computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int t
     //
     for(int i = 0; i < tc_count; ++i)
     {
-        dlog.debug(FPSTR(TAG), F("::computeUTCOffset: index:%d offset:%d month:%u dow:%u occurrence:%d hour:%u day_offset:%d"),
-                i,
-                tc[i].tz_offset,
-                tc[i].month,
-                tc[i].day_of_week,
-                tc[i].occurrence,
-                tc[i].hour,
-                tc[i].day_offset);
-
-        tm.tm_sec    = 0;
-        tm.tm_min    = 0;
-        tm.tm_hour   = tc[i].hour;
-        tm.tm_mday   = TimeUtils::findDateForWeek(year+1900, tc[i].month, tc[i].day_of_week, tc[i].occurrence);
-        tm.tm_mon    = tc[i].month-1;
-        tm.tm_year   = year;
-
-        dlog.debug(FPSTR(TAG), F("::computeUTCOffset: tm: %04d/%02d/%02d %02d:%02d:%02d + %d days"), tm.tm_year+1900, tm.tm_mon+1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, tc[i].day_offset);
-
-        // convert to seconds
-        time_t tc_time = mktime(&tm);
-        // convert to UTC
-        tc_time -= tz_offset;
-        dlog.debug(FPSTR(TAG), F("::computeUTCOffset: tc_time: %ld (UTC)"), tc_time);
-        // add in days offset
-        tc_time += tc[i].day_offset*86400;
+        time_t tc_time = computeTimeChange(year, tz_offset, &tc[i]);
 
         dlog.debug(FPSTR(TAG), F("::computeUTCOffset: now: %ld tc_time: %ld"), now, tc_time);
 
@@ -497,5 +486,59 @@ int TimeUtils::computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int t
         }
     }
 
+    if (next_change != NULL)
+    {
+        //
+        // each change happens in the local time of the one before it, not
+        // the caller's offset which may be from before the last change.  If
+        // this years changes are all done it's early next year.
+        //
+        time_t next = 0;
+        for (int y = year; y <= year+1 && next == 0; ++y)
+        {
+            for(int i = 0; i < tc_count; ++i)
+            {
+                int    before  = tc[(i + tc_count - 1) % tc_count].tz_offset;
+                time_t tc_time = computeTimeChange(y, before, &tc[i]);
+                if (tc_time > now && (next == 0 || tc_time < next))
+                {
+                    next = tc_time;
+                }
+            }
+        }
+        *next_change = next;
+    }
+
     return offset;
 }
+
+//
+// Binary search the transition table for the offset in effect at now.  If
+// next_change is not NULL it is set to the UTC time of the next transition
+// (0 if the table has none after now).
+//
+int TimeUtils::computeUTCOffset(time_t now, const TimeZone* tz, time_t* next_change)
+{
+    // find the number of transitions at or before now
+    uint16_t lo = 0;
+    uint16_t hi = tz->count;
+    while (lo < hi)
+    {
+        uint16_t mid = (lo + hi) / 2;
+        if ((uint32_t)now >= pgm_read_dword(&tz->times[mid]))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if (next_change != NULL)
+    {
+        *next_change = lo < tz->count ? (time_t)pgm_read_dword(&tz->times[lo]) : 0;
+    }
+
+    return (int16_t)pgm_read_word(&tz->offsets[lo]) * 60;
+}
@@ -36,6 +36,18 @@ typedef struct
     int8_t  day_offset;    // +/- days (for Friday before last Sunday type)
 } TimeChange;
 
+//
+// A time zone as a table of precomputed transitions (see mktz.py), all of
+// the pointers are to PROGMEM.
+//
+typedef struct
+{
+    const char*     name;          // IANA zone name
+    const uint32_t* times;         // UTC time of each transition, ascending
+    const int16_t*  offsets;       // minutes from UTC, [0] before times[0], [i+1] from times[i]
+    uint16_t        count;         // number of transitions
+} TimeZone;
+
 class TimeUtils
 {
 public:
@@ -46,10 +58,15 @@ public:
     static uint8_t    parseDayOfWeek(const char* dow_string);
     static uint8_t    parseMonth(const char* month_string);
     static uint8_t    parseHour(const char* hour_string);
+    static long       daysFromCivil(int year, int month, int day);
+    static void       civilFromDays(long days, int* year, int* month, int* day);
     static time_t     mktime(struct tm *tmbuf);
     static struct tm* gmtime_r(const time_t *timer, struct tm *tmbuf);
     static char*      time2str(const time_t t);
     static int        computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int tc_count);
+    static int        computeUTCOffset(time_t now, int tz_offset, TimeChange* tc, int tc_count, time_t* next_change);
+    static time_t     computeTimeChange(int year, int tz_offset, TimeChange* tc);
+    static int        computeUTCOffset(time_t now, const TimeZone* tz, time_t* next_change);
     static uint8_t    findDOW(uint16_t y, uint8_t m, uint8_t d);
     static uint8_t    findNthDate(uint16_t year, uint8_t month, uint8_t dow, uint8_t nthWeek);
     static uint8_t    daysInMonth(uint16_t year, uint8_t month);
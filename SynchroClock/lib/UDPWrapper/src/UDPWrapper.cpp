@@ -5,6 +5,10 @@
  *      Author: liebman
  */
 
+#ifdef UDPWRAPPER_LOG_LEVEL
+#define LOGGER_LEVEL UDPWRAPPER_LOG_LEVEL
+#endif
+
 #include "UDPWrapper.h"
 
 static PROGMEM const char TAG[] = "UDPWrapper";
@@ -81,6 +85,39 @@ int UDPWrapper::recv(void* buffer, size_t wanted, unsigned int timeout_ms)
     return size;
 }
 
+//
+// receive a datagram on the local port from anyone, returns its size (only
+// the first size bytes are read) or 0 if none arrives in timeout_ms.
+//
+int UDPWrapper::recvFrom(void* buffer, size_t size, IPAddress* address, uint16_t* port, unsigned int timeout_ms)
+{
+    unsigned int start = millis();
+    int received;
+    while ((received = _udp.parsePacket()) == 0)
+    {
+        if (millis() - start >= timeout_ms)
+        {
+            return 0;
+        }
+        yield();
+    }
+
+    *address = _udp.remoteIP();
+    *port    = _udp.remotePort();
+    _udp.read((char *)buffer, received < (int)size ? received : size);
+    return received;
+}
+
+int UDPWrapper::sendTo(IPAddress address, uint16_t port, void* buffer, size_t size)
+{
+    if (!_udp.beginPacket(address, port))
+    {
+        dlog.error(FPSTR(TAG), F("::sendTo: beginPacket failed!"));
+        return -1;
+    }
+    return send(buffer, size);
+}
+
 int UDPWrapper::close()
 {
     dlog.debug(FPSTR(TAG), F("::close called!"));
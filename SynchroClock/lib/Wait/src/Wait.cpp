@@ -0,0 +1,170 @@
+/*
+ * Wait.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifdef WAIT_LOG_LEVEL
+#define LOGGER_LEVEL WAIT_LOG_LEVEL
+#endif
+
+#include "Wait.h"
+extern "C" {
+#include <user_interface.h>
+#include <gpio.h>
+}
+
+#define WAIT_LIGHT_SLEEP_MAX_MS 268000 // wifi_fpm_do_sleep() takes up to 0xFFFFFFF us
+
+static PROGMEM const char TAG[] = "Wait";
+
+static bool          radio = true;
+static uint32_t      rtc_cal;          // us per RTC tick, 12 bit fraction
+static uint32_t      rtc_start;
+static uint32_t      sleeps;
+static uint32_t      slept_us;
+static volatile bool woke;
+
+static void wakeup()
+{
+    woke = true;
+}
+
+static uint32_t rtcMicros(uint32_t since)
+{
+    return ((uint64_t)(system_get_rtc_time() - since) * rtc_cal) >> 12;
+}
+
+//
+// reset the counters at the wake, radio is false when the wake has the RF disabled
+//
+void Wait::begin(bool _radio)
+{
+    radio     = _radio;
+    sleeps    = 0;
+    slept_us  = 0;
+    rtc_cal   = system_rtc_clock_cali_proc();
+    rtc_start = system_get_rtc_time();
+}
+
+//
+// sleep for ms or until pin reads level (pin < 0 for the timer only).  The
+// sleep starts when we give the SDK control, the loop bounds the wait if
+// the wake up callback never comes.
+//
+uint32_t Wait::lightSleep(uint32_t ms, int pin, uint8_t level)
+{
+    uint32_t start = system_get_rtc_time();
+
+    woke = false;
+    wifi_set_opmode_current(NULL_MODE);
+    wifi_fpm_set_sleep_type(LIGHT_SLEEP_T);
+    wifi_fpm_open();
+    if (pin >= 0)
+    {
+        gpio_pin_wakeup_enable(GPIO_ID_PIN(pin), level ? GPIO_PIN_INTR_HILEVEL : GPIO_PIN_INTR_LOLEVEL);
+    }
+    wifi_fpm_set_wakeup_cb(wakeup);
+    wifi_fpm_do_sleep(ms * 1000);
+    for (uint32_t i = 0; !woke && i <= ms; ++i)
+    {
+        delay(1);
+    }
+    if (pin >= 0)
+    {
+        gpio_pin_wakeup_disable();
+    }
+    wifi_fpm_close();
+
+    uint32_t us = rtcMicros(start);
+    sleeps   += 1;
+    slept_us += us;
+    dlog.debug(FPSTR(TAG), F("::lightSleep: %u ms asked, %u us slept"), ms, us);
+    return us / 1000;
+}
+
+void Wait::ms(uint32_t ms)
+{
+    if (!radio)
+    {
+        while (ms >= WAIT_LIGHT_SLEEP_MIN_MS)
+        {
+            uint32_t slept = lightSleep(ms < WAIT_LIGHT_SLEEP_MAX_MS ? ms : WAIT_LIGHT_SLEEP_MAX_MS, -1, 0);
+            ms = slept < ms ? ms - slept : 0;
+        }
+    }
+    delay(ms);
+}
+
+//
+// wait for pin to read level, waking on the level itself when we light
+// sleep.  The wake up takes a few ms so this is for getting close to an
+// edge, not for timing it.
+//
+int Wait::pin(uint8_t pin, uint8_t level, uint32_t timeout_ms)
+{
+    if (!radio && timeout_ms >= WAIT_LIGHT_SLEEP_MIN_MS && digitalRead(pin) != level)
+    {
+        uint32_t slept = lightSleep(timeout_ms < WAIT_LIGHT_SLEEP_MAX_MS ? timeout_ms : WAIT_LIGHT_SLEEP_MAX_MS, pin, level);
+        timeout_ms = slept < timeout_ms ? timeout_ms - slept : 0;
+    }
+
+    uint32_t start = millis();
+    while (digitalRead(pin) != level)
+    {
+        if (millis() - start >= timeout_ms)
+        {
+            return -1;
+        }
+        delay(1);
+    }
+    return 0;
+}
+
+uint32_t Wait::getSleeps()
+{
+    return sleeps;
+}
+
+uint32_t Wait::getSleptMillis()
+{
+    return slept_us / 1000;
+}
+
+double Wait::getSaved()
+{
+    return (WAIT_AWAKE_MA - WAIT_LIGHT_SLEEP_MA) * slept_us / 1000000.0;
+}
+
+//
+// the charge light sleep saved this wake and what that is as an average
+// current over the whole wake
+//
+void Wait::report()
+{
+    if (sleeps == 0)
+    {
+        return;
+    }
+    uint32_t wake_us = rtcMicros(rtc_start);
+    double   saved   = getSaved();
+    dlog.info(FPSTR(TAG), F("light slept %lums in %u waits of a %lums wake, saved %.1fmAs (%.2fmA average)"),
+            (unsigned long)slept_us / 1000, sleeps, (unsigned long)wake_us / 1000,
+            saved, wake_us ? saved * 1000000.0 / wake_us : 0.0);
+}
@@ -0,0 +1,57 @@
+/*
+ * Wait.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WAIT_H_
+#define WAIT_H_
+#include <Arduino.h>
+#include "Logger.h"
+
+//
+// Waits that put the ESP8266 in forced light sleep when the wake has the
+// RF disabled and the wait is long enough to pay for the wake up, instead
+// of burning the CPU current in delay().  When the radio is up we just
+// delay(), the SDK modem sleeps between beacons while we do.
+//
+// micros() and millis() may not count the time spent in light sleep, so
+// the slept time is measured with the RTC timer and timing critical code
+// (edge timestamps, TimeBase) must not light sleep between its readings.
+//
+#define WAIT_LIGHT_SLEEP_MIN_MS 20    // shorter waits just delay()
+#define WAIT_AWAKE_MA           15.0  // 80MHz with the RF disabled
+#define WAIT_LIGHT_SLEEP_MA     0.9
+
+class Wait
+{
+public:
+    static void     begin(bool radio);
+    static void     ms(uint32_t ms);
+    static int      pin(uint8_t pin, uint8_t level, uint32_t timeout_ms); // 0 when pin reads level, -1 on timeout
+    static uint32_t getSleeps();
+    static uint32_t getSleptMillis();
+    static double   getSaved();                // estimated mA*s saved this wake
+    static void     report();
+
+private:
+    static uint32_t lightSleep(uint32_t ms, int pin, uint8_t level); // returns ms slept
+};
+
+#endif /* WAIT_H_ */
@@ -20,12 +20,22 @@
  *      Author: liebman
  */
 
+#ifdef WIREUTILS_LOG_LEVEL
+#define LOGGER_LEVEL WIREUTILS_LOG_LEVEL
+#endif
+
 #include "WireUtils.h"
 
 static PROGMEM const char TAG[] = "WireUtils";
 
 WireUtilsC::WireUtilsC()
 {
+	clear_count = 0;
+}
+
+uint16_t WireUtilsC::getClearCount()
+{
+	return clear_count;
 }
 
 /**
@@ -42,6 +52,7 @@ WireUtilsC::WireUtilsC()
 int WireUtilsC::clearBus()
 {
 	dlog.info(FPSTR(TAG), F("::ClearBus: attempting to clean i2c bus"));
+	++clear_count;
 #if defined(TWCR) && defined(TWEN)
 	TWCR &= ~(_BV(TWEN)); //Disable the Atmel 2-Wire interface so we can control the SDA and SCL pins directly
 #endif
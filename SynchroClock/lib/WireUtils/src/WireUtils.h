@@ -29,6 +29,9 @@ class WireUtilsC {
 public:
 	WireUtilsC();
 	int clearBus();
+	uint16_t getClearCount(); // clearBus() calls since boot
+private:
+	uint16_t clear_count;
 };
 
 extern WireUtilsC WireUtils;
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# logdecode.py
+#
+# Copyright 2017 Christopher B. Liebman
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#
+#  Created on: Oct 18, 2026
+#      Author: liebman
+#
+# Format a binary log (LOG_BINARY builds, see lib/Logger/src/BinaryLog.h)
+# using the strings in the firmware ELF it was recorded by:
+#
+#   python3 logdecode.py .pio/build/la/firmware.elf log.old log.bin
+#
+import argparse
+import re
+import struct
+import sys
+
+BINARY_LOG_MAGIC   = 0x474f4c42
+BINARY_LOG_WAKE    = 0x454b4157
+BINARY_LOG_VERSION = 1
+HEADER_WORDS       = 5
+ANCHOR             = "binary_log_anchor"
+
+ARG_32, ARG_64, ARG_DOUBLE, ARG_STRING = range(4)
+
+LEVELS = "-EWIDT"
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|L|q|j|z|t)?([diouxXeEfgGcsp%])")
+
+
+class Elf:
+    """just enough ELF to read strings at their link address"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit("%s: not an ELF file" % path)
+        wide = self.data[4] == 2
+        if wide:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x3a)
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2e)
+
+        self.sections = []
+        symtabs = []
+        for i in range(shnum):
+            off = shoff + i * shentsize
+            if wide:
+                name, stype, flags, addr, offset, size, link = struct.unpack_from("<IIQQQQI", self.data, off)
+            else:
+                name, stype, flags, addr, offset, size, link = struct.unpack_from("<IIIIIII", self.data, off)
+            self.sections.append((stype, flags, addr, offset, size, link))
+            if stype in (2, 11):  # SHT_SYMTAB, SHT_DYNSYM
+                symtabs.append(i)
+
+        self.anchor = None
+        for i in symtabs:
+            stype, flags, addr, offset, size, link = self.sections[i]
+            strtab = self.sections[link][3]
+            entsize = 24 if wide else 16
+            for n in range(size // entsize):
+                if wide:
+                    name, info, other, shndx, value, _ = struct.unpack_from("<IBBHQQ", self.data, offset + n * entsize)
+                else:
+                    name, value, _, info, other, shndx = struct.unpack_from("<IIIBBH", self.data, offset + n * entsize)
+                end = self.data.index(b"\0", strtab + name)
+                if self.data[strtab + name:end] == ANCHOR.encode():
+                    self.anchor = value
+                    break
+            if self.anchor is not None:
+                break
+        if self.anchor is None:
+            sys.exit("%s: no %s, was it built with LOG_BINARY?" % (path, ANCHOR))
+
+    def string(self, relative):
+        if relative >= 0x80000000:
+            relative -= 0x100000000
+        addr = self.anchor + relative
+        for stype, flags, start, offset, size, link in self.sections:
+            if stype != 8 and flags & 2 and start <= addr < start + size:  # !SHT_NOBITS, SHF_ALLOC
+                pos = offset + addr - start
+                return self.data[pos:self.data.index(b"\0", pos)].decode("latin-1")
+        return "<0x%x?>" % addr
+
+
+def unpack_args(words, count, types):
+    args = []
+    i = 0
+    for n in range(count):
+        t = (types >> (n * 2)) & 3
+        if t == ARG_32:
+            args.append((t, words[i]))
+            i += 1
+        elif t == ARG_64:
+            args.append((t, words[i] | words[i + 1] << 32))
+            i += 2
+        elif t == ARG_DOUBLE:
+            args.append((t, struct.unpack("<d", struct.pack("<II", words[i], words[i + 1]))[0]))
+            i += 2
+        else:
+            length = words[i]
+            raw = struct.pack("<%dI" % ((length + 3) // 4), *words[i + 1:i + 1 + (length + 3) // 4])
+            args.append((t, raw[:length].decode("latin-1")))
+            i += 1 + (length + 3) // 4
+    return args
+
+
+def signed(t, value):
+    bits = 64 if t == ARG_64 else 32
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+def format_message(fmt, args):
+    out = []
+    pos = 0
+    for m in CONVERSION.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(signed(*args.pop(0))) if args else ""
+        if precision == "*":
+            precision = str(signed(*args.pop(0))) if args else ""
+        if not args:
+            out.append("<missing>")
+            continue
+        t, value = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+        if conv in "di":
+            out.append((spec + "d") % (signed(t, value) if t != ARG_DOUBLE else int(value)))
+        elif conv in "ouxX":
+            out.append((spec + ("d" if conv == "u" else conv)) % value)
+        elif conv in "eEfgG":
+            out.append((spec + conv) % float(value))
+        elif conv == "c":
+            out.append((spec + "c") % chr(value & 0xff))
+        elif conv == "p":
+            out.append("0x%x" % value)
+        else:
+            out.append((spec + "s") % value)
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode(elf, path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version = struct.unpack_from("<II", data, 0)
+    if magic != BINARY_LOG_MAGIC or version != BINARY_LOG_VERSION:
+        sys.exit("%s: not a version %d binary log" % (path, BINARY_LOG_VERSION))
+    pos = 8
+    while pos + 12 <= len(data):
+        magic, size, dropped = struct.unpack_from("<III", data, pos)
+        if magic != BINARY_LOG_WAKE:
+            sys.exit("%s: bad wake header at %d" % (path, pos))
+        pos += 12
+        print("---- wake (%d records dropped)" % dropped)
+        words = struct.unpack_from("<%dI" % (size // 4), data, pos)
+        pos += size
+        i = 0
+        while i + HEADER_WORDS <= len(words):
+            fmt, tag, us, info, types = words[i:i + HEADER_WORDS]
+            nwords = info & 0xffff
+            args = unpack_args(words[i + HEADER_WORDS:i + HEADER_WORDS + nwords], (info >> 16) & 0xff, types)
+            level = LEVELS[min(info >> 24, len(LEVELS) - 1)]
+            print("%d.%06d %s %s: %s" % (us // 1000000, us % 1000000, level, elf.string(tag),
+                                         format_message(elf.string(fmt), args).rstrip("\n")))
+            i += HEADER_WORDS + nwords
+
+
+def main():
+    parser = argparse.ArgumentParser(description="format SynchroClock binary logs")
+    parser.add_argument("elf", help="firmware ELF the log was recorded by")
+    parser.add_argument("logs", nargs="+", help="log files, oldest first")
+    args = parser.parse_args()
+    elf = Elf(args.elf)
+    for path in args.logs:
+        decode(elf, path)
+
+
+if __name__ == "__main__":
+    main()
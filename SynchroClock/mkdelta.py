@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+#
+# mkdelta.py
+#
+# Copyright 2017 Christopher B. Liebman
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#
+#  Created on: Oct 18, 2026
+#      Author: liebman
+#
+# Make a delta patch (lib/DeltaOTA/src/DeltaPatch.h) that turns the
+# firmware image running on a clock into a new one.  Name the patch
+# *.delta and put its url in the OTA URL, the clock refuses a patch made
+# against any other image.
+#
+#   python3 mkdelta.py old/firmware.bin .pio/build/la/firmware.bin firmware.delta
+#
+# Matching runs of the old image become COPY ops, everything else is sent
+# as INSERT.  The patch is applied in python before it is written to make
+# sure it rebuilds the new image.
+#
+import argparse
+import hashlib
+import struct
+import sys
+
+DELTA_MAGIC     = 0x50444353
+DELTA_VERSION   = 1
+OP_END          = 0
+OP_COPY         = 1
+OP_INSERT       = 2
+
+KEY_SIZE        = 8     # bytes hashed to find candidate matches
+MIN_COPY        = 16    # shorter matches are cheaper as INSERT
+MAX_CANDIDATES  = 32    # old positions tried for each key
+
+
+def index(old):
+    """old positions for each KEY_SIZE bytes, the first MAX_CANDIDATES of them"""
+    positions = {}
+    for i in range(len(old) - KEY_SIZE + 1):
+        key = old[i:i + KEY_SIZE]
+        found = positions.get(key)
+        if found is None:
+            positions[key] = [i]
+        elif len(found) < MAX_CANDIDATES:
+            found.append(i)
+    return positions
+
+
+def match_length(old, new, o, n):
+    length = 0
+    limit = min(len(old) - o, len(new) - n)
+    while length < limit and old[o + length] == new[n + length]:
+        length += 1
+    return length
+
+
+def diff(old, new):
+    """(op, arg) list, COPY (offset, length) or INSERT bytes"""
+    positions = index(old)
+    ops = []
+    pending = bytearray()
+    expected = None  # code that moved as a block continues where the last copy left off
+    n = 0
+    while n < len(new):
+        best_len, best_at = 0, 0
+        if expected is not None and expected < len(old):
+            best_len, best_at = match_length(old, new, expected, n), expected
+        if best_len < MIN_COPY:
+            for o in positions.get(new[n:n + KEY_SIZE], ()):
+                length = match_length(old, new, o, n)
+                if length > best_len:
+                    best_len, best_at = length, o
+        if best_len >= MIN_COPY:
+            if pending:
+                ops.append((OP_INSERT, bytes(pending)))
+                pending = bytearray()
+            ops.append((OP_COPY, (best_at, best_len)))
+            n += best_len
+            expected = best_at + best_len
+        else:
+            pending.append(new[n])
+            n += 1
+            if expected is not None:
+                expected += 1
+    if pending:
+        ops.append((OP_INSERT, bytes(pending)))
+    return ops
+
+
+def encode(old, new, ops):
+    out = bytearray(struct.pack("<III", DELTA_MAGIC, DELTA_VERSION, len(old)))
+    out += hashlib.md5(old).digest()
+    out += struct.pack("<I", len(new))
+    out += hashlib.md5(new).digest()
+    for op, arg in ops:
+        if op == OP_COPY:
+            out += struct.pack("<BII", OP_COPY, arg[0], arg[1])
+        else:
+            out += struct.pack("<BI", OP_INSERT, len(arg)) + arg
+    out += struct.pack("<B", OP_END)
+    return bytes(out)
+
+
+def apply(old, patch):
+    magic, version, source_size = struct.unpack_from("<III", patch, 0)
+    if magic != DELTA_MAGIC or version != DELTA_VERSION or source_size != len(old):
+        sys.exit("bad patch header!")
+    target_size, = struct.unpack_from("<I", patch, 28)
+    pos = 48
+    new = bytearray()
+    while patch[pos] != OP_END:
+        if patch[pos] == OP_COPY:
+            offset, length = struct.unpack_from("<II", patch, pos + 1)
+            new += old[offset:offset + length]
+            pos += 9
+        else:
+            length, = struct.unpack_from("<I", patch, pos + 1)
+            new += patch[pos + 5:pos + 5 + length]
+            pos += 5 + length
+    if len(new) != target_size or hashlib.md5(new).digest() != patch[32:48]:
+        sys.exit("patch does not rebuild the new image!")
+    return bytes(new)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="make a SynchroClock delta OTA patch")
+    parser.add_argument("old", help="firmware image running on the clock")
+    parser.add_argument("new", help="firmware image to update to")
+    parser.add_argument("patch", help="patch file to write, name it *.delta")
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+
+    ops = diff(old, new)
+    patch = encode(old, new, ops)
+    apply(old, patch)
+
+    with open(args.patch, "wb") as f:
+        f.write(patch)
+    copied = sum(arg[1] for op, arg in ops if op == OP_COPY)
+    print("%s: %d bytes (%.1f%% of %d), %d copied in %d ops" %
+          (args.patch, len(patch), 100.0 * len(patch) / len(new), len(new), copied, len(ops)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+#
+# mktz.py
+#
+# Copyright 2017 Christopher B. Liebman
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#
+#  Created on: Oct 18, 2026
+#      Author: liebman
+#
+# Compile IANA tzdata into the flash resident transition tables used by
+# TZData (lib/TZData/src/TZZones.cpp).  This is run by hand when the zone
+# list or tzdata changes and the output is committed, the firmware build
+# never needs tzdata.
+#
+#   python3 mktz.py [-z zoneinfo_dir] [-s start_year] [-y years] [-o output] [zone ...]
+#
+import argparse
+import datetime
+import os
+import sys
+import zoneinfo
+
+ZONES = [
+    "America/Los_Angeles",
+    "America/Denver",
+    "America/Phoenix",
+    "America/Chicago",
+    "America/New_York",
+    "America/Anchorage",
+    "America/Halifax",
+    "America/St_Johns",
+    "America/Mexico_City",
+    "America/Sao_Paulo",
+    "America/Santiago",
+    "Pacific/Honolulu",
+    "Europe/London",
+    "Europe/Dublin",
+    "Europe/Lisbon",
+    "Europe/Paris",
+    "Europe/Berlin",
+    "Europe/Athens",
+    "Europe/Moscow",
+    "Africa/Casablanca",
+    "Asia/Jerusalem",
+    "Asia/Tehran",
+    "Asia/Dubai",
+    "Asia/Kolkata",
+    "Asia/Bangkok",
+    "Asia/Shanghai",
+    "Asia/Tokyo",
+    "Australia/Perth",
+    "Australia/Adelaide",
+    "Australia/Sydney",
+    "Pacific/Auckland",
+    "UTC",
+]
+
+NAME_SIZE = 32          # sizeof(Config.tz_name)
+LAST_YEAR = 2037        # time_t is 32 bits on the ESP8266
+STEP      = 6*3600      # no two transitions are closer than this
+
+EPOCH = datetime.datetime(1970, 1, 1, tzinfo=datetime.timezone.utc)
+
+
+def offset(tz, t):
+    return int((EPOCH + datetime.timedelta(seconds=t)).astimezone(tz).utcoffset().total_seconds())
+
+
+def transitions(tz, start, end):
+    """offset at start and the (time, offset) of each change in [start, end)"""
+    result = []
+    t = start
+    current = offset(tz, t)
+    initial = current
+    while t < end:
+        n = min(t + STEP, end)
+        o = offset(tz, n)
+        if o != current:
+            # find the first second with the new offset
+            lo, hi = t, n
+            while hi - lo > 1:
+                mid = (lo + hi) // 2
+                if offset(tz, mid) == current:
+                    lo = mid
+                else:
+                    hi = mid
+            result.append((hi, o))
+            current = o
+        t = n
+    return initial, result
+
+
+def version(zoneinfo_dir):
+    try:
+        with open(os.path.join(zoneinfo_dir, "tzdata.zi")) as f:
+            line = f.readline().split()
+            if len(line) == 3 and line[1] == "version":
+                return line[2]
+    except IOError:
+        pass
+    return "unknown"
+
+
+def symbol(name):
+    return "tz_" + "".join(c if c.isalnum() else "_" for c in name)
+
+
+def minutes(name, seconds):
+    if seconds % 60:
+        sys.exit("%s: offset %d is not whole minutes!" % (name, seconds))
+    return seconds // 60
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compile tzdata into TZData transition tables")
+    parser.add_argument("-z", "--zoneinfo", default="/usr/share/zoneinfo", help="compiled tzdata directory")
+    parser.add_argument("-s", "--start", type=int, default=2024, help="first year in the tables")
+    parser.add_argument("-y", "--years", type=int, default=LAST_YEAR-2024+1, help="number of years in the tables")
+    parser.add_argument("-o", "--output", default=os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                                                "lib", "TZData", "src", "TZZones.cpp"))
+    parser.add_argument("zones", nargs="*", default=ZONES)
+    args = parser.parse_args()
+
+    if args.start + args.years - 1 > LAST_YEAR:
+        sys.exit("tables can't go past %d!" % LAST_YEAR)
+
+    zoneinfo.reset_tzpath([args.zoneinfo])
+    start = int((datetime.datetime(args.start, 1, 1, tzinfo=datetime.timezone.utc) - EPOCH).total_seconds())
+    end   = int((datetime.datetime(args.start + args.years, 1, 1, tzinfo=datetime.timezone.utc) - EPOCH).total_seconds())
+    tzversion = version(args.zoneinfo)
+
+    out = []
+    out.append("/*")
+    out.append(" * TZZones.cpp")
+    out.append(" *")
+    out.append(" * Generated by mktz.py from tzdata %s for %d thru %d - DO NOT EDIT!" %
+               (tzversion, args.start, args.start + args.years - 1))
+    out.append(" */")
+    out.append("")
+    out.append('#include "TZData.h"')
+    out.append("")
+    out.append('const char tz_version[] PROGMEM = "%s";' % tzversion)
+
+    entries = []
+    for name in sorted(args.zones):
+        if len(name) >= NAME_SIZE:
+            sys.exit("%s: name is longer than %d!" % (name, NAME_SIZE - 1))
+        initial, changes = transitions(zoneinfo.ZoneInfo(name), start, end)
+        sym = symbol(name)
+        out.append("")
+        out.append("// %s" % name)
+        out.append('static const char     %s_name[] PROGMEM = "%s";' % (sym, name))
+        if changes:
+            out.append("static const uint32_t %s_times[] PROGMEM = {" % sym)
+            for i in range(0, len(changes), 6):
+                out.append("    " + ", ".join("%u" % t for t, o in changes[i:i+6]) + ",")
+            out.append("};")
+        out.append("static const int16_t  %s_offsets[] PROGMEM = {" % sym)
+        offsets = [initial] + [o for t, o in changes]
+        for i in range(0, len(offsets), 12):
+            out.append("    " + ", ".join("%d" % minutes(name, o) for o in offsets[i:i+12]) + ",")
+        out.append("};")
+        entries.append("    { %s_name, %s, %s_offsets, %d }," %
+                       (sym, "%s_times" % sym if changes else "NULL", sym, len(changes)))
+
+    out.append("")
+    out.append("// sorted by name for TZData::find()")
+    out.append("const TimeZone tz_zones[] PROGMEM = {")
+    out.extend(entries)
+    out.append("};")
+    out.append("")
+    out.append("const uint16_t tz_zone_count = sizeof(tz_zones) / sizeof(tz_zones[0]);")
+    out.append("")
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+    print("%s: %d zones from tzdata %s" % (args.output, len(entries), tzversion))
+
+
+if __name__ == "__main__":
+    main()
@@ -20,9 +20,14 @@
  *      Author: liebman
  */
 
+#ifdef SYNCHROCLOCK_LOG_LEVEL
+#define LOGGER_LEVEL SYNCHROCLOCK_LOG_LEVEL
+#endif
+
 #include "SynchroClock.h"
 #include "SynchroClockVersion.h"
 #include <FS.h>
+#include <stddef.h>
 #include <time.h>
 #include <sys/time.h>
 #include <lwip/apps/sntp.h>
@@ -35,7 +40,6 @@
 //#define DISABLE_INITIAL_NTP
 //#define DISABLE_INITIAL_SYNC
 
-DLog&            dlog = DLog::getLog();
 Config           config;                    // configuration persisted in the EEPROM
 DeepSleepData    dsd;                       // data persisted in the RTC memory
 #if defined(LED_PIN)
@@ -43,15 +47,27 @@ FeedbackLED      feedback(LED_PIN);         // used to blink LED to indicate sta
 #endif
 ESP8266WebServer HTTP(80);                  // used when debugging/stay awake mode
 NTP              ntp(&(dsd.ntp_runtime), &(config.ntp_persist), &saveConfig);   // handles NTP communication & filtering
+NTPServer        ntp_server(&getTimeNoSync); // answers NTP requests in stay awake mode
 Clock            clk(SYNC_PIN);             // clock ticker, manages position of clock
 DS3231           rtc;                       // real time clock on i2c interface
+TimeBase         timebase;                  // sub-second time anchored to an RTC edge
 
 boolean save_config  = false; // used by wifi manager when settings were updated.
 boolean force_config = false; // reset handler sets this to force into config mode if button held
 boolean stay_awake   = false; // don't use deep sleep (from config mode option)
+boolean ntp_serve    = false; // answer NTP requests when staying awake (from config mode option)
 boolean url_update   = false; // set true of we got an update url
 
+ClockConfig clock_config;          // clock pulse config edited by the config portal, written back in one burst
+boolean     clock_config_valid = false; // clock_config was read from the clock
+
 char devicename[32];
+SyslogBuffer* syslog_buffer;       // queues log lines for syslog
+uint32_t wake_start_ms;            // millis() when setup() started
+uint16_t edge_retries;             // RTC reads retried by getEdgeSyncedTime()
+uint32_t wake_rtc_time;            // RTC time calibrateSleep() read, 0 if it couldn't
+uint32_t wake_rtc_ms;              // millis() when it did
+uint32_t ntp_sync_ms;              // millis() of the NTP server's last sync from NTP
 
 char message[128]; // buffer for http return values
 
@@ -79,6 +95,18 @@ uint8_t parseDuty(const char* value)
     return (uint8_t) i;
 }
 
+//
+// a clock pulse param, blank when the clock config could not be read
+//
+ConfigParamPtr createClockParam(WiFiManager& wifi, const char* id, const char* placeholder, uint8_t value, int length, void (*applyCB)(const char* result))
+{
+    if (!clock_config_valid)
+    {
+        return std::make_shared<ConfigParam>(wifi, id, placeholder, "", length, applyCB);
+    }
+    return std::make_shared<ConfigParam>(wifi, id, placeholder, value, length, applyCB);
+}
+
 int getValidOffset(String name)
 {
     int result = TimeUtils::parseOffset(HTTP.arg(name).c_str());
@@ -518,6 +546,352 @@ void handleErase()
     HTTP.send(200, "text/plain", "Erased!\n");
 }
 
+//
+// strict integer for /config, unlike the parse functions above a bad
+// value is an error rather than replaced with a default.
+//
+static bool parseRange(const char* value, bool quoted, long min, long max, long* result)
+{
+    char* end;
+    if (quoted || !*value)
+    {
+        return false;
+    }
+    long i = strtol(value, &end, 10);
+    if (*end || i < min || i > max)
+    {
+        return false;
+    }
+    *result = i;
+    return true;
+}
+
+static bool parseText(const char* value, bool quoted, char* result, size_t size)
+{
+    if (!quoted || strlen(value) >= size)
+    {
+        return false;
+    }
+    strcpy(result, value);
+    return true;
+}
+
+//
+// apply one /config member to the copies, the names are the config
+// portal's.  Returns false for an unknown name or invalid value.
+//
+static bool applyConfigMember(Config* c, ClockConfig* cc, const char* name, const char* value, bool quoted)
+{
+    long i;
+    if (!strcmp_P(name, PSTR("ntp_server")))
+    {
+        return *value && parseText(value, quoted, c->ntp_server, sizeof(c->ntp_server));
+    }
+    if (!strcmp_P(name, PSTR("syslog_host")))
+    {
+        return parseText(value, quoted, c->syslog_host, sizeof(c->syslog_host));
+    }
+    if (!strcmp_P(name, PSTR("tz_name")))
+    {
+        TimeZone zone;
+        if (*value && TZData::find(value, &zone))
+        {
+            return false;
+        }
+        return parseText(value, quoted, c->tz_name, sizeof(c->tz_name));
+    }
+
+    // the time changes, tc1_* and tc2_*
+    if (name[0] == 't' && name[1] == 'c' && name[2] >= '1' && name[2] < '1' + TIME_CHANGE_COUNT && name[3] == '_')
+    {
+        TimeChange* tc = &c->tc[name[2] - '1'];
+        const char* field = &name[4];
+        if (!strcmp_P(field, PSTR("occurrence")) && parseRange(value, quoted, -5, 5, &i) && i != 0)
+        {
+            tc->occurrence = i;
+        }
+        else if (!strcmp_P(field, PSTR("day_of_week")) && parseRange(value, quoted, 0, 6, &i))
+        {
+            tc->day_of_week = i;
+        }
+        else if (!strcmp_P(field, PSTR("day_offset")) && parseRange(value, quoted, -7, 7, &i))
+        {
+            tc->day_offset = i;
+        }
+        else if (!strcmp_P(field, PSTR("month")) && parseRange(value, quoted, 0, 12, &i))
+        {
+            tc->month = i;
+        }
+        else if (!strcmp_P(field, PSTR("hour")) && parseRange(value, quoted, 0, 23, &i))
+        {
+            tc->hour = i;
+        }
+        else if (!strcmp_P(field, PSTR("offset")) && parseRange(value, quoted, -43200, 50400, &i))
+        {
+            tc->tz_offset = i;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    if (!strcmp_P(name, PSTR("sleep_duration")) && parseRange(value, quoted, 1, INT32_MAX, &i))
+    {
+        c->sleep_duration = i;
+    }
+    else if (!strcmp_P(name, PSTR("tz_offset")) && parseRange(value, quoted, -43200, 50400, &i))
+    {
+        c->tz_offset = i;
+    }
+    else if (!strcmp_P(name, PSTR("syslog_port")) && parseRange(value, quoted, 0, 65535, &i))
+    {
+        c->syslog_port = i;
+    }
+    else if (!strcmp_P(name, PSTR("tp_duration")) && parseRange(value, quoted, 0, 255, &i))
+    {
+        cc->tp_duration = i;
+    }
+    else if (!strcmp_P(name, PSTR("tp_duty")) && parseRange(value, quoted, 1, 100, &i))
+    {
+        cc->tp_duty = i;
+    }
+    else if (!strcmp_P(name, PSTR("ap_duration")) && parseRange(value, quoted, 0, 255, &i))
+    {
+        cc->ap_duration = i;
+    }
+    else if (!strcmp_P(name, PSTR("ap_duty")) && parseRange(value, quoted, 1, 100, &i))
+    {
+        cc->ap_duty = i;
+    }
+    else if (!strcmp_P(name, PSTR("ap_delay")) && parseRange(value, quoted, 0, 255, &i))
+    {
+        cc->ap_delay = i;
+    }
+    else if (!strcmp_P(name, PSTR("ap_start")) && parseRange(value, quoted, 0, 255, &i))
+    {
+        cc->ap_start_duration = i;
+    }
+    else if (!strcmp_P(name, PSTR("pwm_top")) && parseRange(value, quoted, 0, 255, &i))
+    {
+        cc->pwm_top = i;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static void writeConfigJson(String& out, const Config* c, const ClockConfig* cc)
+{
+    static PROGMEM const char tc_names[TIME_CHANGE_COUNT][6][16] = {
+        { "tc1_occurrence", "tc1_day_of_week", "tc1_day_offset", "tc1_month", "tc1_hour", "tc1_offset" },
+        { "tc2_occurrence", "tc2_day_of_week", "tc2_day_offset", "tc2_month", "tc2_hour", "tc2_offset" },
+    };
+    JsonWriter json(out);
+    json.begin();
+    json.addString(PSTR("ntp_server"), c->ntp_server);
+    json.addString(PSTR("tz_name"), c->tz_name);
+    json.addNumber(PSTR("tz_offset"), c->tz_offset);
+    for (int n = 0; n < TIME_CHANGE_COUNT; ++n)
+    {
+        const TimeChange* tc = &c->tc[n];
+        json.addNumber(tc_names[n][0], tc->occurrence);
+        json.addNumber(tc_names[n][1], tc->day_of_week);
+        json.addNumber(tc_names[n][2], tc->day_offset);
+        json.addNumber(tc_names[n][3], tc->month);
+        json.addNumber(tc_names[n][4], tc->hour);
+        json.addNumber(tc_names[n][5], tc->tz_offset);
+    }
+    json.addNumber(PSTR("sleep_duration"), c->sleep_duration);
+    json.addString(PSTR("syslog_host"), c->syslog_host);
+    json.addNumber(PSTR("syslog_port"), c->syslog_port);
+    json.addNumber(PSTR("tp_duration"), cc->tp_duration);
+    json.addNumber(PSTR("tp_duty"), cc->tp_duty);
+    json.addNumber(PSTR("ap_start"), cc->ap_start_duration);
+    json.addNumber(PSTR("ap_duration"), cc->ap_duration);
+    json.addNumber(PSTR("ap_duty"), cc->ap_duty);
+    json.addNumber(PSTR("ap_delay"), cc->ap_delay);
+    json.addNumber(PSTR("pwm_top"), cc->pwm_top);
+    json.end();
+}
+
+static void sendConfigError(int code, const char* error)
+{
+    String out;
+    JsonWriter json(out);
+    json.begin();
+    json.addString(PSTR("error"), error);
+    json.end();
+    HTTP.send(code, "application/json", out);
+}
+
+//
+// the whole configuration, Config and the clock controller settings, as
+// one JSON object.
+//
+void handleConfig()
+{
+    ClockConfig cc;
+    if (clk.readConfig(&cc))
+    {
+        sendConfigError(500, "failed to read clock config");
+        return;
+    }
+    String out;
+    out.reserve(640);
+    writeConfigJson(out, &config, &cc);
+    HTTP.send(200, "application/json", out);
+}
+
+//
+// apply any subset of the /config members.  Every member is validated
+// before anything is changed, then the clock controller is written in one
+// burst and the flash is committed once.
+//
+void handleConfigPost()
+{
+    static PROGMEM const char TAG[] = "handleConfigPost";
+
+    Config      c = config;
+    ClockConfig cc;
+    if (clk.readConfig(&cc))
+    {
+        sendConfigError(500, "failed to read clock config");
+        return;
+    }
+    ClockConfig old_cc = cc;
+
+    String invalid;
+    int result = JsonReader::parse(HTTP.arg("plain").c_str(), [&](const char* name, const char* value, bool quoted)
+    {
+        if (!applyConfigMember(&c, &cc, name, value, quoted))
+        {
+            invalid += invalid.length() ? " " : "invalid: ";
+            invalid += name;
+        }
+    });
+    if (result)
+    {
+        sendConfigError(400, "bad JSON object");
+        return;
+    }
+    if (invalid.length())
+    {
+        dlog.warning(FPSTR(TAG), F("%s"), invalid.c_str());
+        sendConfigError(400, invalid.c_str());
+        return;
+    }
+
+    if (memcmp(&cc, &old_cc, sizeof(cc)))
+    {
+        dlog.info(FPSTR(TAG), F("writing clock config"));
+        if (clk.writeConfig(&cc) || clk.saveConfig())
+        {
+            dlog.error(FPSTR(TAG), F("failed to write clock config!"));
+            sendConfigError(500, "failed to write clock config");
+            return;
+        }
+        clock_config       = cc;
+        clock_config_valid = true;
+    }
+
+    if (memcmp(&c, &config, sizeof(c)))
+    {
+        dlog.info(FPSTR(TAG), F("saving config"));
+        config = c;
+        // a new zone or rules recomputes the offset, which saves the config if it changed
+        if (!updateTZOffset())
+        {
+            saveConfig();
+        }
+    }
+
+    String out;
+    out.reserve(640);
+    writeConfigJson(out, &config, &cc);
+    HTTP.send(200, "application/json", out);
+}
+
+//
+// Prometheus text format, the counters from RTC memory plus this wake's
+// I2C counts (they are added to RTC memory when we sleep) and the NTP state.
+//
+void handleMetrics()
+{
+    MetricsData m = dsd.metrics;
+    Metrics::recordI2C(&m, clk.getRetryCount() + edge_retries, WireUtils.getClearCount());
+    Metrics::recordHeap(&m, ESP.getFreeHeap());
+
+    String out;
+    out.reserve(3072);
+    Metrics::write(&m, out);
+    Metrics::writeGauge(out, PSTR("synchroclock_heap_free_bytes"), PSTR("Free heap now."), ESP.getFreeHeap());
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_reach"), PSTR("NTP reachability shift register."), dsd.ntp_runtime.reach);
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_drift_ppm"), PSTR("RTC drift from the NTP adjustments."), config.ntp_persist.drift);
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_drift_estimate"), PSTR("Drift estimate used for the poll interval."),
+            dsd.ntp_runtime.drift_estimate);
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_poll_interval_estimate_seconds"), PSTR("Poll interval from the drift estimate."),
+            dsd.ntp_runtime.poll_interval);
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_delay_mean_seconds"), PSTR("Mean delay of the NTP samples."),
+            dsd.ntp_runtime.delay_mean);
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_delay_stddev_seconds"), PSTR("Delay standard deviation of the NTP samples."),
+            dsd.ntp_runtime.delay_stddev);
+    Metrics::writeGauge(out, PSTR("synchroclock_sleep_calibration"), PSTR("RTC seconds per deep sleep timer second."),
+            dsd.sleep_cal);
+    Metrics::writeGauge(out, PSTR("synchroclock_idle_wakes"), PSTR("Stay awake idles ended by a received frame."),
+            NetWake::getWakes());
+    Metrics::writeGauge(out, PSTR("synchroclock_idle_timeouts"), PSTR("Stay awake idles that ran their full length."),
+            NetWake::getTimeouts());
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_server_requests"), PSTR("Requests to the stay awake NTP server."),
+            ntp_server.getRequests());
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_server_replies"), PSTR("Replies from the stay awake NTP server."),
+            ntp_server.getReplies());
+    HTTP.send(200, "text/plain; version=0.0.4", out);
+}
+
+#ifdef LOG_BINARY
+//
+// download the binary log for logdecode.py, "old=true" gets the rotated one.
+//
+void handleLog()
+{
+    BinaryLog::flush();
+    const char* name = HTTP.hasArg("old") && getValidBoolean("old") ? BINARY_LOG_OLD_FILE : BINARY_LOG_FILE;
+    File f = SPIFFS.open(name, "r");
+    if (!f)
+    {
+        HTTP.send(404, "text/plain", "no log!\n");
+        return;
+    }
+    HTTP.streamFile(f, "application/octet-stream");
+    f.close();
+}
+#endif
+
+
+//
+// the offset in effect at when from the time zone if one is set, else the
+// time changes.  offset is the one in effect before when.
+//
+int computeTZOffset(uint32_t when, int offset, time_t* next_change)
+{
+    static PROGMEM const char TAG[] = "computeTZOffset";
+
+    TimeZone zone;
+    if (config.tz_name[0] && TZData::find(config.tz_name, &zone) == 0)
+    {
+        return TimeUtils::computeUTCOffset(when, &zone, next_change);
+    }
+
+    if (config.tz_name[0])
+    {
+        dlog.warning(FPSTR(TAG), F("unknown time zone '%s', using the time changes"), config.tz_name);
+    }
+    return TimeUtils::computeUTCOffset(when, offset, config.tc, TIME_CHANGE_COUNT, next_change);
+}
 
 //
 // update the timezone offset based on the current date/time
@@ -527,14 +901,42 @@ bool updateTZOffset()
 {
     static PROGMEM const char TAG[] = "updateTZOffset";
 
-    DS3231DateTime dt;
-    if (rtc.readTime(dt))
+    uint32_t now;
+    if (timebase.isValid())
+    {
+        timebase.now(&now, NULL);
+    }
+    else
     {
-        dlog.error(FPSTR(TAG), F("updateTZOffset: FAILED to read RTC"));
+        DS3231DateTime dt;
+        if (rtc.readTime(dt))
+        {
+            dlog.error(FPSTR(TAG), F("updateTZOffset: FAILED to read RTC"));
+            return false;
+        }
+        now = dt.getUnixTime();
+    }
+
+    //
+    // the offset only changes at a time change, until the next one (and as
+    // long as the zone/rules and offset are the ones it was computed from)
+    // there is nothing to do.  No next change (a zone without DST) is good
+    // forever.
+    //
+    uint32_t tc_crc = config.tz_name[0] ? calculateCRC32((const uint8_t*)config.tz_name, strlen(config.tz_name))
+                                        : calculateCRC32((const uint8_t*)config.tc, sizeof(config.tc));
+    if ((dsd.tz_change == 0 || now < dsd.tz_change) && dsd.tz_offset == config.tz_offset && dsd.tz_crc == tc_crc)
+    {
+        dlog.debug(FPSTR(TAG), F("offset %d good until %lu"), config.tz_offset, dsd.tz_change);
         return false;
     }
 
-    int new_offset = TimeUtils::computeUTCOffset(dt.getUnixTime(), config.tz_offset, config.tc, TIME_CHANGE_COUNT);
+    time_t next_change;
+    int new_offset = computeTZOffset(now, config.tz_offset, &next_change);
+    dsd.tz_change = next_change > (time_t)now ? next_change : 0;
+    dsd.tz_offset = new_offset;
+    dsd.tz_crc    = tc_crc;
+    dlog.info(FPSTR(TAG), F("offset %d until next time change at %lu"), new_offset, dsd.tz_change);
 
     // if the time zone changed then save the new value and return true
     if (config.tz_offset != new_offset)
@@ -601,6 +1003,18 @@ void createWiFiParams(WiFiManager& wifi, std::vector<ConfigParamPtr> &params)
         uf.close();
         url_update = true;
     }));
+    params.push_back(std::make_shared<ConfigParam>(wifi, "<p>Time Zone (blank to use the time changes)</p>"));
+    params.push_back(std::make_shared<ConfigParam>(wifi, "tz_name", "Time Zone (America/New_York)", config.tz_name, 31, [](const char* result)
+    {
+        TimeZone zone;
+        if (strlen(result) && TZData::find(result, &zone))
+        {
+            dlog.error(FPSTR(TAG), F("unknown time zone '%s', keeping '%s'!"), result, config.tz_name);
+            return;
+        }
+        strncpy(config.tz_name, result, sizeof(config.tz_name) - 1);
+    }));
+
     params.push_back(std::make_shared<ConfigParam>(wifi, "<p>1st Time Change</p>"));
     params.push_back(std::make_shared<ConfigParam>(wifi, "tc1_occurrence", "occurrence", config.tc[0].occurrence, 3, [](const char* result)
     {
@@ -659,46 +1073,75 @@ void createWiFiParams(WiFiManager& wifi, std::vector<ConfigParamPtr> &params)
     {
         stay_awake = parseBoolean(result);
     }));
+    params.push_back(std::make_shared<ConfigParam>(wifi, "ntp_serve", "Serve NTP 'true'", "", 8, [](const char* result)
+    {
+        ntp_serve = parseBoolean(result);
+    }));
     params.push_back(std::make_shared<ConfigParam>(wifi, "sleep_duration", "Sleep", config.sleep_duration, 8, [](const char* result)
     {
         config.sleep_duration = atoi(result);
     }));
-    uint8_t value;
-    clk.readTPDuration(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "tp_duration", "Tick Pulse", value, 8, [](const char* result)
+    clock_config_valid = false;
+    for (int i = 0; i < CLOCK_CONFIG_RETRIES && !clock_config_valid; ++i)
+    {
+        clock_config_valid = clk.readConfig(&clock_config) == 0;
+    }
+    if (!clock_config_valid)
+    {
+        //
+        // don't show made up values, leave the pulse fields blank and write
+        // just the ones that get filled in one register at a time.
+        //
+        dlog.error(FPSTR(TAG), F("failed to read clock config!"));
+        params.push_back(std::make_shared<ConfigParam>(wifi, "<p>Failed to read the clock pulse settings, only the ones entered below are written!</p>"));
+    }
+    params.push_back(createClockParam(wifi, "tp_duration", "Tick Pulse", clock_config.tp_duration, 8, [](const char* result)
     {
-        uint8_t tp_duration = TimeUtils::parseSmallDuration(result);
-        clk.writeTPDuration(tp_duration);
+        clock_config.tp_duration = TimeUtils::parseSmallDuration(result);
+        if (!clock_config_valid)
+        {
+            clk.writeTPDuration(clock_config.tp_duration);
+        }
     }));
-    clk.readTPDuty(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "tp_duty", "Tick Pulse Duty", value, 8, [](const char* result)
+    params.push_back(createClockParam(wifi, "tp_duty", "Tick Pulse Duty", clock_config.tp_duty, 8, [](const char* result)
     {
-        uint8_t tp_duty = parseDuty(result);
-        clk.writeTPDuty(tp_duty);
+        clock_config.tp_duty = parseDuty(result);
+        if (!clock_config_valid)
+        {
+            clk.writeTPDuty(clock_config.tp_duty);
+        }
     }));
-    clk.readAPStartDuration(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "ap_start", "Adjust Start Pulse", value, 4, [](const char* result)
+    params.push_back(createClockParam(wifi, "ap_start", "Adjust Start Pulse", clock_config.ap_start_duration, 4, [](const char* result)
     {
-        uint8_t ap_start = TimeUtils::parseSmallDuration(result);
-        clk.writeAPStartDuration(ap_start);
+        clock_config.ap_start_duration = TimeUtils::parseSmallDuration(result);
+        if (!clock_config_valid)
+        {
+            clk.writeAPStartDuration(clock_config.ap_start_duration);
+        }
     }));
-    clk.readAPDuration(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "ap_duration", "Adjust Pulse", value, 4, [](const char* result)
+    params.push_back(createClockParam(wifi, "ap_duration", "Adjust Pulse", clock_config.ap_duration, 4, [](const char* result)
     {
-        uint8_t ap_duration = TimeUtils::parseSmallDuration(result);
-        clk.writeAPDuration(ap_duration);
+        clock_config.ap_duration = TimeUtils::parseSmallDuration(result);
+        if (!clock_config_valid)
+        {
+            clk.writeAPDuration(clock_config.ap_duration);
+        }
     }));
-    clk.readAPDuty(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "ap_duty", "Adjust Pulse Duty", value, 8, [](const char* result)
+    params.push_back(createClockParam(wifi, "ap_duty", "Adjust Pulse Duty", clock_config.ap_duty, 8, [](const char* result)
     {
-        uint8_t ap_duty = parseDuty(result);
-        clk.writeAPDuty(ap_duty);
+        clock_config.ap_duty = parseDuty(result);
+        if (!clock_config_valid)
+        {
+            clk.writeAPDuty(clock_config.ap_duty);
+        }
     }));
-    clk.readAPDelay(&value);
-    params.push_back(std::make_shared<ConfigParam>(wifi, "ap_delay", "Adjust Delay", value, 4, [](const char* result)
+    params.push_back(createClockParam(wifi, "ap_delay", "Adjust Delay", clock_config.ap_delay, 4, [](const char* result)
     {
-        uint8_t ap_delay = TimeUtils::parseSmallDuration(result);
-        clk.writeAPDelay(ap_delay);
+        clock_config.ap_delay = TimeUtils::parseSmallDuration(result);
+        if (!clock_config_valid)
+        {
+            clk.writeAPDelay(clock_config.ap_delay);
+        }
     }));
     params.push_back(std::make_shared<ConfigParam>(wifi, "syslog_host", "Syslog Host", config.syslog_host, 32, [](const char* result)
     {
@@ -788,6 +1231,12 @@ bool initWiFi()
             p->applyIfChanged();
         }
 
+        // all the clock pulse settings go over in a single burst, the params
+        // already wrote them one at a time if the clock config could not be read
+        if (clock_config_valid && clk.writeConfig(&clock_config))
+        {
+            dlog.error(FPSTR(TAG), F("failed to write clock config!"));
+        }
         clk.saveConfig();
         saveConfig();
         updateTZOffset();
@@ -798,9 +1247,8 @@ bool initWiFi()
     // Configure syslog logging if enabled
     if (strlen(config.syslog_host) && config.syslog_port)
     {
-        dlog.begin(new DLogSyslogWriter(config.syslog_host, config.syslog_port, devicename, SYNCHRO_CLOCK_VERSION));
+        syslog_buffer->begin(config.syslog_host, config.syslog_port, devicename, SYNCHRO_CLOCK_VERSION);
         dlog.info(FPSTR(TAG), F("starting syslog to '%s:%d'"), config.syslog_host, config.syslog_port);
-        delay(200); // delay so ARP usually finishes before we overrun the UDP transmit buffers (maybe?)
     }
 
     return true;
@@ -883,6 +1331,8 @@ void processOTA(bool enable_clock)
         SPIFFS.remove(UPDATE_URL_FILENAME);
         // need to set system time so that TLS validation can happen
         setSystemTime();
+        // TLS is the heaviest thing we ever do, run it at full speed (no i2c until we are back at 80MHz)
+        CpuGovernor::phase(CPU_PHASE_OTA);
         dlog.info(FPSTR(TAG), F("checking for OTA from: '%s'"), url);
         feedback.blink(FEEDBACK_LED_MEDIUM);
 
@@ -915,9 +1365,22 @@ void processOTA(bool enable_clock)
 
         dlog.info(FPSTR(TAG), F("free mem: %u"), ESP.getFreeHeap());
         dlog.info(FPSTR(TAG), F("starting update with client: 0x%08x"), (unsigned int)client);
-        ret = ESPhttpUpdate.update(*client, url, SYNCHRO_CLOCK_VERSION);
+        String reason;
+        size_t urllen = strlen(url);
+        if (urllen > 6 && !strcmp_P(&url[urllen - 6], PSTR(".delta")))
+        {
+            // a patch against this image, resumed with a Range request if the transfer is interrupted
+            ret    = DeltaOTA::update(*client, url) ? HTTP_UPDATE_FAILED : HTTP_UPDATE_OK;
+            reason = "delta update failed";
+        }
+        else
+        {
+            ret    = ESPhttpUpdate.update(*client, url, SYNCHRO_CLOCK_VERSION);
+            reason = ESPhttpUpdate.getLastErrorString();
+        }
 
-        String reason = ESPhttpUpdate.getLastErrorString();
+        // back to 80MHz, the i2c timing to the controller is built for it
+        CpuGovernor::phase(CPU_PHASE_CLOCK);
 
         switch(ret)
         {
@@ -956,10 +1419,10 @@ void factoryReset()
         dlog.error(FPSTR(TAG), F("can't talk with Clock Controller!"));
         while (WireUtils.clearBus())
         {
-            delay(10000);
+            Wait::ms(10000);
             dlog.info(FPSTR(TAG), F("lets try that again..."));
         }
-        delay(10000);
+        Wait::ms(10000);
 
     }
     feedback.off();
@@ -977,7 +1440,7 @@ void factoryReset()
     //
     // delay one second then restart!
     //
-    delay(1000);
+    Wait::ms(1000);
 
     ESP.restart();
     while(true)
@@ -1001,9 +1464,12 @@ void setup()
 {
     static PROGMEM const char TAG[] = "setup";
     uint32_t free_mem = ESP.getFreeHeap();
+    wake_start_ms = millis();
 
     Serial.begin(76800); // use the default baud rate that the ESPs SDK uses
     dlog.begin(new DLogPrintWriter(Serial));
+    syslog_buffer = new SyslogBuffer();  // sent before sleeping if syslog is configured
+    dlog.begin(syslog_buffer);
     dlog.setPreFunc(&dlogPrefix);
 #ifdef NTP_LOG_LEVEL
     dlog.setLevel(F("NTP"), NTP_LOG_LEVEL);
@@ -1024,6 +1490,8 @@ void setup()
     //
     memset(&dsd, 0, sizeof(dsd));
     readDeepSleepData();
+    CpuGovernor::begin(dsd.sleep_delay_left == 0); // the radio is disabled for the rest of a long sleep
+    Wait::begin(dsd.sleep_delay_left == 0);
 
     Wire.begin();
     Wire.setClockStretchLimit(CLOCK_STRETCH_LIMIT);
@@ -1040,43 +1508,29 @@ void setup()
     //
 
     dlog.info(FPSTR(TAG), F("starting clock interface"));
-    while (clk.begin(3) != 0)
+    ClockSnapshot snapshot;
+    while (clk.readSnapshot(&snapshot, 3) != 0)
     {
         dlog.error(FPSTR(TAG), F("can't talk with Clock Controller!"));
-        delay(10000);
+        Wait::ms(10000);
     }
 
-    uint8_t version = 0;
-    while (clk.readVersion(&version, 3) != 0)
-    {
-        dlog.error(FPSTR(TAG), F("can't read clock version!"));
-        delay(10000);
-    }
+    uint8_t version = snapshot.version;
     dlog.info(FPSTR(TAG), F("I2CAnalogClock VERSION: %u"), version);
 
     struct rst_info * reset_info = ESP.getResetInfoPtr();
     dlog.info(FPSTR(TAG), F("Reset reason: %lu '%s'"), reset_info->reason, ESP.getResetReason().c_str());
 
-    uint8_t clk_reason; // restart reason of clk
-    while (clk.readResetReason(&clk_reason, 3) != 0)
-    {
-        dlog.error(FPSTR(TAG), F("can't read clock reset reason!"));
-        delay(10000);
-    }
-    dlog.info(FPSTR(TAG), F("I2CAnalogClock restart reason: 0x%02x"), clk_reason);
+    dlog.info(FPSTR(TAG), F("I2CAnalogClock restart reason: 0x%02x"), snapshot.reset_reason);
 
-    uint16_t pos;
-    while (clk.readPosition(&pos, 3))
-    {
-        dlog.error(FPSTR(TAG), F("can't read clock position!"));
-        delay(10000);
-    }
+    uint16_t pos = snapshot.position;
     int hours = pos / 3600;
     int minutes = (pos - (hours * 3600)) / 60;
     int seconds = pos - (hours * 3600) - (minutes * 60);
-    dlog.info(FPSTR(TAG), F("clock position: %d (%02d:%02d:%02d)"), pos, hours, minutes, seconds);
+    dlog.info(FPSTR(TAG), F("clock position: %d (%02d:%02d:%02d) adjustment: %u"), pos, hours, minutes, seconds, snapshot.adjustment);
 
-    bool clock_was_enabled = clk.getEnable();
+    bool clock_was_enabled = (snapshot.control & BIT_ENABLE) == BIT_ENABLE;
+    bool enabled = clock_was_enabled;
     dlog.info(FPSTR(TAG), F("clock interface started, enabled:%s"), clock_was_enabled ? "true" : "false");
 
     // if the reset/config button is pressed then force config
@@ -1091,6 +1545,7 @@ void setup()
             dlog.info(FPSTR(TAG), F("reset button pressed with radio off, short sleep to enable!"));
             dlog.end();
             dsd.sleep_delay_left = 0;
+            dsd.sleep_start      = 0;
             writeDeepSleepData();
             ESP.deepSleep(300000, RF_DEFAULT); // short sleep to enable the radio!
         }
@@ -1111,6 +1566,7 @@ void setup()
                 //
                 clk.writeAdjustment(0);
                 clk.setEnable(false);
+                enabled = false;
 
                 // reset the start and continue for factory reset delay
                 start += delta;
@@ -1131,12 +1587,13 @@ void setup()
 
     }
 
-    bool enabled = clk.getEnable();
     dlog.info(FPSTR(TAG), F("clock enable is:%u"), enabled);
 
     strncpy_P(config.ntp_server, PSTR(DEFAULT_NTP_SERVER), sizeof(config.ntp_server) - 1);
     config.ntp_server[sizeof(config.ntp_server) - 1] = 0;
 
+    strncpy_P(config.tz_name, PSTR(DEFAULT_TZ_NAME), sizeof(config.tz_name) - 1);
+
     // Default to disabled (all tz_offsets = 0)
     config.tc[0].occurrence  = DEFAULT_TC0_OCCUR;
     config.tc[0].day_of_week = DEFAULT_TC0_DOW;
@@ -1174,8 +1631,8 @@ void setup()
     }
 #endif
 
-    dlog.info(FPSTR(TAG), F("config: tz:%d ntp:%s logging: %s:%d"), config.tz_offset,
-            config.ntp_server, config.syslog_host, config.syslog_port);
+    dlog.info(FPSTR(TAG), F("config: tz:%d zone:'%s' ntp:%s logging: %s:%d"), config.tz_offset,
+            config.tz_name, config.ntp_server, config.syslog_host, config.syslog_port);
 
     dlog.info(FPSTR(TAG), F("starting RTC"));
     while (rtc.begin())
@@ -1184,12 +1641,14 @@ void setup()
 
         while (WireUtils.clearBus())
         {
-            delay(10000);
+            Wait::ms(10000);
             dlog.info(FPSTR(TAG), F("lets try that again..."));
         }
-        delay(1000);
+        Wait::ms(1000);
     }
 
+    calibrateSleep();
+
     bool clock_needs_sync = updateTZOffset();
 
 #if defined(USE_DRIFT)
@@ -1208,6 +1667,7 @@ void setup()
     {
         if (clock_needs_sync)
         {
+            CpuGovernor::phase(CPU_PHASE_CLOCK);
             setCLKfromRTC();
         }
 
@@ -1221,6 +1681,7 @@ void setup()
     }
 #endif
 
+    CpuGovernor::phase(CPU_PHASE_WIFI);
     if (!initWiFi())
     {
         //
@@ -1229,6 +1690,7 @@ void setup()
         //
         if (enabled)
         {
+            CpuGovernor::phase(CPU_PHASE_CLOCK);
             setCLKfromRTC();
         }
 
@@ -1260,11 +1722,13 @@ void setup()
     }
 
 #if !defined(DISABLE_INITIAL_NTP)
+    CpuGovernor::phase(CPU_PHASE_NTP);
     dlog.info(FPSTR(TAG), F("syncing RTC from NTP!"));
     setRTCfromNTP(config.ntp_server, true, NULL, NULL);
 #endif
 
 #if !defined(DISABLE_INITIAL_SYNC)
+    CpuGovernor::phase(CPU_PHASE_CLOCK);
     dlog.info(FPSTR(TAG), F("syncing clock to RTC!"));
     setCLKfromRTC();
 #endif
@@ -1275,13 +1739,12 @@ void setup()
 
     if (!stay_awake)
     {
-#if defined(USE_NTP_POLL_ESTIMATE)
-        sleepFor(ntp.getPollInterval());
-#else
-        sleepFor(config.sleep_duration);
-#endif
+        uint32_t interval = getPollInterval();
+        Metrics::recordPoll(&dsd.metrics, interval);
+        sleepFor(interval);
     }
 
+    CpuGovernor::phase(CPU_PHASE_IDLE);
     dlog.info(FPSTR(TAG), F("starting HTTP"));
     HTTP.on("/offset",      HTTP_GET, handleOffset);
     HTTP.on("/adjust",      HTTP_GET, handleAdjustment);
@@ -1299,64 +1762,182 @@ void setup()
     HTTP.on("/erase",       HTTP_GET, handleErase);
     HTTP.on("/ap_start",    HTTP_GET, handleAPStartDuration);
     HTTP.on("/pwm_top",     HTTP_GET, handlePWMTop);
+    HTTP.on("/config",      HTTP_GET, handleConfig);
+    HTTP.on("/config",      HTTP_POST, handleConfigPost);
+    HTTP.on("/metrics",     HTTP_GET, handleMetrics);
+#ifdef LOG_BINARY
+    HTTP.on("/log",         HTTP_GET, handleLog);
+#endif
     HTTP.begin();
+    //
+    // light sleep holds requests at the access point until the next DTIM
+    // beacon but not our replies, NTP clients would see that as an offset.
+    //
+    NetWake::begin(NET_WAKE_LISTEN_INTERVAL, !ntp_serve);
+    if (ntp_serve)
+    {
+        ntp_server.begin(NTP_PORT);
+        ntp_sync_ms = millis();
+    }
+}
+
+uint32_t getPollInterval()
+{
+#if defined(USE_NTP_POLL_ESTIMATE)
+    return ntp.getPollInterval();
+#else
+    return config.sleep_duration;
+#endif
 }
 
 void sleepFor(uint32_t sleep_duration)
 {
     static PROGMEM const char TAG[] = "sleepFor";
 
+    stageTimeChange();
+
+    CpuGovernor::phase(CPU_PHASE_LOG);
     dlog.info(FPSTR(TAG), F("seconds: %u"), sleep_duration);
+
+    //
+    // the end of the sleep is kept as an RTC time so calibrateSleep() can
+    // take what is left from the RTC at each wake along the way.  Whole
+    // seconds are plenty, the RTC time from the start of the wake saves a
+    // read unless NTP just set it.
+    //
+    dsd.sleep_start = 0;
+    if (timebase.isValid())
+    {
+        timebase.now(&dsd.sleep_start, NULL);
+    }
+    else if (wake_rtc_time != 0)
+    {
+        dsd.sleep_start = wake_rtc_time + (millis() - wake_rtc_ms) / 1000;
+    }
+    dsd.sleep_until = dsd.sleep_start != 0 ? dsd.sleep_start + sleep_duration : 0;
+
+    //
+    // the longest the deep sleep timer can go, in RTC seconds, cut short
+    // to wake DST_WAKE_LEAD before a time change that comes first.
+    //
+    float    cal   = dsd.sleep_cal != 0.0 ? dsd.sleep_cal : 1.0;
+    uint32_t chunk = ESP.deepSleepMax() / 1000000 * cal;
+    if (dsd.tz_change != 0 && dsd.sleep_start != 0 && dsd.tz_change > dsd.sleep_start + DST_STAGE_WINDOW
+        && dsd.tz_change - DST_WAKE_LEAD < dsd.sleep_until && dsd.tz_change - DST_WAKE_LEAD - dsd.sleep_start < chunk)
+    {
+        chunk = dsd.tz_change - DST_WAKE_LEAD - dsd.sleep_start;
+        dlog.info(FPSTR(TAG), F("waking %lus before the time change at %lu"), DST_WAKE_LEAD, dsd.tz_change);
+    }
+
     dsd.sleep_delay_left = sleep_duration;
-    sleep_duration = MAX_SLEEP_DURATION;
     RFMode mode = RF_NO_CAL;
-    if (dsd.sleep_delay_left > MAX_SLEEP_DURATION)
+    if (dsd.sleep_delay_left > chunk)
     {
-        dsd.sleep_delay_left = dsd.sleep_delay_left - MAX_SLEEP_DURATION;
+        sleep_duration = chunk;
+        dsd.sleep_delay_left = dsd.sleep_delay_left - chunk;
         mode = RF_DISABLED;
-        dlog.info(FPSTR(TAG), F("sleep_duration > max, mode=DISABLED sleep_delay_left=%lu"), dsd.sleep_delay_left);
+        dlog.info(FPSTR(TAG), F("sleep_duration > max %lu, mode=DISABLED sleep_delay_left=%lu"), chunk, dsd.sleep_delay_left);
     }
     else
     {
-        sleep_duration = dsd.sleep_delay_left;
         dsd.sleep_delay_left = 0;
         dlog.info(FPSTR(TAG), F("delay less than max, mode=DEFAULT sleep_delay_left=%lu"), dsd.sleep_delay_left);
     }
 
-    uint64_t sleep_us = (uint64_t)sleep_duration * 1000000L;
+    dsd.sleep_timer_ms = sleep_duration * 1000.0 / cal;
+    uint64_t sleep_us  = (uint64_t)dsd.sleep_timer_ms * 1000;
 
+    Metrics::recordWake(&dsd.metrics, millis() - wake_start_ms, ESP.getFreeHeap());
+    Metrics::recordI2C(&dsd.metrics, clk.getRetryCount() + edge_retries, WireUtils.getClearCount());
     writeDeepSleepData();
 
-    dlog.info(FPSTR(TAG), F("Deep Sleep Time: %u"), sleep_duration);
+    dlog.info(FPSTR(TAG), F("Deep Sleep Time: %u (timer %lums calibration %.5f)"), sleep_duration, dsd.sleep_timer_ms, cal);
+    CpuGovernor::report();
+    Wait::report();
     dlog.end();
     ESP.deepSleep(sleep_us, mode);
 }
 
 void loop()
 {
+    uint32_t idle_ms = NET_WAKE_IDLE_MS;
     if (stay_awake)
     {
+        if (ntp_serve)
+        {
+            idle_ms = serveNTP();
+        }
         HTTP.handleClient();
+        syslog_buffer->flush();
+    }
+    NetWake::idle(idle_ms);
+}
+
+//
+// stay awake NTP server: answer the requests waiting (before http, their
+// receive time is taken when we get to them), sync the RTC from our own
+// NTP server each poll interval and keep the timebase anchored to a recent
+// RTC edge.  Waiting for the edge blocks, so that waits until the edge is
+// due and loop() idles until then.  Returns how long loop() can idle.
+//
+uint32_t serveNTP()
+{
+    static PROGMEM const char TAG[] = "serveNTP";
+
+    ntp_server.handle();
+
+    if (millis() - ntp_sync_ms >= getPollInterval() * 1000)
+    {
+        ntp_sync_ms = millis();
+        dlog.info(FPSTR(TAG), F("syncing RTC from NTP!"));
+        if (setRTCfromNTP(config.ntp_server, true, NULL, NULL) == 0)
+        {
+            setCLKfromRTC();
+        }
+        ntp_server.handle();
+    }
+
+    if (!timebase.isValid())
+    {
+        syncTimeBase();
+        return NET_WAKE_IDLE_MS;
     }
-    delay(100);
+
+    if (timebase.getAge() < NTP_SERVE_ANCHOR_AGE)
+    {
+        return NET_WAKE_IDLE_MS;
+    }
+
+    uint32_t now_s;
+    uint32_t now_us;
+    timebase.now(&now_s, &now_us);
+    uint32_t due_ms = (1000000 - now_us) / 1000;
+    if (due_ms > NTP_SERVE_EDGE_LEAD)
+    {
+        return due_ms - NTP_SERVE_EDGE_LEAD;
+    }
+    syncTimeBase();
+    return NET_WAKE_IDLE_MS;
 }
 
-int getEdgeSyncedTime(DS3231DateTime& dt, unsigned int retries)
+int getEdgeSyncedTime(DS3231DateTime& dt, uint32_t* edge_us, unsigned int retries)
 {
     static PROGMEM const char TAG[] = "getEdgeSyncedTime";
-    clk.waitForEdge(CLOCK_EDGE_FALLING);
 
     while(retries-- > 0)
     {
-        clk.waitForEdge(CLOCK_EDGE_FALLING);
-        // need 1ms delay!  but why?  noise?
-        delay(1);
-        if (rtc.readTime(dt) == 0)
+        if (clk.waitForEdge(CLOCK_EDGE_FALLING, edge_us) == 0)
         {
-            return 0;
+            // need 1ms delay!  but why?  noise?
+            delay(1);
+            if (rtc.readTime(dt) == 0)
+            {
+                return 0;
+            }
         }
 
         dlog.warning(FPSTR(TAG), F("failed to read from RTC, %d retries left"), retries);
+        ++edge_retries;
         WireUtils.clearBus();
     }
     return -1;
@@ -1366,73 +1947,214 @@ int setRTCfromOffset(double offset, bool sync)
 {
     static PROGMEM const char TAG[] = "setRTCfromOffset";
 
-    int32_t  seconds = (int32_t)offset;
-    uint32_t msdelay = fabs((offset - (double)seconds) * 1000);
-
-    if (offset > 0)
-    {
-        seconds = seconds + 1; // +1 because we go to the next second
-        msdelay = 1000.0 - msdelay;
-    }
-
-    dlog.info(FPSTR(TAG), F("offset: %lf seconds: %d msdelay: %d sync: %s"),
-            offset, seconds, msdelay, sync ? "true" : "false");
-
-    DS3231DateTime dt;
-
-    if (getEdgeSyncedTime(dt, 3))
+    uint32_t now_s;
+    uint32_t now_us;
+    if (getTime(&now_s, &now_us))
     {
         dlog.error(FPSTR(TAG), F("failed to read from RTC!"));
         return ERROR_RTC;
     }
 
-    // wait for where the next second should start
-    if (msdelay > 0 && msdelay < 1000)
-    {
-        delay(msdelay);
-    }
+    //
+    // write the next whole second of the corrected time at the moment it
+    // starts, 'at' is when that is on the current (uncorrected) time.
+    //
+    double   now      = (double)now_s + (double)now_us / 1000000.0;
+    uint32_t new_time = (uint32_t)floor(now + offset + RTC_WRITE_MARGIN) + 1;
+    double   at       = (double)new_time - offset;
+    uint32_t at_s     = (uint32_t)floor(at);
+    uint32_t at_us    = (uint32_t)((at - (double)at_s) * 1000000.0);
+
+    dlog.info(FPSTR(TAG), F("offset: %lf now: %u.%06u at: %u.%06u sync: %s"),
+            offset, now_s, now_us, at_s, at_us, sync ? "true" : "false");
 
-    uint32_t old_time = dt.getUnixTime();
-    uint32_t new_time = old_time + seconds;
+    DS3231DateTime dt;
     dt.setUnixTime(new_time);
 
+    timebase.waitUntil(at_s, at_us);
+
     if (sync)
     {
+        uint32_t write_us = micros();
         if (rtc.writeTime(dt))
         {
             dlog.error(FPSTR(TAG), F("FAILED to set RTC: %s"), dt.string());
+            timebase.invalidate();
             return ERROR_RTC;
         }
+        // writing the seconds restarts the DS3231 countdown chain
+        timebase.anchor(new_time, write_us);
     }
 
     //
     // Update the TZ offset in case the timezone offset has changed based on new time.
     //
-    delay(1); // DS3231 seems to need a short delay after write before we read the time back
     updateTZOffset();
 
-    dlog.info(FPSTR(TAG), F("old_time: %d new_time: %d"), old_time, new_time);
+    dlog.info(FPSTR(TAG), F("old_time: %u new_time: %u"), at_s, new_time);
     dlog.info(FPSTR(TAG), F("RTC: %s"), dt.string());
     return 0;
 }
 
+//
+// anchor the timebase to the next falling edge of the RTC square wave
+//
+int syncTimeBase()
+{
+    static PROGMEM const char TAG[] = "syncTimeBase";
+    DS3231DateTime dt;
+    uint32_t       edge_us;
+
+    if (getEdgeSyncedTime(dt, &edge_us, 3))
+    {
+        dlog.error(FPSTR(TAG), F("failed to read from RTC!"));
+        timebase.invalidate();
+        return -1;
+    }
+
+    timebase.anchor(dt.getUnixTime(), edge_us);
+    return 0;
+}
+
 /*
- * sync to a second boundary and return the current time in seconds
+ * return the current time in seconds and microseconds from the timebase,
+ * syncing it to an RTC edge first if needed.
  */
-int getTime(uint32_t *result)
+int getTime(uint32_t *seconds, uint32_t *usec)
 {
-    clk.waitForEdge(CLOCK_EDGE_FALLING);
-    delay(2); // ATtiny85 at 1mhz has interrupts disabled for a bit after the falling edge
-    DS3231DateTime dt;
-    if (rtc.readTime(dt))
+    if (!timebase.isValid() && syncTimeBase())
     {
-        dlog.error(F("getTime"), F("failed to read from RTC!"));
+        dlog.error(F("getTime"), F("failed to sync timebase!"));
         return -1;
     }
-    *result = dt.getUnixTime();
+    timebase.now(seconds, usec);
     return 0;
 }
 
+/*
+ * return the current time from the timebase without syncing it, for
+ * timestamps that can't wait for an RTC edge.  Fails if it has expired,
+ * serveNTP() keeps it anchored while we answer NTP requests.
+ */
+int getTimeNoSync(uint32_t *seconds, uint32_t *usec)
+{
+    if (!timebase.isValid())
+    {
+        return -1;
+    }
+    timebase.now(seconds, usec);
+    return 0;
+}
+
+//
+// the deep sleep timer runs off the ESP's RC oscillator, which is off by
+// several percent and moves with temperature.  Measure the sleep that just
+// ended against the RTC and fold it into the calibration sleepFor() scales
+// the timer by, then take what is left of a long sleep from the RTC so the
+// timer errors of its chunks don't add up.
+//
+void calibrateSleep()
+{
+    static PROGMEM const char TAG[] = "calibrateSleep";
+
+    DS3231DateTime dt;
+    if (rtc.readTime(dt))
+    {
+        dlog.error(FPSTR(TAG), F("failed to read RTC!"));
+        return;
+    }
+    uint32_t now  = dt.getUnixTime();
+    wake_rtc_time = now;
+    wake_rtc_ms   = millis();
+
+    if (ESP.getResetInfoPtr()->reason == REASON_DEEP_SLEEP_AWAKE && dsd.sleep_start != 0
+        && dsd.sleep_timer_ms >= SLEEP_CAL_MIN_MS && now > dsd.sleep_start)
+    {
+        float measured = (now - dsd.sleep_start) * 1000.0 / dsd.sleep_timer_ms;
+        if (fabs(measured - 1.0) < SLEEP_CAL_LIMIT)
+        {
+            dsd.sleep_cal = dsd.sleep_cal == 0.0 ? measured : dsd.sleep_cal + (measured - dsd.sleep_cal) / SLEEP_CAL_WEIGHT;
+            dlog.info(FPSTR(TAG), F("slept %lus on %lums of timer: %.5f calibration now %.5f"),
+                    now - dsd.sleep_start, dsd.sleep_timer_ms, measured, dsd.sleep_cal);
+        }
+        else
+        {
+            dlog.warning(FPSTR(TAG), F("slept %lus on %lums of timer, ignoring it"), now - dsd.sleep_start, dsd.sleep_timer_ms);
+        }
+    }
+    dsd.sleep_start = 0;
+
+    //
+    // the radio is off for this wake, if the sleep is over come back
+    // right away with it on.
+    //
+    if (dsd.sleep_delay_left != 0 && dsd.sleep_until != 0)
+    {
+        dsd.sleep_delay_left = dsd.sleep_until > now ? dsd.sleep_until - now : 1;
+    }
+}
+
+//
+// a time change coming up within DST_STAGE_WINDOW is handed to the
+// controller as a target for the tick it happens on, the controller then
+// starts the hour of fast forward or pause on that exact second.  sleepFor()
+// makes sure there is a wake DST_WAKE_LEAD before each time change.
+//
+void stageTimeChange()
+{
+    static PROGMEM const char TAG[] = "stageTimeChange";
+
+    if (dsd.tz_change == 0 || wake_rtc_time == 0)
+    {
+        return;
+    }
+
+    uint32_t now_s = wake_rtc_time + (millis() - wake_rtc_ms) / 1000;
+    if (now_s >= dsd.tz_change || dsd.tz_change - now_s > DST_STAGE_WINDOW)
+    {
+        return;
+    }
+
+    CpuGovernor::phase(CPU_PHASE_CLOCK);
+    uint32_t now_us;
+    if (getTime(&now_s, &now_us))
+    {
+        dlog.error(FPSTR(TAG), F("failed to get the time!"));
+        return;
+    }
+
+    //
+    // don't replace a target setCLKfromRTC() left for the next tick and
+    // keep clear of the next tick so ours can't land after it.
+    //
+    uint16_t pending_pos;
+    uint16_t pending_ticks = 0;
+    clk.readTarget(&pending_pos, &pending_ticks);
+    if (pending_ticks != 0 || now_us > 900000)
+    {
+        timebase.waitUntil(now_s + 1, 50000);
+        ++now_s;
+    }
+
+    if (now_s >= dsd.tz_change)
+    {
+        return;
+    }
+
+    int new_offset = computeTZOffset(dsd.tz_change, dsd.tz_offset, NULL);
+    DS3231DateTime change;
+    change.setUnixTime(dsd.tz_change);
+    uint16_t target = change.getPosition(new_offset);
+    uint16_t ticks  = dsd.tz_change - now_s;
+    if (clk.writeTarget(target, ticks))
+    {
+        dlog.error(FPSTR(TAG), F("failed to write the target!"));
+        return;
+    }
+    dlog.info(FPSTR(TAG), F("offset %d to %d at %lu, clock target position:%u in %u ticks"),
+            dsd.tz_offset, new_offset, dsd.tz_change, target, ticks);
+}
+
 int setRTCfromDrift()
 {
     static PROGMEM const char TAG[] = "setRTCfromDrift";
@@ -1461,8 +2183,22 @@ int setRTCfromNTP(const char* server, bool sync, double* result_offset, IPAddres
 
     dlog.info(FPSTR(TAG), F("using server: %s"), server);
 
+    // a new sample means the server answered even if NTP didn't use it
+    uint32_t last_sample = dsd.ntp_runtime.samples[0].timestamp;
     double offset;
-    if (ntp.getOffset(server, &offset, &getTime))
+    double delay;
+    int err = ntp.getOffset(server, &offset, &getTime);
+    Metrics::recordHeap(&dsd.metrics, ESP.getFreeHeap()); // WiFi is up, about as low as it gets
+    if (dsd.ntp_runtime.samples[0].timestamp != last_sample && !ntp.getLastDelay(&delay))
+    {
+        Metrics::recordNTP(&dsd.metrics, err ? dsd.ntp_runtime.samples[0].offset : offset, delay, err == 0);
+    }
+    else
+    {
+        Metrics::recordNTPFailure(&dsd.metrics);
+    }
+
+    if (err)
     {
         dlog.warning(FPSTR(TAG), F("NTP Failed!"));
         return ERROR_NTP;
@@ -1486,6 +2222,23 @@ int setRTCfromNTP(const char* server, bool sync, double* result_offset, IPAddres
         return error;
     }
 
+    //
+    // the NTP server answers from the RTC we just set, one hop further from
+    // the reference than our server: add our delay and jitter to its root
+    // delay & dispersion.
+    //
+    uint8_t  stratum;
+    double   root_delay;
+    double   root_dispersion;
+    uint32_t now_s;
+    uint32_t now_us;
+    if (ntp_serve && sync && !ntp.getServerRoot(&stratum, &root_delay, &root_dispersion)
+        && !ntp.getLastDelay(&delay) && !getTime(&now_s, &now_us))
+    {
+        ntp_server.setReference(ntp.getAddress(), stratum, root_delay + delay,
+                root_dispersion + dsd.ntp_runtime.delay_stddev, now_s, now_us);
+    }
+
     dlog.debug(FPSTR(TAG), F("returning OK"));
     return 0;
 }
@@ -1501,13 +2254,45 @@ int setCLKfromRTC()
         return -1;
     }
 
+    // same for a pause, controllers without pause support just fail this.
+    clk.writePause(0);
+
+    //
+    // newer controllers plan the correction themselves, just tell them
+    // where the clock should be on the next tick.
+    //
+    uint32_t now_s;
+    uint32_t now_us;
+    if (getTime(&now_s, &now_us) == 0)
+    {
+        // keep clear of the next tick so the target can't land after it
+        if (now_us > 900000)
+        {
+            timebase.waitUntil(now_s + 1, 50000);
+            ++now_s;
+        }
+
+        DS3231DateTime next;
+        next.setUnixTime(now_s + 1);
+        uint16_t target = next.getPosition(config.tz_offset);
+        if (clk.writeTarget(target, 1) == 0)
+        {
+            dlog.info(FPSTR(TAG), F("clock target position:%d on the next tick"), target);
+            return 0;
+        }
+    }
+
 #if defined(USE_STOP_THE_CLOCK)
     int delta;
     uint16_t clock_pos;
     uint16_t rtc_pos;
     do
     {
-        clk.waitForEdge(CLOCK_EDGE_FALLING);
+        if (clk.waitForEdge(CLOCK_EDGE_FALLING))
+        {
+            dlog.error(FPSTR(TAG), F("no edge from RTC!"));
+            return -1;
+        }
         delay(10);
 
         if (clk.readPosition(&clock_pos))
@@ -1529,12 +2314,22 @@ int setCLKfromRTC()
         delta = rtc_pos - clock_pos;
         if (delta < 0 && abs(delta) < STOP_THE_CLOCK_MAX)
         {
+            //
+            // let the controller hold the clock still for -delta ticks
+            // on its own so we can go back to sleep right away.
+            //
+            if (clk.writePause(-delta) == 0)
+            {
+                dlog.info(FPSTR(TAG), F("stop the clock delta is %d, controller pausing for %d ticks"), delta, -delta);
+                return 0;
+            }
+
             int stop_for = abs(delta) + STOP_THE_CLOCK_EXTRA;
             dlog.info(FPSTR(TAG), F("stop the clock delta is %d stopping for %d seconds"), delta, stop_for);
 
             // stop the clock for delta seconds
             clk.setEnable(false);
-            delay(stop_for * 1000);
+            Wait::ms(stop_for * 1000);
             clk.setEnable(true);
         }
         //
@@ -1542,7 +2337,11 @@ int setCLKfromRTC()
         //
     } while (delta < 0 && abs(delta) < STOP_THE_CLOCK_MAX);
 #else
-    clk.waitForEdge(CLOCK_EDGE_FALLING);
+    if (clk.waitForEdge(CLOCK_EDGE_FALLING))
+    {
+        dlog.error(FPSTR(TAG), F("no edge from RTC!"));
+        return -1;
+    }
     delay(10);
     uint16_t clock_pos;
     if (clk.readPosition(&clock_pos))
@@ -1632,6 +2431,18 @@ boolean loadConfig()
     dlog.trace(FPSTR(TAG), F("CRC32 read from EEPROM: %08x"), cfg.crc);
     if (crcOfData != cfg.crc)
     {
+        //
+        // a config saved before tz_name was added is the same up to it, keep
+        // it and its time changes rather than going back to the defaults.
+        //
+        if (calculateCRC32(((uint8_t*) &cfg.data), offsetof(Config, tz_name)) == cfg.crc)
+        {
+            dlog.info(FPSTR(TAG), F("upgrading config saved without a time zone, using its time changes"));
+            memcpy(&config, &cfg.data, offsetof(Config, tz_name));
+            memset(config.tz_name, 0, sizeof(config.tz_name));
+            saveConfig();
+            return true;
+        }
         dlog.warning(FPSTR(TAG), F("CRC32 in EEPROM memory doesn't match CRC32 of data. Data is probably invalid!"));
         return false;
     }
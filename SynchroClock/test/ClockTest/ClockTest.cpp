@@ -4,10 +4,11 @@
 #include "DLogPrintWriter.h"
 #include "DS3231.h"
 
-DLog&  dlog = DLog::getLog();
 Clock clk(SYNC_PIN);
 DS3231 ds;
 
+#define EXPECTED_VERSION 5
+
 void test_factory_reset()
 {
     TEST_ASSERT_EQUAL(0, clk.factoryReset());
@@ -27,7 +28,42 @@ void test_version()
 {
     uint8_t version;
     TEST_ASSERT_EQUAL(0, clk.readVersion(& version));
-    TEST_ASSERT_EQUAL_UINT8(1, version);
+    TEST_ASSERT_EQUAL_UINT8(EXPECTED_VERSION, version);
+}
+
+void test_snapshot()
+{
+    TEST_ASSERT_EQUAL(0, clk.writePosition(1234));
+    ClockSnapshot snapshot;
+    TEST_ASSERT_EQUAL(0, clk.readSnapshot(&snapshot));
+    TEST_ASSERT_EQUAL_UINT8(CLOCK_ID_VALUE, snapshot.id);
+    TEST_ASSERT_EQUAL_UINT8(EXPECTED_VERSION, snapshot.version);
+    TEST_ASSERT_EQUAL(clk.getEnable(), (snapshot.control & BIT_ENABLE) == BIT_ENABLE);
+    TEST_ASSERT_UINT16_WITHIN(1, 1234, snapshot.position);
+}
+
+void test_config()
+{
+    ClockConfig saved;
+    TEST_ASSERT_EQUAL(0, clk.readConfig(&saved));
+
+    ClockConfig config = saved;
+    config.tp_duration = saved.tp_duration + 1;
+    config.ap_delay    = saved.ap_delay + 1;
+    TEST_ASSERT_EQUAL(0, clk.writeConfig(&config));
+
+    // the burst write must land in the individual registers
+    uint8_t value;
+    TEST_ASSERT_EQUAL(0, clk.readTPDuration(&value));
+    TEST_ASSERT_EQUAL_UINT8(config.tp_duration, value);
+    TEST_ASSERT_EQUAL(0, clk.readAPDelay(&value));
+    TEST_ASSERT_EQUAL_UINT8(config.ap_delay, value);
+
+    ClockConfig check;
+    TEST_ASSERT_EQUAL(0, clk.readConfig(&check));
+    TEST_ASSERT_EQUAL_MEMORY(&config, &check, sizeof(ClockConfig));
+
+    TEST_ASSERT_EQUAL(0, clk.writeConfig(&saved));
 }
 
 void test_position(uint16_t pos)
@@ -68,6 +104,61 @@ void test_adjust_10()
     test_adjust(10);
 }
 
+void test_edge()
+{
+    uint32_t first;
+    uint32_t second;
+    TEST_ASSERT_EQUAL(0, clk.waitForEdge(CLOCK_EDGE_FALLING, &first));
+    TEST_ASSERT_EQUAL(0, clk.waitForEdge(CLOCK_EDGE_FALLING, &second));
+    // the DS3231 square wave is 1Hz
+    TEST_ASSERT_UINT32_WITHIN(1000, 1000000, second - first);
+}
+
+void test_pause()
+{
+    TEST_ASSERT_EQUAL(0, clk.writePosition(100));
+    TEST_ASSERT_EQUAL(0, clk.writePause(2));
+    clk.setEnable(true);
+    delay(3500);
+    clk.setEnable(false);
+    uint16_t position;
+    uint16_t pause;
+    TEST_ASSERT_EQUAL(0, clk.readPosition(&position));
+    TEST_ASSERT_EQUAL(0, clk.readPause(&pause));
+    TEST_ASSERT_EQUAL(0, pause);
+    // 3 ticks (maybe 4) with 2 of them held
+    TEST_ASSERT_UINT16_WITHIN(1, 101, position);
+}
+
+void test_target(uint16_t start)
+{
+    TEST_ASSERT_EQUAL(0, clk.writePosition(start));
+    TEST_ASSERT_EQUAL(0, clk.writeTarget(110, 1));
+    clk.setEnable(true);
+    delay(5000);
+    clk.setEnable(false);
+    uint16_t position;
+    uint16_t target;
+    uint16_t ticks;
+    TEST_ASSERT_EQUAL(0, clk.readTarget(&target, &ticks));
+    TEST_ASSERT_EQUAL(0, ticks);
+    TEST_ASSERT_EQUAL(0, clk.readPosition(&position));
+    // 110 on the first tick then 3 or 4 more ticks
+    TEST_ASSERT_UINT16_WITHIN(1, 114, position);
+}
+
+// behind, controller should fast forward
+void test_target_forward()
+{
+    test_target(100);
+}
+
+// ahead, controller should pause
+void test_target_pause()
+{
+    test_target(112);
+}
+
 void test_reads()
 {
     int errors = 0;
@@ -94,10 +185,16 @@ void setup()
     delay(1000);
     RUN_TEST(test_is_present);
     RUN_TEST(test_version);
+    RUN_TEST(test_snapshot);
+    RUN_TEST(test_config);
     RUN_TEST(test_position_0);
     RUN_TEST(test_position_half);
     RUN_TEST(test_position_max);
     RUN_TEST(test_adjust_10);
+    RUN_TEST(test_edge);
+    RUN_TEST(test_pause);
+    RUN_TEST(test_target_forward);
+    RUN_TEST(test_target_pause);
     RUN_TEST(test_reads);
     UNITY_END();
 }
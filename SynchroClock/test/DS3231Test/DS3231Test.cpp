@@ -5,7 +5,6 @@
 #define NO_RETRIES
 //#define VERBOSE_OUTPUT
 
-DLog&  dlog = DLog::getLog();
 DS3231 ds;
 
 #ifndef NO_RETRIES
@@ -0,0 +1,310 @@
+#include "DeltaOTA.h"
+#include "unity.h"
+
+#define SOURCE_SIZE 1000
+#define TARGET_SIZE 1100
+
+static uint8_t  source[SOURCE_SIZE];
+static uint8_t  expected[TARGET_SIZE];
+static uint8_t  target[TARGET_SIZE + 16];
+static size_t   target_size;
+static uint8_t  patch[1200];
+static size_t   patch_size;
+static int      begins;
+
+static void put32(uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        patch[patch_size++] = value >> (i * 8);
+    }
+}
+
+static void copyOp(uint32_t offset, uint32_t len)
+{
+    patch[patch_size++] = DELTA_OP_COPY;
+    put32(offset);
+    put32(len);
+}
+
+static void insertOp(const uint8_t* data, uint32_t len)
+{
+    patch[patch_size++] = DELTA_OP_INSERT;
+    put32(len);
+    memcpy(&patch[patch_size], data, len);
+    patch_size += len;
+}
+
+//
+// target: source[0..400), 100 new bytes, source[400..1000), built by hand
+// the way mkdelta.py lays it out.
+//
+static void makePatch()
+{
+    for (int i = 0; i < SOURCE_SIZE; ++i)
+    {
+        source[i] = i * 7;
+    }
+    uint8_t inserted[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        inserted[i] = 0xa0 ^ i;
+    }
+    memcpy(expected, source, 400);
+    memcpy(&expected[400], inserted, 100);
+    memcpy(&expected[500], &source[400], 600);
+
+    patch_size = 0;
+    put32(DELTA_MAGIC);
+    put32(DELTA_VERSION);
+    put32(SOURCE_SIZE);
+    patch_size += 16; // md5s are checked by the caller
+    put32(TARGET_SIZE);
+    patch_size += 16;
+    copyOp(0, 400);
+    insertOp(inserted, 100);
+    copyOp(400, 600);
+    patch[patch_size++] = DELTA_OP_END;
+}
+
+static DeltaPatch* newPatch()
+{
+    target_size = 0;
+    begins      = 0;
+    return new DeltaPatch([](const DeltaHeader* header)
+    {
+        ++begins;
+        return header->source_size == SOURCE_SIZE ? 0 : -1;
+    },
+    [](uint32_t offset, uint8_t* data, size_t len)
+    {
+        memcpy(data, &source[offset], len);
+        return 0;
+    },
+    [](const uint8_t* data, size_t len)
+    {
+        if (target_size + len > sizeof(target))
+        {
+            return -1;
+        }
+        memcpy(&target[target_size], data, len);
+        target_size += len;
+        return 0;
+    });
+}
+
+//
+// stand-in for HTTPClient and the http server behind it, so the patch comes
+// thru DeltaOTA::fetchRange(): a Range gets a 206 with the patch from its
+// offset (or a 200 with all of it when ignore_range), the body is cut off
+// after drop_after bytes, the connection closing then unless stall.
+//
+static size_t   drop_after;
+static bool     ignore_range;
+static bool     stall;
+static int      requests;
+static int      partials;    // 206 replies
+static uint32_t last_range;  // offset of the last Range request, 0 for none
+
+class FakeStream
+{
+public:
+    size_t available()
+    {
+        return _pos < _end ? std::min((size_t)37, _end - _pos) : 0;
+    }
+    size_t read(uint8_t* buf, size_t len)
+    {
+        len = std::min(len, available());
+        memcpy(buf, &patch[_pos], len);
+        _pos += len;
+        return len;
+    }
+    bool connected()
+    {
+        return stall;
+    }
+    void begin(size_t pos, size_t end)
+    {
+        _pos = pos;
+        _end = end;
+    }
+private:
+    size_t _pos;
+    size_t _end;
+};
+
+class FakeHTTP
+{
+public:
+    FakeHTTP() : _range(0) {}
+    bool begin(WiFiClient& client, const char* url)    { (void)client; return url != NULL; }
+    void end()                                         {}
+    void useHTTP10(bool use)                           { (void)use; }
+    void setTimeout(uint16_t timeout)                  { (void)timeout; }
+    void addHeader(const String& name, const String& value)
+    {
+        if (name == "Range")
+        {
+            _range = strtoul(value.c_str() + strlen("bytes="), NULL, 10);
+        }
+    }
+    int GET()
+    {
+        ++requests;
+        last_range     = _range;
+        uint32_t start = ignore_range ? 0 : _range;
+        _stream.begin(start, std::min(patch_size, start + drop_after));
+        if (_range && !ignore_range)
+        {
+            ++partials;
+            return HTTP_CODE_PARTIAL_CONTENT;
+        }
+        return HTTP_CODE_OK;
+    }
+    FakeStream* getStreamPtr()                         { return &_stream; }
+private:
+    uint32_t   _range;
+    FakeStream _stream;
+};
+
+static void serve(DeltaPatch* p, uint32_t offset)
+{
+    FakeHTTP   http;
+    WiFiClient client;
+    DeltaOTA::fetchRange(http, client, "http://test/SynchroClock.bin.delta", offset, *p);
+}
+
+static void resetServer(size_t drop, bool ignore)
+{
+    drop_after   = drop;
+    ignore_range = ignore;
+    stall        = false;
+    requests     = 0;
+    partials     = 0;
+    last_range   = 0;
+}
+
+static void assertTarget()
+{
+    TEST_ASSERT_EQUAL(TARGET_SIZE, target_size);
+    TEST_ASSERT_EQUAL(0, memcmp(target, expected, TARGET_SIZE));
+}
+
+void test_apply()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    TEST_ASSERT_EQUAL(0, p->write(0, patch, patch_size));
+    TEST_ASSERT_TRUE(p->isDone());
+    TEST_ASSERT_EQUAL(1, begins);
+    TEST_ASSERT_EQUAL(patch_size, p->getOffset());
+    assertTarget();
+    delete p;
+}
+
+void test_resume()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    resetServer(50, false);
+    TEST_ASSERT_EQUAL(0, p->fetch([p](uint32_t offset) { serve(p, offset); }, 2, 0));
+    TEST_ASSERT_EQUAL((patch_size + drop_after - 1) / drop_after, requests);
+    TEST_ASSERT_EQUAL(requests - 1, partials);
+    TEST_ASSERT_EQUAL(patch_size - patch_size % drop_after, last_range);
+    TEST_ASSERT_EQUAL(1, begins);
+    assertTarget();
+    delete p;
+}
+
+void test_range_ignored()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    resetServer(300, true);
+    TEST_ASSERT_EQUAL(0, p->fetch([p](uint32_t offset) { serve(p, offset); }, 2, 0));
+    TEST_ASSERT_EQUAL(0, partials);
+    TEST_ASSERT_EQUAL(1, begins);
+    assertTarget();
+    delete p;
+}
+
+void test_no_progress()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    resetServer(0, false);
+    TEST_ASSERT_EQUAL(-1, p->fetch([p](uint32_t offset) { serve(p, offset); }, 3, 0));
+    TEST_ASSERT_EQUAL(4, requests);
+    delete p;
+}
+
+//
+// the server stops sending but keeps the connection open, fetchRange()
+// gives up after DELTA_OTA_TIMEOUT with what it got.
+//
+void test_stalled()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    resetServer(100, false);
+    stall = true;
+    uint32_t start = millis();
+    serve(p, 0);
+    uint32_t elapsed = millis() - start;
+    TEST_ASSERT_TRUE(elapsed >= DELTA_OTA_TIMEOUT && elapsed < DELTA_OTA_TIMEOUT + 1000);
+    TEST_ASSERT_EQUAL(100, p->getOffset());
+    TEST_ASSERT_FALSE(p->isDone());
+    delete p;
+}
+
+void test_bad_patch()
+{
+    makePatch();
+    DeltaPatch* p = newPatch();
+    patch[0] ^= 1;
+    TEST_ASSERT_EQUAL(-1, p->write(0, patch, patch_size));
+    TEST_ASSERT_TRUE(p->isFailed());
+    TEST_ASSERT_EQUAL(0, begins);
+    delete p;
+
+    // a copy past the end of the source
+    makePatch();
+    patch[48 + 4] = 0xff;
+    p = newPatch();
+    TEST_ASSERT_EQUAL(-1, p->write(0, patch, patch_size));
+    TEST_ASSERT_TRUE(p->isFailed());
+    delete p;
+
+    // a gap
+    makePatch();
+    p = newPatch();
+    TEST_ASSERT_EQUAL(0, p->write(0, patch, 60));
+    TEST_ASSERT_EQUAL(-1, p->write(70, &patch[70], 10));
+    delete p;
+
+    // short of the target size
+    makePatch();
+    patch[28] += 1;
+    p = newPatch();
+    TEST_ASSERT_EQUAL(-1, p->write(0, patch, patch_size));
+    delete p;
+}
+
+void setup()
+{
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_apply);
+    RUN_TEST(test_resume);
+    RUN_TEST(test_range_ignored);
+    RUN_TEST(test_no_progress);
+    RUN_TEST(test_stalled);
+    RUN_TEST(test_bad_patch);
+    UNITY_END();
+}
+
+void loop()
+{
+    delay(1000);
+}
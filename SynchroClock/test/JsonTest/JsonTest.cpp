@@ -0,0 +1,94 @@
+#include "Json.h"
+#include "unity.h"
+
+static char names[8][JSON_NAME_SIZE];
+static char values[8][JSON_VALUE_SIZE];
+static bool quoted[8];
+static int  count;
+
+static int parse(const char* json)
+{
+    count = 0;
+    return JsonReader::parse(json, [](const char* name, const char* value, bool q)
+    {
+        if (count < 8)
+        {
+            strcpy(names[count], name);
+            strcpy(values[count], value);
+            quoted[count] = q;
+        }
+        ++count;
+    });
+}
+
+void test_parse()
+{
+    TEST_ASSERT_EQUAL(0, parse(" { \"ntp_server\" : \"pool.ntp.org\",\n\"tp_duty\":35, \"tc1_offset\": -25200 } "));
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL_STRING("ntp_server", names[0]);
+    TEST_ASSERT_EQUAL_STRING("pool.ntp.org", values[0]);
+    TEST_ASSERT_TRUE(quoted[0]);
+    TEST_ASSERT_EQUAL_STRING("tp_duty", names[1]);
+    TEST_ASSERT_EQUAL_STRING("35", values[1]);
+    TEST_ASSERT_FALSE(quoted[1]);
+    TEST_ASSERT_EQUAL_STRING("-25200", values[2]);
+
+    TEST_ASSERT_EQUAL(0, parse("{}"));
+    TEST_ASSERT_EQUAL(0, count);
+
+    TEST_ASSERT_EQUAL(0, parse("{\"s\":\"a\\\"b\\\\c\\u0041\\n\"}"));
+    TEST_ASSERT_EQUAL_STRING("a\"b\\cA\n", values[0]);
+}
+
+void test_parse_errors()
+{
+    TEST_ASSERT_EQUAL(-1, parse(""));
+    TEST_ASSERT_EQUAL(-1, parse("[1]"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":1"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":1,}"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\" 1}"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":{\"b\":1}}"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":[1]}"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":1} x"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":\"\\u00e9\"}"));
+    TEST_ASSERT_EQUAL(-1, parse("{\"a\":\"\\q\"}"));
+
+    // longer than the value buffer
+    char json[JSON_VALUE_SIZE + 16];
+    strcpy(json, "{\"a\":\"");
+    memset(&json[6], 'x', JSON_VALUE_SIZE);
+    strcpy(&json[6 + JSON_VALUE_SIZE], "\"}");
+    TEST_ASSERT_EQUAL(-1, parse(json));
+}
+
+void test_round_trip()
+{
+    String out;
+    JsonWriter json(out);
+    json.begin();
+    json.addString(PSTR("host"), "a \"quoted\"\tname");
+    json.addNumber(PSTR("offset"), -28800);
+    json.end();
+
+    TEST_ASSERT_EQUAL(0, parse(out.c_str()));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL_STRING("host", names[0]);
+    TEST_ASSERT_EQUAL_STRING("a \"quoted\"\tname", values[0]);
+    TEST_ASSERT_EQUAL_STRING("offset", names[1]);
+    TEST_ASSERT_EQUAL_STRING("-28800", values[1]);
+}
+
+void setup()
+{
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_parse);
+    RUN_TEST(test_parse_errors);
+    RUN_TEST(test_round_trip);
+    UNITY_END();
+}
+
+void loop()
+{
+    delay(1000);
+}
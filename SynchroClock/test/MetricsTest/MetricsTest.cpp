@@ -0,0 +1,99 @@
+#include "Metrics.h"
+#include "unity.h"
+
+static MetricsData m;
+
+static void assertContains(const String& out, const char* line)
+{
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(out.c_str(), line), line);
+}
+
+void test_ntp_buckets()
+{
+    memset(&m, 0, sizeof(m));
+    Metrics::recordNTP(&m, -0.0005, 0.005, true);   // 1ms, 10ms
+    Metrics::recordNTP(&m, 0.010,   0.030, true);   // 20ms, 50ms
+    Metrics::recordNTP(&m, 1.5,     0.300, false);  // +Inf, +Inf
+
+    TEST_ASSERT_EQUAL(3, m.ntp_requests);
+    TEST_ASSERT_EQUAL(1, m.ntp_rejected);
+    TEST_ASSERT_EQUAL(1, m.ntp_rtt[0]);
+    TEST_ASSERT_EQUAL(1, m.ntp_rtt[2]);
+    TEST_ASSERT_EQUAL(1, m.ntp_rtt[METRICS_NTP_RTT_BUCKETS-1]);
+    TEST_ASSERT_EQUAL(1, m.ntp_offset[0]);
+    TEST_ASSERT_EQUAL(1, m.ntp_offset[2]);
+    TEST_ASSERT_EQUAL(1, m.ntp_offset[METRICS_NTP_OFFSET_BUCKETS-1]);
+    TEST_ASSERT_EQUAL(335000, m.ntp_rtt_us_sum);
+
+    Metrics::recordNTPFailure(&m);
+    TEST_ASSERT_EQUAL(4, m.ntp_requests);
+    TEST_ASSERT_EQUAL(1, m.ntp_failures);
+}
+
+void test_wake_and_heap()
+{
+    memset(&m, 0, sizeof(m));
+    Metrics::recordWake(&m, 200, 41000);
+    Metrics::recordWake(&m, 3500, 38000);
+    Metrics::recordHeap(&m, 39000);
+
+    TEST_ASSERT_EQUAL(2, m.wakes);
+    TEST_ASSERT_EQUAL(3700, m.wake_ms_sum);
+    TEST_ASSERT_EQUAL(1, m.wake_ms[0]);
+    TEST_ASSERT_EQUAL(1, m.wake_ms[4]);
+    TEST_ASSERT_EQUAL(38000, m.heap_min);
+}
+
+void test_saturation()
+{
+    memset(&m, 0, sizeof(m));
+    Metrics::recordI2C(&m, 65000, 1);
+    Metrics::recordI2C(&m, 65000, 1);
+    TEST_ASSERT_EQUAL(65535, m.i2c_retries);
+    TEST_ASSERT_EQUAL(2, m.i2c_clear_bus);
+
+    m.poll_sum = 0xfffffff0;
+    Metrics::recordPoll(&m, 129600);
+    TEST_ASSERT_EQUAL(0xffffffff, m.poll_sum);
+    TEST_ASSERT_EQUAL(1, m.poll[4]);
+}
+
+void test_write()
+{
+    memset(&m, 0, sizeof(m));
+    Metrics::recordNTP(&m, 0.002, 0.020, true);
+    Metrics::recordNTP(&m, 0.002, 0.040, true);
+    Metrics::recordPoll(&m, 3600);
+
+    String out;
+    Metrics::write(&m, out);
+    assertContains(out, "# TYPE synchroclock_ntp_rtt_seconds histogram\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_bucket{le=\"0.01\"} 0\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_bucket{le=\"0.025\"} 1\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_bucket{le=\"0.05\"} 2\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_bucket{le=\"+Inf\"} 2\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_sum 0.060000\n");
+    assertContains(out, "synchroclock_ntp_rtt_seconds_count 2\n");
+    assertContains(out, "synchroclock_ntp_poll_interval_seconds_bucket{le=\"3600\"} 1\n");
+    assertContains(out, "synchroclock_ntp_requests_total 2\n");
+    TEST_ASSERT_NULL(strstr(out.c_str(), "heap_free_min")); // nothing recorded yet
+
+    Metrics::writeGauge(out, PSTR("synchroclock_ntp_reach"), PSTR("NTP reachability shift register."), 255);
+    assertContains(out, "# TYPE synchroclock_ntp_reach gauge\nsynchroclock_ntp_reach 255\n");
+}
+
+void setup()
+{
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_ntp_buckets);
+    RUN_TEST(test_wake_and_heap);
+    RUN_TEST(test_saturation);
+    RUN_TEST(test_write);
+    UNITY_END();
+}
+
+void loop()
+{
+    delay(1000);
+}
@@ -0,0 +1,377 @@
+#include "TimeUtils.h"
+#include "DS3231DateTime.h"
+#include "unity.h"
+
+
+#define DAY_2000       10957
+#define DAY_2100       47482
+#define DAY_2200       84006
+#define DAY_2038       24855    // last whole day a 32 bit time_t can hold
+#define WAKE_TIME      1792288000
+#define BENCHMARK_RUNS 1000
+#define SPRING_2026    1772964000 // 2026/03/08 02:00 PST
+#define FALL_2026      1793523600 // 2026/11/01 02:00 PDT
+#define SPRING_2027    1805018400 // 2027/03/14 02:00 PST
+
+// the la env rules
+TimeChange la_tc[] = {
+    { -25200,  3, 2, 0, 2, 0 },
+    { -28800, 11, 1, 0, 2, 0 },
+};
+
+//
+// the year/month loop versions these replaced, from:
+//
+//   http://www.jbox.dk/sanos/source/lib/time.c.html
+//
+#define YEAR0                   1900
+#define EPOCH_YR                1970
+#define SECS_DAY                (24L * 60L * 60L)
+#define LEAPYEAR(year)          (!((year) % 4) && (((year) % 100) || !((year) % 400)))
+#define YEARSIZE(year)          (LEAPYEAR(year) ? 366 : 365)
+#define TIME_MAX                2147483647L
+
+static const int _ytab[2][12] =
+{
+{ 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 },
+{ 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 } };
+
+time_t ref_mktime(struct tm *tmbuf)
+{
+    long day, year;
+    int tm_year;
+    int yday, month;
+    long seconds;
+    int overflow;
+
+    tmbuf->tm_min += tmbuf->tm_sec / 60;
+    tmbuf->tm_sec %= 60;
+    if (tmbuf->tm_sec < 0)
+    {
+        tmbuf->tm_sec += 60;
+        tmbuf->tm_min--;
+    }
+    tmbuf->tm_hour += tmbuf->tm_min / 60;
+    tmbuf->tm_min = tmbuf->tm_min % 60;
+    if (tmbuf->tm_min < 0)
+    {
+        tmbuf->tm_min += 60;
+        tmbuf->tm_hour--;
+    }
+    day = tmbuf->tm_hour / 24;
+    tmbuf->tm_hour = tmbuf->tm_hour % 24;
+    if (tmbuf->tm_hour < 0)
+    {
+        tmbuf->tm_hour += 24;
+        day--;
+    }
+    tmbuf->tm_year += tmbuf->tm_mon / 12;
+    tmbuf->tm_mon %= 12;
+    if (tmbuf->tm_mon < 0)
+    {
+        tmbuf->tm_mon += 12;
+        tmbuf->tm_year--;
+    }
+    day += (tmbuf->tm_mday - 1);
+    while (day < 0)
+    {
+        if (--tmbuf->tm_mon < 0)
+        {
+            tmbuf->tm_year--;
+            tmbuf->tm_mon = 11;
+        }
+        day += _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon];
+    }
+    while (day >= _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon])
+    {
+        day -= _ytab[LEAPYEAR(YEAR0 + tmbuf->tm_year)][tmbuf->tm_mon];
+        if (++(tmbuf->tm_mon) == 12)
+        {
+            tmbuf->tm_mon = 0;
+            tmbuf->tm_year++;
+        }
+    }
+    tmbuf->tm_mday = day + 1;
+    year = EPOCH_YR;
+    if (tmbuf->tm_year < year - YEAR0)
+        return (time_t) -1;
+    seconds = 0;
+    day = 0;
+    overflow = 0;
+    tm_year = tmbuf->tm_year + YEAR0;
+
+    if (TIME_MAX / 365 < tm_year - year)
+        overflow++;
+    day = (tm_year - year) * 365;
+    if (TIME_MAX - day < (tm_year - year) / 4 + 1)
+        overflow++;
+    day += (tm_year - year) / 4 + ((tm_year % 4) && tm_year % 4 < year % 4);
+    day -= (tm_year - year) / 100
+            + ((tm_year % 100) && tm_year % 100 < year % 100);
+    day += (tm_year - year) / 400
+            + ((tm_year % 400) && tm_year % 400 < year % 400);
+
+    yday = month = 0;
+    while (month < tmbuf->tm_mon)
+    {
+        yday += _ytab[LEAPYEAR(tm_year)][month];
+        month++;
+    }
+    yday += (tmbuf->tm_mday - 1);
+    if (day + yday < 0)
+        overflow++;
+    day += yday;
+
+    tmbuf->tm_yday = yday;
+    tmbuf->tm_wday = (day + 4) % 7;
+
+    seconds = ((tmbuf->tm_hour * 60L) + tmbuf->tm_min) * 60L + tmbuf->tm_sec;
+
+    if ((TIME_MAX - seconds) / SECS_DAY < day)
+        overflow++;
+    seconds += day * SECS_DAY;
+
+    if (overflow)
+        return (time_t) -1;
+
+    if ((time_t) seconds != seconds)
+        return (time_t) -1;
+    return (time_t) seconds;
+}
+
+struct tm *ref_gmtime_r(const time_t *timer, struct tm *tmbuf)
+{
+    time_t time = *timer;
+    unsigned long dayclock, dayno;
+    int year = EPOCH_YR;
+
+    dayclock = (unsigned long) time % SECS_DAY;
+    dayno = (unsigned long) time / SECS_DAY;
+
+    tmbuf->tm_sec = dayclock % 60;
+    tmbuf->tm_min = (dayclock % 3600) / 60;
+    tmbuf->tm_hour = dayclock / 3600;
+    tmbuf->tm_wday = (dayno + 4) % 7;
+    while (dayno >= (unsigned long) YEARSIZE(year)) {
+        dayno -= YEARSIZE(year);
+        year++;
+    }
+    tmbuf->tm_year = year - YEAR0;
+    tmbuf->tm_yday = dayno;
+    tmbuf->tm_mon = 0;
+    while (dayno >= (unsigned long) _ytab[LEAPYEAR(year)][tmbuf->tm_mon]) {
+        dayno -= _ytab[LEAPYEAR(year)][tmbuf->tm_mon];
+        tmbuf->tm_mon++;
+    }
+    tmbuf->tm_mday = dayno + 1;
+    tmbuf->tm_isdst = 0;
+    return tmbuf;
+}
+
+// last day (exclusive) the identity checks can reach with this time_t
+static long lastDay()
+{
+    return sizeof(time_t) > 4 ? DAY_2200 : DAY_2038;
+}
+
+static void assertSameTM(struct tm* expected, struct tm* actual)
+{
+    TEST_ASSERT_EQUAL(expected->tm_sec,   actual->tm_sec);
+    TEST_ASSERT_EQUAL(expected->tm_min,   actual->tm_min);
+    TEST_ASSERT_EQUAL(expected->tm_hour,  actual->tm_hour);
+    TEST_ASSERT_EQUAL(expected->tm_mday,  actual->tm_mday);
+    TEST_ASSERT_EQUAL(expected->tm_mon,   actual->tm_mon);
+    TEST_ASSERT_EQUAL(expected->tm_year,  actual->tm_year);
+    TEST_ASSERT_EQUAL(expected->tm_wday,  actual->tm_wday);
+    TEST_ASSERT_EQUAL(expected->tm_yday,  actual->tm_yday);
+}
+
+void test_civil_days()
+{
+    TEST_ASSERT_EQUAL(0,        TimeUtils::daysFromCivil(1970, 1, 1));
+    TEST_ASSERT_EQUAL(DAY_2000, TimeUtils::daysFromCivil(2000, 1, 1));
+    TEST_ASSERT_EQUAL(DAY_2200, TimeUtils::daysFromCivil(2200, 1, 1));
+    for (long day = 0; day < DAY_2200; ++day)
+    {
+        int y, m, d;
+        TimeUtils::civilFromDays(day, &y, &m, &d);
+        TEST_ASSERT_EQUAL(day, TimeUtils::daysFromCivil(y, m, d));
+        if ((day & 0xff) == 0)
+        {
+            yield();
+        }
+    }
+}
+
+void test_gmtime_identity()
+{
+    for (long day = 0; day < lastDay(); ++day)
+    {
+        time_t t = day * SECS_DAY + (day * 7919) % SECS_DAY;
+        struct tm expected;
+        struct tm actual;
+        ref_gmtime_r(&t, &expected);
+        TimeUtils::gmtime_r(&t, &actual);
+        assertSameTM(&expected, &actual);
+        TEST_ASSERT_EQUAL(expected.tm_isdst, actual.tm_isdst);
+        if ((day & 0xff) == 0)
+        {
+            yield();
+        }
+    }
+}
+
+//
+// mktime must normalize out of range fields the same way too
+//
+void test_mktime_identity()
+{
+    static const int adjust[][5] = {
+        // sec   min  hour  mday   mon
+        {     0,    0,   0,    0,    0 },
+        {  3600,    0,   0,    0,    0 },
+        {     0,  -90,   0,    0,    0 },
+        {     0,    0,  30,    0,    0 },
+        {     0,    0,   0,   40,    0 },
+        {     0,    0,   0,  -40,    0 },
+        {     0,    0,   0,    0,   13 },
+        {     0,    0,   0,    0,  -13 },
+    };
+
+    for (long day = 0; day < lastDay(); ++day)
+    {
+        time_t t = day * SECS_DAY + (day * 7919) % SECS_DAY;
+        struct tm tm;
+        ref_gmtime_r(&t, &tm);
+        for (unsigned i = 0; i < sizeof(adjust)/sizeof(adjust[0]); ++i)
+        {
+            struct tm expected = tm;
+            expected.tm_sec  += adjust[i][0];
+            expected.tm_min  += adjust[i][1];
+            expected.tm_hour += adjust[i][2];
+            expected.tm_mday += adjust[i][3];
+            expected.tm_mon  += adjust[i][4];
+            struct tm actual = expected;
+            TEST_ASSERT_EQUAL(ref_mktime(&expected), TimeUtils::mktime(&actual));
+            assertSameTM(&expected, &actual);
+        }
+        if ((day & 0xff) == 0)
+        {
+            yield();
+        }
+    }
+}
+
+void test_ds3231_identity()
+{
+    for (long day = DAY_2000; day < DAY_2100; ++day)
+    {
+        unsigned long t = (unsigned long)day * SECS_DAY + (day * 7919) % SECS_DAY;
+        DS3231DateTime dt;
+        dt.setUnixTime(t);
+        TEST_ASSERT_EQUAL(t, dt.getUnixTime());
+
+        time_t tt = t;
+        struct tm tm;
+        ref_gmtime_r(&tt, &tm);
+        char expected[32];
+        snprintf(expected, sizeof(expected), "%04u-%02u-%02u %02u:%02u:%02u",
+                tm.tm_year + YEAR0, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        TEST_ASSERT_EQUAL_STRING(expected, dt.string());
+        TEST_ASSERT_EQUAL(tm.tm_wday, dt.getDay());
+        if ((day & 0xff) == 0)
+        {
+            yield();
+        }
+    }
+}
+
+//
+// the next change is in the local time of the offset before it, whatever
+// offset the caller had.  Just after a change the caller still has the old one.
+//
+void test_next_change()
+{
+    time_t next;
+    TEST_ASSERT_EQUAL(-28800, TimeUtils::computeUTCOffset(SPRING_2026 - 60, -28800, la_tc, 2, &next));
+    TEST_ASSERT_EQUAL(SPRING_2026, next);
+    TEST_ASSERT_EQUAL(-25200, TimeUtils::computeUTCOffset(SPRING_2026 + 60, -28800, la_tc, 2, &next));
+    TEST_ASSERT_EQUAL(FALL_2026, next);
+    TEST_ASSERT_EQUAL(-25200, TimeUtils::computeUTCOffset(FALL_2026 - 60, -25200, la_tc, 2, &next));
+    TEST_ASSERT_EQUAL(FALL_2026, next);
+    TEST_ASSERT_EQUAL(-28800, TimeUtils::computeUTCOffset(FALL_2026 + 60, -25200, la_tc, 2, &next));
+    TEST_ASSERT_EQUAL(SPRING_2027, next);
+}
+
+//
+// per call cost of what a wake does: an RTC read (getUnixTime) and the
+// gmtime_r/mktime pair behind computeUTCOffset.
+//
+void test_benchmark()
+{
+    struct tm tm;
+    time_t    t;
+    uint32_t  start;
+    uint32_t  sum = 0;
+
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        t = WAKE_TIME + i * 3607;
+        sum += ref_gmtime_r(&t, &tm)->tm_mday;
+    }
+    uint32_t ref_gmtime_us = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        t = WAKE_TIME + i * 3607;
+        sum += TimeUtils::gmtime_r(&t, &tm)->tm_mday;
+    }
+    uint32_t gmtime_us = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        t = WAKE_TIME + i * 3607;
+        ref_gmtime_r(&t, &tm);
+        sum += ref_mktime(&tm);
+    }
+    uint32_t ref_mktime_us = micros() - start - ref_gmtime_us;
+
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        t = WAKE_TIME + i * 3607;
+        ref_gmtime_r(&t, &tm);
+        sum += TimeUtils::mktime(&tm);
+    }
+    uint32_t mktime_us = micros() - start - ref_gmtime_us;
+
+    char message[96];
+    snprintf(message, sizeof(message), "us per call: gmtime_r %.2f -> %.2f mktime %.2f -> %.2f",
+            (double)ref_gmtime_us / BENCHMARK_RUNS, (double)gmtime_us / BENCHMARK_RUNS,
+            (double)ref_mktime_us / BENCHMARK_RUNS, (double)mktime_us / BENCHMARK_RUNS);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(ref_gmtime_us, gmtime_us);
+    TEST_ASSERT_LESS_THAN(ref_mktime_us, mktime_us);
+    (void)sum;
+}
+
+void setup()
+{
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_civil_days);
+    RUN_TEST(test_gmtime_identity);
+    RUN_TEST(test_mktime_identity);
+    RUN_TEST(test_ds3231_identity);
+    RUN_TEST(test_next_change);
+    RUN_TEST(test_benchmark);
+    UNITY_END();
+}
+
+void loop()
+{
+    delay(1000);
+}
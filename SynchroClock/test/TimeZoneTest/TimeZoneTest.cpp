@@ -0,0 +1,125 @@
+#include "TimeUtils.h"
+#include "TZData.h"
+#include "unity.h"
+
+
+#define YEAR_2024      1704067200
+#define YEAR_2037      2114380800
+#define BENCHMARK_RUNS 1000
+
+// the la env rules
+TimeChange la_tc[] = {
+    { -25200,  3, 2, 0, 2, 0 },
+    { -28800, 11, 1, 0, 2, 0 },
+};
+
+// the uk env rules
+TimeChange uk_tc[] = {
+    { 3600,  3, -1, 0, 1, 0 },
+    { 0,    10, -1, 0, 2, 0 },
+};
+
+void test_find()
+{
+    TimeZone zone;
+    TEST_ASSERT_EQUAL(0, TZData::find("America/Los_Angeles", &zone));
+    TEST_ASSERT_EQUAL_STRING("America/Los_Angeles", zone.name);
+    TEST_ASSERT_EQUAL(0, TZData::find("UTC", &zone));
+    TEST_ASSERT_EQUAL(-1, TZData::find("America/Nowhere", &zone));
+    TEST_ASSERT_EQUAL(-1, TZData::find("", &zone));
+
+    // every zone can be found by its own name
+    for (uint16_t i = 0; i < TZData::count(); ++i)
+    {
+        TimeZone found;
+        TEST_ASSERT_EQUAL(0, TZData::get(i, &zone));
+        TEST_ASSERT_EQUAL(0, TZData::find(zone.name, &found));
+        TEST_ASSERT_EQUAL_PTR(zone.times, found.times);
+    }
+}
+
+//
+// the table must agree with the rules, offset and next change, every 6
+// hours for the life of the table.
+//
+void test_rules(const char* name, TimeChange* tc)
+{
+    TimeZone zone;
+    TEST_ASSERT_EQUAL(0, TZData::find(name, &zone));
+    int tz_offset = TimeUtils::computeUTCOffset(YEAR_2024, &zone, NULL);
+    for (time_t now = YEAR_2024; now < YEAR_2037; now += 6*3600)
+    {
+        time_t table_next;
+        time_t rules_next;
+        int table_offset = TimeUtils::computeUTCOffset(now, &zone, &table_next);
+        int rules_offset = TimeUtils::computeUTCOffset(now, tz_offset, tc, 2, &rules_next);
+        TEST_ASSERT_EQUAL(rules_offset, table_offset);
+        TEST_ASSERT_EQUAL(rules_next, table_next);
+        tz_offset = table_offset;
+    }
+}
+
+void test_la_rules()
+{
+    test_rules("America/Los_Angeles", la_tc);
+}
+
+void test_uk_rules()
+{
+    test_rules("Europe/London", uk_tc);
+}
+
+void test_no_transitions()
+{
+    TimeZone zone;
+    time_t next;
+    TEST_ASSERT_EQUAL(0, TZData::find("Asia/Bangkok", &zone));
+    TEST_ASSERT_EQUAL(25200, TimeUtils::computeUTCOffset(YEAR_2024, &zone, &next));
+    TEST_ASSERT_EQUAL(0, next);
+}
+
+void test_benchmark()
+{
+    TimeZone zone;
+    TEST_ASSERT_EQUAL(0, TZData::find("America/Los_Angeles", &zone));
+    time_t next;
+    int sum = 0;
+
+    uint32_t start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        sum += TimeUtils::computeUTCOffset(YEAR_2024 + i*86400*4, -28800, la_tc, 2, &next);
+    }
+    uint32_t rules_us = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < BENCHMARK_RUNS; ++i)
+    {
+        sum -= TimeUtils::computeUTCOffset(YEAR_2024 + i*86400*4, &zone, &next);
+    }
+    uint32_t table_us = micros() - start;
+
+    char message[80];
+    snprintf(message, sizeof(message), "lookup us: rules %.2f table %.2f",
+            (double)rules_us / BENCHMARK_RUNS, (double)table_us / BENCHMARK_RUNS);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN(rules_us, table_us);
+    (void)sum;
+}
+
+void setup()
+{
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_find);
+    RUN_TEST(test_la_rules);
+    RUN_TEST(test_uk_rules);
+    RUN_TEST(test_no_transitions);
+    RUN_TEST(test_benchmark);
+    UNITY_END();
+}
+
+void loop()
+{
+    delay(1000);
+}
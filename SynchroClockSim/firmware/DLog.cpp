@@ -0,0 +1,143 @@
+/*
+ * DLog.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "DLog.h"
+#include <stdio.h>
+
+static DLogLevel sim_level = DLOG_LEVEL_NONE;
+
+void DLogBuffer::printf(const __FlashStringHelper* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf((const char*)fmt, ap);
+    va_end(ap);
+}
+
+void DLogBuffer::printf(const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+}
+
+void DLogBuffer::vprintf(const char* fmt, va_list ap)
+{
+    if (length < sizeof(buffer) - 1)
+    {
+        int n = vsnprintf(buffer + length, sizeof(buffer) - length, fmt, ap);
+        if (n > 0)
+        {
+            length = std::min(length + n, sizeof(buffer) - 1);
+        }
+    }
+}
+
+DLog::DLog() : pre_func(NULL)
+{
+}
+
+DLog& DLog::getLog()
+{
+    static DLog log;
+    return log;
+}
+
+void DLog::setSimLevel(DLogLevel level)
+{
+    sim_level = level;
+}
+
+void DLog::begin(DLogWriter* writer)
+{
+    writers.push_back(writer);
+}
+
+void DLog::end()
+{
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        writers[i]->end();
+        delete writers[i];
+    }
+    writers.clear();
+}
+
+void DLog::setPreFunc(DLogPreFunc func)
+{
+    pre_func = func;
+}
+
+void DLog::setLevel(const __FlashStringHelper* tag, DLogLevel level)
+{
+    setLevel((const char*)tag, level);
+}
+
+void DLog::setLevel(const char* tag, DLogLevel level)
+{
+    (void)tag;
+    (void)level;
+}
+
+void DLog::log(DLogLevel level, const char* tag, const char* fmt, va_list ap)
+{
+    static const char levels[] = "-EWIDT";
+
+    sim.log(tag);
+    if (level > std::max(sim_level, DLOG_SIM_WRITER_LEVEL) || writers.empty())
+    {
+        return;
+    }
+
+    DLogBuffer buffer;
+    if (pre_func != NULL)
+    {
+        pre_func(buffer, level);
+    }
+    buffer.printf("%c %s: ", levels[level], tag);
+    buffer.vprintf(fmt, ap);
+    buffer.printf("\n");
+
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        if (writers[i]->console() ? level <= sim_level : level <= DLOG_SIM_WRITER_LEVEL)
+        {
+            writers[i]->write(buffer.c_str());
+        }
+    }
+}
+
+#define DLOG_LEVEL_FUNC(name, level) \
+void DLog::name(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...) \
+{ \
+    va_list ap; \
+    va_start(ap, fmt); \
+    log(level, (const char*)tag, (const char*)fmt, ap); \
+    va_end(ap); \
+}
+
+DLOG_LEVEL_FUNC(error,   DLOG_LEVEL_ERROR)
+DLOG_LEVEL_FUNC(warning, DLOG_LEVEL_WARNING)
+DLOG_LEVEL_FUNC(info,    DLOG_LEVEL_INFO)
+DLOG_LEVEL_FUNC(debug,   DLOG_LEVEL_DEBUG)
+DLOG_LEVEL_FUNC(trace,   DLOG_LEVEL_TRACE)
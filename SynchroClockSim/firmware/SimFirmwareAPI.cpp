@@ -0,0 +1,62 @@
+/*
+ * SimFirmwareAPI.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// Built into the firmware shared object, gives the simulator a C entry
+// point to the sketch functions and globals it drives.
+//
+
+#include "SimFirmware.h"
+
+extern Config        config;
+extern DeepSleepData dsd;
+extern TimeBase      timebase;
+
+static int edgeSyncedTime(uint32_t* unix_time, uint32_t* edge_us, unsigned int retries)
+{
+    DS3231DateTime dt;
+    int err = getEdgeSyncedTime(dt, edge_us, retries);
+    *unix_time = err ? 0 : dt.getUnixTime();
+    return err;
+}
+
+static void invalidateTimeBase()
+{
+    timebase.invalidate();
+}
+
+static const SimFirmwareAPI api =
+{
+    setup,
+    edgeSyncedTime,
+    setCLKfromRTC,
+    invalidateTimeBase,
+    calculateCRC32,
+    DLog::setSimLevel,
+    &config,
+    &dsd,
+};
+
+extern "C" const SimFirmwareAPI* simFirmwareAPI()
+{
+    return &api;
+}
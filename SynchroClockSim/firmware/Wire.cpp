@@ -0,0 +1,171 @@
+/*
+ * Wire.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Wire.h"
+#include "SimI2C.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+{
+    tx_address   = 0;
+    transmitting = false;
+    tx_length    = 0;
+    rx_length    = 0;
+    rx_index     = 0;
+}
+
+void TwoWire::begin()
+{
+    transmitting = false;
+    tx_length    = 0;
+    rx_length    = 0;
+    rx_index     = 0;
+}
+
+void TwoWire::begin(int sda, int scl)
+{
+    (void)sda;
+    (void)scl;
+    begin();
+}
+
+void TwoWire::setClock(uint32_t hz)
+{
+    i2c.setClock(hz);
+}
+
+void TwoWire::setClockStretchLimit(uint32_t limit)
+{
+    i2c.setStretchLimit(limit);
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    tx_address   = address;
+    transmitting = true;
+    tx_length    = 0;
+}
+
+void TwoWire::beginTransmission(int address)
+{
+    beginTransmission((uint8_t)address);
+}
+
+uint8_t TwoWire::endTransmission()
+{
+    return endTransmission(true);
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop)
+{
+    int err = i2c.write(tx_address, tx_buffer, tx_length, sendStop);
+    transmitting = false;
+    tx_length    = 0;
+    return err;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t size, bool sendStop)
+{
+    if (size > BUFFER_LENGTH)
+    {
+        size = BUFFER_LENGTH;
+    }
+    rx_length = i2c.read(address, rx_buffer, size, sendStop);
+    rx_index  = 0;
+    return rx_length;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t size)
+{
+    return requestFrom(address, size, true);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t size)
+{
+    return requestFrom(address, (size_t)size, true);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t size, uint8_t sendStop)
+{
+    return requestFrom(address, (size_t)size, sendStop != 0);
+}
+
+uint8_t TwoWire::requestFrom(int address, int size)
+{
+    return requestFrom((uint8_t)address, (size_t)size, true);
+}
+
+uint8_t TwoWire::requestFrom(int address, int size, int sendStop)
+{
+    return requestFrom((uint8_t)address, (size_t)size, sendStop != 0);
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+    if (!transmitting || tx_length >= BUFFER_LENGTH)
+    {
+        return 0;
+    }
+    tx_buffer[tx_length++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t size)
+{
+    size_t count = 0;
+    while (count < size && write(data[count]))
+    {
+        ++count;
+    }
+    return count;
+}
+
+int TwoWire::available()
+{
+    return rx_length - rx_index;
+}
+
+int TwoWire::read()
+{
+    if (rx_index >= rx_length)
+    {
+        return -1;
+    }
+    return rx_buffer[rx_index++];
+}
+
+int TwoWire::peek()
+{
+    if (rx_index >= rx_length)
+    {
+        return -1;
+    }
+    return rx_buffer[rx_index];
+}
+
+void TwoWire::flush()
+{
+    tx_length = 0;
+    rx_length = 0;
+    rx_index  = 0;
+}
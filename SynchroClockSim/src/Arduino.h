@@ -0,0 +1,149 @@
+/*
+ * Arduino.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ARDUINO_H_
+#define ARDUINO_H_
+
+//
+// just enough of the ESP8266 Arduino core for the SynchroClock firmware
+// to build on the host, time and pins come from the simulator.
+//
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include "Sim.h"
+
+typedef bool     boolean;
+typedef uint8_t  byte;
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int32_t  sint32;
+
+#define HIGH          0x1
+#define LOW           0x0
+
+#define INPUT         0x00
+#define INPUT_PULLUP  0x02
+#define OUTPUT        0x01
+
+#define RISING        SIM_RISING
+#define FALLING       SIM_FALLING
+#define CHANGE        SIM_CHANGE
+
+#define SDA           4
+#define SCL           5
+
+#define _BV(b)        (1UL << (b))
+
+#define PROGMEM
+#define PGM_P         const char*
+#define ICACHE_RAM_ATTR
+#define PSTR(s)       (s)
+
+class __FlashStringHelper;
+#define F(s)          (reinterpret_cast<const __FlashStringHelper *>(s))
+#define FPSTR(p)      (reinterpret_cast<const __FlashStringHelper *>(p))
+
+#define strncpy_P     strncpy
+#define strlen_P      strlen
+#define strnlen_P     strnlen
+#define strcmp_P      strcmp
+#define memcpy_P      memcpy
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define snprintf_P    snprintf
+#define sprintf_P     sprintf
+#define vsnprintf_P   vsnprintf
+
+#define digitalPinToInterrupt(p) (p)
+
+inline uint32_t micros()
+{
+    sim.advance(SIM_POLL_COST_US);
+    return (uint32_t)sim.now();
+}
+
+inline uint32_t millis()
+{
+    sim.advance(SIM_POLL_COST_US);
+    return (uint32_t)(sim.now() / 1000);
+}
+
+inline void delay(unsigned long ms)
+{
+    sim.advance((uint64_t)ms * 1000);
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+    sim.advance(us);
+}
+
+inline void yield()
+{
+    sim.advance(SIM_YIELD_COST_US);
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+    sim.pinMode(pin, mode);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+    sim.drivePin(pin, value ? SIM_HIGH : SIM_LOW);
+}
+
+inline int digitalRead(uint8_t pin)
+{
+    return sim.readPin(pin) ? HIGH : LOW;
+}
+
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int mode)
+{
+    sim.attachInterrupt(pin, isr, mode);
+}
+
+inline void detachInterrupt(uint8_t pin)
+{
+    sim.detachInterrupt(pin);
+}
+
+// the sketch
+void setup();
+void loop();
+
+#include "WString.h"
+#include "IPAddress.h"
+#include "Print.h"
+#include "Esp.h"
+
+#endif /* ARDUINO_H_ */
@@ -0,0 +1,98 @@
+/*
+ * DLog.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef DLOG_H_
+#define DLOG_H_
+
+//
+// host stand in for the DLog library, lines go to stdout when the
+// level allows it.  The simulator is quiet unless asked to be verbose,
+// other writers (syslog) get what a device would send.
+//
+
+#include "Arduino.h"
+#include <stdarg.h>
+
+typedef enum
+{
+    DLOG_LEVEL_NONE = 0,
+    DLOG_LEVEL_ERROR,
+    DLOG_LEVEL_WARNING,
+    DLOG_LEVEL_INFO,
+    DLOG_LEVEL_DEBUG,
+    DLOG_LEVEL_TRACE
+} DLogLevel;
+
+#define DLOG_SIM_WRITER_LEVEL DLOG_LEVEL_INFO // LOGGER_LEVEL_MAX in platformio.ini
+
+class DLogBuffer
+{
+public:
+    DLogBuffer() : length(0) { buffer[0] = 0; }
+    void printf(const __FlashStringHelper* fmt, ...);
+    void printf(const char* fmt, ...);
+    void vprintf(const char* fmt, va_list ap);
+    const char* c_str() const { return buffer; }
+private:
+    char   buffer[512];
+    size_t length;
+};
+
+class DLogWriter
+{
+public:
+    virtual ~DLogWriter() {}
+    virtual void write(const char* message) = 0;
+    virtual void flush() {}
+    virtual void end() {}
+    virtual bool console() { return false; } // quiet unless the simulator is verbose
+};
+
+typedef void (*DLogPreFunc)(DLogBuffer& buffer, DLogLevel level);
+
+class DLog
+{
+public:
+    static DLog& getLog();
+    static void  setSimLevel(DLogLevel level);
+
+    void begin(DLogWriter* writer);
+    void end();
+    void setPreFunc(DLogPreFunc func);
+    void setLevel(const __FlashStringHelper* tag, DLogLevel level);
+    void setLevel(const char* tag, DLogLevel level);
+
+    void error(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...);
+    void warning(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...);
+    void info(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...);
+    void debug(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...);
+    void trace(const __FlashStringHelper* tag, const __FlashStringHelper* fmt, ...);
+
+private:
+    DLog();
+    void log(DLogLevel level, const char* tag, const char* fmt, va_list ap);
+
+    std::vector<DLogWriter*> writers;
+    DLogPreFunc              pre_func;
+};
+
+#endif /* DLOG_H_ */
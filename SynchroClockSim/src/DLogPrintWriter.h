@@ -0,0 +1,38 @@
+/*
+ * DLogPrintWriter.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef DLOGPRINTWRITER_H_
+#define DLOGPRINTWRITER_H_
+
+#include "DLog.h"
+
+class DLogPrintWriter : public DLogWriter
+{
+public:
+    DLogPrintWriter(Print& _out) : out(_out) {}
+    void write(const char* message) { out.print(message); }
+    bool console()                  { return true; }
+private:
+    Print& out;
+};
+
+#endif /* DLOGPRINTWRITER_H_ */
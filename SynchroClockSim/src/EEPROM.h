@@ -0,0 +1,51 @@
+/*
+ * EEPROM.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "Arduino.h"
+
+#define SIM_FLASH_SECTOR 4096
+
+//
+// flash backed EEPROM emulation, the sector survives restarts
+//
+class EEPROMClass
+{
+public:
+    EEPROMClass() : size(0), commits(0) { memset(flash, 0xff, sizeof(flash)); }
+    void    begin(size_t _size)                { size = std::min(_size, (size_t)SIM_FLASH_SECTOR); }
+    uint8_t read(int address)                  { return (size_t)address < size ? flash[address] : 0; }
+    void    write(int address, uint8_t value)  { if ((size_t)address < size) flash[address] = value; }
+    bool    commit()                           { ++commits; return size != 0; }
+    size_t  length()                           { return size; }
+    void    end()                              { size = 0; }
+
+    uint8_t  flash[SIM_FLASH_SECTOR];
+    size_t   size;
+    uint32_t commits;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif /* EEPROM_H_ */
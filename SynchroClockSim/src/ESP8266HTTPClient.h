@@ -0,0 +1,51 @@
+/*
+ * ESP8266HTTPClient.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ESP8266HTTPCLIENT_H_
+#define ESP8266HTTPCLIENT_H_
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTP_CODE_OK                   200
+#define HTTP_CODE_PARTIAL_CONTENT      206
+
+//
+// there is no http server on the simulated network, every request fails
+// to connect.
+//
+class HTTPClient
+{
+public:
+    bool        begin(WiFiClient& client, const String& url)             { (void)client; (void)url; return true; }
+    void        end()                                                   {}
+    void        useHTTP10(bool use)                                     { (void)use; }
+    void        setTimeout(uint16_t timeout)                            { (void)timeout; }
+    template <typename N>
+    void        addHeader(N name, const String& value)                  { (void)name; (void)value; }
+    int         GET()                                                   { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    int         getSize()                                               { return -1; }
+    WiFiClient* getStreamPtr()                                          { return nullptr; }
+};
+
+#endif /* ESP8266HTTPCLIENT_H_ */
@@ -0,0 +1,57 @@
+/*
+ * ESP8266WebServer.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ESP8266WEBSERVER_H_
+#define ESP8266WEBSERVER_H_
+
+#include "Arduino.h"
+#include <functional>
+
+typedef enum
+{
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+} HTTPMethod;
+
+//
+// nothing ever connects on the host
+//
+class ESP8266WebServer
+{
+public:
+    ESP8266WebServer(int port)                                          { (void)port; }
+    void   on(const char* uri, HTTPMethod method, std::function<void()> handler) { (void)uri; (void)method; (void)handler; }
+    void   begin()                                                      {}
+    void   handleClient()                                               {}
+    void   send(int code, const char* type, const String& content)      { (void)code; (void)type; (void)content; }
+    bool   hasArg(const String& name)                                   { (void)name; return false; }
+    String arg(const String& name)                                      { (void)name; return String(); }
+    template <typename T>
+    size_t streamFile(T& file, const char* type)                        { (void)type; return file.size(); }
+};
+
+#endif /* ESP8266WEBSERVER_H_ */
@@ -0,0 +1,93 @@
+/*
+ * ESP8266WiFi.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ESP8266WIFI_H_
+#define ESP8266WIFI_H_
+
+#include "Arduino.h"
+
+typedef enum
+{
+    WIFI_OFF    = 0,
+    WIFI_STA    = 1,
+    WIFI_AP     = 2,
+    WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum
+{
+    WIFI_NONE_SLEEP  = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2
+} WiFiSleepType_t;
+
+class WiFiClient
+{
+public:
+    virtual ~WiFiClient() {}
+    int     available()                         { return 0; }
+    uint8_t connected()                         { return 0; }
+    size_t  read(uint8_t* buf, size_t size)     { (void)buf; (void)size; return 0; }
+};
+
+namespace BearSSL
+{
+    class CertStore
+    {
+    };
+
+    class WiFiClientSecure : public WiFiClient
+    {
+    public:
+        void setInsecure() {}
+        void setCertStore(CertStore* store) { (void)store; }
+    };
+}
+
+//
+// station that joins the network connect_ms after it is asked to, if the
+// network is there at all.
+//
+class ESP8266WiFiClass
+{
+public:
+    ESP8266WiFiClass();
+    bool      mode(WiFiMode_t mode);
+    bool      isConnected();
+    IPAddress localIP();
+    String    macAddress();
+    int       hostByName(const char* name, IPAddress& address);
+    bool      connect(uint32_t timeout_ms);
+    void      disconnect();
+    bool      setSleepMode(WiFiSleepType_t type, uint8_t listenInterval = 0);
+
+    bool      available;     // an access point we can join is in range
+    uint32_t  connect_ms;    // association + dhcp time
+    IPAddress address;
+
+private:
+    bool      connected;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif /* ESP8266WIFI_H_ */
@@ -0,0 +1,53 @@
+/*
+ * ESP8266httpUpdate.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ESP8266HTTPUPDATE_H_
+#define ESP8266HTTPUPDATE_H_
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+
+typedef enum
+{
+    HTTP_UPDATE_FAILED,
+    HTTP_UPDATE_NO_UPDATES,
+    HTTP_UPDATE_OK
+} HTTPUpdateResult;
+
+typedef HTTPUpdateResult t_httpUpdate_return;
+
+class ESP8266HTTPUpdate
+{
+public:
+    void               rebootOnUpdate(bool reboot) { (void)reboot; }
+    void               followRedirects(bool follow) { (void)follow; }
+    t_httpUpdate_return update(WiFiClient& client, const String& url, const String& version)
+    {
+        (void)client; (void)url; (void)version;
+        return HTTP_UPDATE_NO_UPDATES;
+    }
+    String             getLastErrorString() { return String("no updates on the host"); }
+};
+
+extern ESP8266HTTPUpdate ESPhttpUpdate;
+
+#endif /* ESP8266HTTPUPDATE_H_ */
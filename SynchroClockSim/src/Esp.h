@@ -0,0 +1,101 @@
+/*
+ * Esp.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef ESP_H_
+#define ESP_H_
+
+#include <stdint.h>
+#include "WString.h"
+
+#define SIM_RTC_USER_MEMORY 512 // bytes of RTC user memory that survive deep sleep
+#define SIM_DEEP_SLEEP_MAX  12700000000ULL // us, deepSleepMax() with a typical RTC clock calibration
+
+enum RFMode
+{
+    RF_DEFAULT  = 0,
+    RF_CAL      = 1,
+    RF_NO_CAL   = 2,
+    RF_DISABLED = 4
+};
+
+enum rst_reason
+{
+    REASON_DEFAULT_RST      = 0,
+    REASON_WDT_RST          = 1,
+    REASON_EXCEPTION_RST    = 2,
+    REASON_SOFT_WDT_RST     = 3,
+    REASON_SOFT_RESTART     = 4,
+    REASON_DEEP_SLEEP_AWAKE = 5,
+    REASON_EXT_SYS_RST      = 6
+};
+
+struct rst_info
+{
+    uint32_t reason;
+    uint32_t exccause;
+    uint32_t epc1;
+    uint32_t epc2;
+    uint32_t epc3;
+    uint32_t excvaddr;
+    uint32_t depc;
+};
+
+//
+// thrown to unwind the firmware when it deep sleeps or restarts
+//
+class SimDeepSleep
+{
+public:
+    SimDeepSleep(uint64_t _us, RFMode _mode) : us(_us), mode(_mode) {}
+    uint64_t us;
+    RFMode   mode;
+};
+
+class SimRestart
+{
+};
+
+class EspClass
+{
+public:
+    EspClass();
+    uint32_t  getFreeHeap();
+    uint32_t  getChipId();
+    rst_info* getResetInfoPtr();
+    String    getResetReason();
+    void      deepSleep(uint64_t time_us, RFMode mode = RF_DEFAULT);
+    uint64_t  deepSleepMax();
+    void      restart();
+    bool      eraseConfig();
+    uint32_t  getSketchSize();
+    String    getSketchMD5();
+    bool      flashRead(uint32_t offset, uint32_t *data, size_t size);
+    bool      rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+    bool      rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+    rst_info  reset_info;
+    uint8_t   rtc_memory[SIM_RTC_USER_MEMORY];
+};
+
+extern EspClass ESP;
+
+#endif /* ESP_H_ */
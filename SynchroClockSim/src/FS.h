@@ -0,0 +1,59 @@
+/*
+ * FS.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef FS_H_
+#define FS_H_
+
+#include "Arduino.h"
+#include <map>
+#include <string>
+
+class File
+{
+public:
+    File() : data(NULL), position(0) {}
+    File(std::string* _data) : data(_data), position(0) {}
+    operator bool() const                        { return data != NULL; }
+    size_t size()                                { return data ? data->size() : 0; }
+    size_t read(uint8_t* buffer, size_t size);
+    size_t write(const uint8_t* buffer, size_t size);
+    void   close()                               { data = NULL; }
+private:
+    std::string* data;
+    size_t       position;
+};
+
+class FS
+{
+public:
+    bool begin()                                 { return true; }
+    File open(const char* path, const char* mode);
+    bool exists(const char* path)                { return files.count(path) != 0; }
+    bool remove(const char* path)                { return files.erase(path) != 0; }
+    bool rename(const char* from, const char* to);
+private:
+    std::map<std::string, std::string> files;
+};
+
+extern FS SPIFFS;
+
+#endif /* FS_H_ */
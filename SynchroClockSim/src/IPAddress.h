@@ -0,0 +1,63 @@
+/*
+ * IPAddress.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef IPADDRESS_H_
+#define IPADDRESS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WString.h"
+
+class IPAddress
+{
+public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+    IPAddress(uint32_t value) : address(value) {}
+
+    operator uint32_t() const           { return address; }
+    uint8_t operator[](int i) const     { return (address >> (i * 8)) & 0xff; }
+    bool    isSet() const               { return address != 0; }
+
+    bool fromString(const char* s)
+    {
+        unsigned int a, b, c, d;
+        if (sscanf(s, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        {
+            return false;
+        }
+        address = a | b << 8 | c << 16 | (uint32_t)d << 24;
+        return true;
+    }
+
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(buf);
+    }
+
+private:
+    uint32_t address;
+};
+
+#endif /* IPADDRESS_H_ */
@@ -0,0 +1,56 @@
+/*
+ * Print.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef PRINT_H_
+#define PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t print(const char* s);
+    size_t println(const char* s);
+    size_t printf(const char* fmt, ...) __attribute__ ((format (printf, 2, 3)));
+    void   clearWriteError() {}
+};
+
+//
+// serial output goes to stdout when the simulator is verbose
+//
+class HardwareSerial : public Print
+{
+public:
+    void   begin(unsigned long baud) { (void)baud; }
+    void   end() {}
+    void   flush() {}
+    size_t write(uint8_t c);
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif /* PRINT_H_ */
@@ -0,0 +1,200 @@
+/*
+ * Sim.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "Sim.h"
+#include <string.h>
+
+Sim sim;
+
+Sim::Sim()
+{
+    next_id = 1;
+    reset();
+}
+
+void Sim::reset()
+{
+    time      = 0;
+    stop_time = UINT64_MAX;
+    events.clear();
+    listeners.clear();
+    log_listeners.clear();
+    pin_mode_hook = nullptr;
+    for (int i = 0; i < SIM_PIN_COUNT; ++i)
+    {
+        pins[i]      = SIM_HIGH; // everything idles pulled up
+        isrs[i]      = NULL;
+        isr_modes[i] = 0;
+    }
+}
+
+uint64_t Sim::now()
+{
+    return time;
+}
+
+void Sim::advance(uint64_t us)
+{
+    advanceTo(time + us);
+}
+
+//
+// run every event due before when, the clock reads the event time while
+// it runs so pin interrupts see the exact edge time.
+//
+void Sim::advanceTo(uint64_t when)
+{
+    while (!events.empty() && events.begin()->first <= when)
+    {
+        EventMap::iterator it = events.begin();
+        SimEvent event = it->second.second;
+        if (it->first > time)
+        {
+            time = it->first;
+        }
+        events.erase(it);
+        event();
+    }
+
+    if (when > time)
+    {
+        time = when;
+    }
+
+    if (time >= stop_time)
+    {
+        stop_time = UINT64_MAX;
+        throw SimStop();
+    }
+}
+
+void Sim::stopAt(uint64_t when)
+{
+    stop_time = when;
+}
+
+uint64_t Sim::at(uint64_t when, SimEvent event)
+{
+    uint64_t id = next_id++;
+    events.insert(std::make_pair(when, std::make_pair(id, event)));
+    return id;
+}
+
+void Sim::cancel(uint64_t id)
+{
+    for (EventMap::iterator it = events.begin(); it != events.end(); ++it)
+    {
+        if (it->second.first == id)
+        {
+            events.erase(it);
+            return;
+        }
+    }
+}
+
+int Sim::readPin(int pin)
+{
+    if (pin < 0 || pin >= SIM_PIN_COUNT)
+    {
+        return SIM_LOW;
+    }
+    return pins[pin];
+}
+
+void Sim::drivePin(int pin, int level)
+{
+    if (pin < 0 || pin >= SIM_PIN_COUNT || pins[pin] == level)
+    {
+        return;
+    }
+    pins[pin] = level;
+
+    int edge = level ? SIM_RISING : SIM_FALLING;
+    if (isrs[pin] != NULL && (isr_modes[pin] & edge))
+    {
+        isrs[pin]();
+    }
+
+    for (size_t i = 0; i < listeners.size(); ++i)
+    {
+        listeners[i](pin, level);
+    }
+}
+
+void Sim::listen(SimPinListener listener)
+{
+    listeners.push_back(listener);
+}
+
+void Sim::attachInterrupt(int pin, void (*isr)(), int mode)
+{
+    if (pin >= 0 && pin < SIM_PIN_COUNT)
+    {
+        isrs[pin]      = isr;
+        isr_modes[pin] = mode;
+    }
+}
+
+void Sim::detachInterrupt(int pin)
+{
+    if (pin >= 0 && pin < SIM_PIN_COUNT)
+    {
+        isrs[pin] = NULL;
+    }
+}
+
+//
+// the ESP resets out of deep sleep, its handlers go with it
+//
+void Sim::detachInterrupts()
+{
+    for (int i = 0; i < SIM_PIN_COUNT; ++i)
+    {
+        isrs[i] = NULL;
+    }
+}
+
+void Sim::pinMode(int pin, int mode)
+{
+    if (pin_mode_hook)
+    {
+        pin_mode_hook(pin, mode);
+    }
+}
+
+void Sim::setPinModeHook(std::function<void(int pin, int mode)> hook)
+{
+    pin_mode_hook = hook;
+}
+
+void Sim::log(const char* tag)
+{
+    for (size_t i = 0; i < log_listeners.size(); ++i)
+    {
+        log_listeners[i](tag);
+    }
+}
+
+void Sim::listenLog(SimLogListener listener)
+{
+    log_listeners.push_back(listener);
+}
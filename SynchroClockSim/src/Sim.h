@@ -0,0 +1,101 @@
+/*
+ * Sim.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+//
+// Virtual time and GPIO for running the SynchroClock firmware on a host.
+// Time only moves when the firmware waits (delay, yield, polling micros)
+// or talks on the i2c bus, device models schedule their own events.
+//
+
+#define SIM_PIN_COUNT      17
+#define SIM_POLL_COST_US   1    // cost of a micros()/millis() call so spin loops make progress
+#define SIM_YIELD_COST_US  100  // yield() gives the SDK this long
+
+#define SIM_LOW     0
+#define SIM_HIGH    1
+
+#define SIM_RISING  1
+#define SIM_FALLING 2
+#define SIM_CHANGE  3
+
+typedef std::function<void()>                  SimEvent;
+typedef std::function<void(int pin, int level)> SimPinListener;
+typedef std::function<void(const char* tag)>    SimLogListener;
+
+class SimStop
+{
+};
+
+class Sim
+{
+public:
+    Sim();
+    void     reset();
+    uint64_t now();
+    void     advance(uint64_t us);
+    void     advanceTo(uint64_t when);
+    void     stopAt(uint64_t when);
+
+    // returns an id that can be passed to cancel(), ids are never reused
+    uint64_t at(uint64_t when, SimEvent event);
+    void     cancel(uint64_t id);
+
+    int      readPin(int pin);
+    void     drivePin(int pin, int level);
+    void     listen(SimPinListener listener);
+    void     attachInterrupt(int pin, void (*isr)(), int mode);
+    void     detachInterrupt(int pin);
+    void     detachInterrupts();
+    void     pinMode(int pin, int mode);
+    void     setPinModeHook(std::function<void(int pin, int mode)> hook);
+
+    // every firmware log call passes its tag through here, any level
+    void     log(const char* tag);
+    void     listenLog(SimLogListener listener);
+
+private:
+    typedef std::multimap<uint64_t, std::pair<uint64_t, SimEvent> > EventMap;
+
+    uint64_t                    time;
+    uint64_t                    stop_time;
+    uint64_t                    next_id;
+    EventMap                    events;
+    int                         pins[SIM_PIN_COUNT];
+    void                      (*isrs[SIM_PIN_COUNT])();
+    int                         isr_modes[SIM_PIN_COUNT];
+    std::vector<SimPinListener> listeners;
+    std::vector<SimLogListener> log_listeners;
+    std::function<void(int pin, int mode)> pin_mode_hook;
+};
+
+extern Sim sim;
+
+#endif /* SIM_H_ */
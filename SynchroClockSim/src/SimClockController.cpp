@@ -0,0 +1,361 @@
+/*
+ * SimClockController.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimClockController.h"
+#include "Sim.h"
+#include <string.h>
+
+#define CMD_ID          0x00
+#define CMD_POSITION    0x01
+#define CMD_ADJUSTMENT  0x02
+#define CMD_CONTROL     0x03
+#define CMD_STATUS      0x04
+#define CMD_TP_DURATION 0x05
+#define CMD_SAVE_CONFIG 0x06
+#define CMD_AP_DURATION 0x07
+#define CMD_AP_START    0x08
+#define CMD_AP_DELAY    0x09
+#define CMD_PWMTOP      0x0a
+#define CMD_TP_DUTY     0x0b
+#define CMD_AP_DUTY     0x0c
+#define CMD_RESET       0x0d
+#define CMD_RST_REASON  0x0e
+#define CMD_VERSION     0x0f
+#define CMD_SNAPSHOT    0x10
+#define CMD_PAUSE       0x11
+#define CMD_TARGET      0x12
+#define CMD_CONFIG      0x20
+
+#define BIT_ENABLE      0x80
+#define STATUS_BIT_TICK 0x01
+#define ID_VALUE        0x42
+
+#define CONFIG_TP_DURATION 0
+#define CONFIG_TP_DUTY     1
+#define CONFIG_AP_DURATION 2
+#define CONFIG_AP_DUTY     3
+#define CONFIG_AP_DELAY    4
+#define CONFIG_AP_START    5
+#define CONFIG_PWM_TOP     6
+
+static const uint8_t default_config[SIM_CLOCK_CONFIG_SIZE] = { 32, 43, 17, 45, 9, 34, 250 };
+
+SimClockController::SimClockController(int sync_pin) : SimI2CDevice("Clock", SIM_CLOCK_STRETCH_US)
+{
+    pin          = sync_pin;
+    version      = SIM_CLOCK_VERSION;
+    command      = 0;
+    have_command = false;
+    tx_index     = 0;
+    control      = 0;
+    status       = 0;
+    reset_reason = 0;
+    position     = 0;
+    adjustment   = 0;
+    pause        = 0;
+    target       = 0;
+    target_ticks = 0;
+    step_event   = 0;
+    memcpy(config, default_config, sizeof(config));
+}
+
+//
+// power on with the clock showing position, call after sim.reset()
+//
+void SimClockController::begin(uint16_t _position, bool enabled, uint8_t _version)
+{
+    version      = _version;
+    command      = 0;
+    have_command = false;
+    tx_index     = 0;
+    control      = enabled ? BIT_ENABLE : 0;
+    status       = 0;
+    reset_reason = 0;
+    position     = _position;
+    adjustment   = 0;
+    pause        = 0;
+    target       = 0;
+    target_ticks = 0;
+    step_event   = 0;
+    memcpy(config, default_config, sizeof(config));
+    rx.clear();
+    tx.clear();
+    sim.listen([this](int p, int level)
+    {
+        if (p == pin && level == SIM_LOW)
+        {
+            tick();
+        }
+    });
+}
+
+//
+// move the hands without a command, like someone setting the clock by hand
+//
+void SimClockController::setPosition(uint16_t _position)
+{
+    position = _position % SIM_CLOCK_MAX;
+}
+
+uint16_t SimClockController::getPosition()
+{
+    return position;
+}
+
+uint16_t SimClockController::getAdjustment()
+{
+    return adjustment;
+}
+
+uint16_t SimClockController::getPause()
+{
+    return pause;
+}
+
+bool SimClockController::isEnabled()
+{
+    return control & BIT_ENABLE;
+}
+
+bool SimClockController::isStepping()
+{
+    return step_event != 0;
+}
+
+void SimClockController::tick()
+{
+    if (target_ticks != 0 && --target_ticks == 0 && isEnabled())
+    {
+        planTarget();
+    }
+
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    if (pause != 0)
+    {
+        --pause;
+        return;
+    }
+
+    position = (position + 1) % SIM_CLOCK_MAX;
+    status  ^= STATUS_BIT_TICK;
+
+    if (adjustment != 0 && step_event == 0)
+    {
+        step_event = sim.at(sim.now() + (uint64_t)config[CONFIG_AP_START] * 1000 + config[CONFIG_AP_DELAY] * 1000, [this]() { step(); });
+    }
+}
+
+void SimClockController::step()
+{
+    step_event = 0;
+    if (adjustment == 0 || !isEnabled())
+    {
+        return;
+    }
+
+    position = (position + 1) % SIM_CLOCK_MAX;
+    --adjustment;
+    if (adjustment != 0)
+    {
+        uint64_t step_us = ((uint64_t)config[CONFIG_AP_DURATION] + config[CONFIG_AP_DELAY]) * 1000;
+        step_event = sim.at(sim.now() + step_us, [this]() { step(); });
+    }
+}
+
+//
+// same choice as the controller firmware: fast forward unless pausing is quicker
+//
+void SimClockController::planTarget()
+{
+    if (target >= SIM_CLOCK_MAX)
+    {
+        return;
+    }
+
+    uint16_t ff_steps = ((uint32_t)target + SIM_CLOCK_MAX - position - 1) % SIM_CLOCK_MAX;
+    if (ff_steps == 0)
+    {
+        adjustment = 0;
+        pause      = 0;
+        return;
+    }
+
+    uint16_t pause_ticks = SIM_CLOCK_MAX - ff_steps;
+    uint16_t step_ms     = config[CONFIG_AP_DURATION] + config[CONFIG_AP_DELAY];
+    if (step_ms < 1000 && (uint32_t)ff_steps * step_ms < (uint32_t)pause_ticks * (1000 - step_ms))
+    {
+        adjustment = ff_steps;
+        pause      = 0;
+    }
+    else
+    {
+        adjustment = 0;
+        pause      = pause_ticks;
+    }
+}
+
+void SimClockController::push16(uint16_t value)
+{
+    tx.push_back(value & 0xff);
+    tx.push_back(value >> 8);
+}
+
+void SimClockController::start(bool reading)
+{
+    if (!reading)
+    {
+        have_command = false;
+        rx.clear();
+        return;
+    }
+
+    tx.clear();
+    tx_index = 0;
+    switch (command)
+    {
+    case CMD_ID:          tx.push_back(ID_VALUE);                    break;
+    case CMD_POSITION:    push16(position);                          break;
+    case CMD_ADJUSTMENT:  push16(adjustment);                        break;
+    case CMD_CONTROL:     tx.push_back(control);                     break;
+    case CMD_STATUS:      tx.push_back(status);                      break;
+    case CMD_TP_DURATION: tx.push_back(config[CONFIG_TP_DURATION]);  break;
+    case CMD_TP_DUTY:     tx.push_back(config[CONFIG_TP_DUTY]);      break;
+    case CMD_AP_DURATION: tx.push_back(config[CONFIG_AP_DURATION]);  break;
+    case CMD_AP_DUTY:     tx.push_back(config[CONFIG_AP_DUTY]);      break;
+    case CMD_AP_DELAY:    tx.push_back(config[CONFIG_AP_DELAY]);     break;
+    case CMD_AP_START:    tx.push_back(config[CONFIG_AP_START]);     break;
+    case CMD_PWMTOP:      tx.push_back(config[CONFIG_PWM_TOP]);      break;
+    case CMD_RST_REASON:  tx.push_back(reset_reason);                break;
+    case CMD_VERSION:     tx.push_back(version);                     break;
+    case CMD_SNAPSHOT:
+        if (version >= 2)
+        {
+            tx.push_back(ID_VALUE);
+            tx.push_back(version);
+            tx.push_back(reset_reason);
+            tx.push_back(status);
+            tx.push_back(control);
+            push16(position);
+            push16(adjustment);
+        }
+        break;
+    case CMD_PAUSE:
+        if (version >= 4)
+        {
+            push16(pause);
+        }
+        break;
+    case CMD_TARGET:
+        if (version >= 5)
+        {
+            push16(target);
+            push16(target_ticks);
+        }
+        break;
+    default:
+        if (version >= 3 && command >= CMD_CONFIG && command < CMD_CONFIG + SIM_CLOCK_CONFIG_SIZE)
+        {
+            tx.insert(tx.end(), config + (command - CMD_CONFIG), config + SIM_CLOCK_CONFIG_SIZE);
+        }
+        break;
+    }
+}
+
+bool SimClockController::write(uint8_t value)
+{
+    if (!have_command)
+    {
+        command      = value;
+        have_command = true;
+        return true;
+    }
+    rx.push_back(value);
+    return true;
+}
+
+uint8_t SimClockController::read()
+{
+    // the USI slave sends 0xff once it runs out of data
+    return tx_index < tx.size() ? tx[tx_index++] : 0xff;
+}
+
+void SimClockController::stop()
+{
+    if (have_command && !rx.empty())
+    {
+        apply();
+    }
+    rx.clear();
+}
+
+//
+// a write is handled as a whole once the master sends STOP
+//
+void SimClockController::apply()
+{
+    uint16_t value16 = rx.size() >= 2 ? (rx[0] | rx[1] << 8) : 0;
+
+    switch (command)
+    {
+    case CMD_POSITION:    if (rx.size() >= 2) position   = value16;       break;
+    case CMD_ADJUSTMENT:  if (rx.size() >= 2) adjustment = value16;       break;
+    case CMD_CONTROL:     control = rx[0];                                break;
+    case CMD_TP_DURATION: config[CONFIG_TP_DURATION] = rx[0];             break;
+    case CMD_TP_DUTY:     config[CONFIG_TP_DUTY]     = rx[0];             break;
+    case CMD_AP_DURATION: config[CONFIG_AP_DURATION] = rx[0];             break;
+    case CMD_AP_DUTY:     config[CONFIG_AP_DUTY]     = rx[0];             break;
+    case CMD_AP_DELAY:    config[CONFIG_AP_DELAY]    = rx[0];             break;
+    case CMD_AP_START:    config[CONFIG_AP_START]    = rx[0];             break;
+    case CMD_PWMTOP:      config[CONFIG_PWM_TOP]     = rx[0];             break;
+    case CMD_SAVE_CONFIG:                                                 break;
+    case CMD_RESET:
+        memcpy(config, default_config, sizeof(config));
+        control = 0;
+        break;
+    case CMD_PAUSE:
+        if (version >= 4 && rx.size() >= 2)
+        {
+            pause = value16;
+        }
+        break;
+    case CMD_TARGET:
+        if (version >= 5 && rx.size() >= 4)
+        {
+            target       = value16;
+            target_ticks = rx[2] | rx[3] << 8;
+        }
+        break;
+    default:
+        if (version >= 3 && command >= CMD_CONFIG && command < CMD_CONFIG + SIM_CLOCK_CONFIG_SIZE)
+        {
+            for (size_t i = 0; i < rx.size() && command - CMD_CONFIG + i < SIM_CLOCK_CONFIG_SIZE; ++i)
+            {
+                config[command - CMD_CONFIG + i] = rx[i];
+            }
+        }
+        break;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * SimClockController.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMCLOCKCONTROLLER_H_
+#define SIMCLOCKCONTROLLER_H_
+
+#include "SimI2C.h"
+#include <vector>
+
+#define SIM_CLOCK_ADDRESS     0x09
+#define SIM_CLOCK_VERSION     5
+#define SIM_CLOCK_MAX         43200
+#define SIM_CLOCK_STRETCH_US  40    // USI overflow isr per byte at 1MHz
+#define SIM_CLOCK_CONFIG_SIZE 7
+
+//
+// Register level model of the I2CAnalogClock controller: ticks on the
+// falling SQW edge, fast forwards adjustments at ap_duration+ap_delay per
+// step and handles pause and target like the firmware does.  The pulse
+// timing itself is covered by I2CACSim.
+//
+class SimClockController : public SimI2CDevice
+{
+public:
+    SimClockController(int sync_pin);
+    void     begin(uint16_t position, bool enabled, uint8_t version = SIM_CLOCK_VERSION);
+    void     setPosition(uint16_t position);
+    uint16_t getPosition();
+    uint16_t getAdjustment();
+    uint16_t getPause();
+    bool     isEnabled();
+    bool     isStepping();
+
+    void     start(bool reading);
+    bool     write(uint8_t value);
+    uint8_t  read();
+    void     stop();
+
+private:
+    void     tick();
+    void     step();
+    void     planTarget();
+    void     apply();
+    void     push16(uint16_t value);
+
+    int      pin;
+    uint8_t  version;
+    uint8_t  command;
+    bool     have_command;
+    std::vector<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    size_t   tx_index;
+
+    uint8_t  control;
+    uint8_t  status;
+    uint8_t  reset_reason;
+    uint16_t position;
+    uint16_t adjustment;
+    uint16_t pause;
+    uint16_t target;
+    uint16_t target_ticks;
+    uint8_t  config[SIM_CLOCK_CONFIG_SIZE]; // tp_duration, tp_duty, ap_duration, ap_duty, ap_delay, ap_start, pwm_top
+    uint64_t step_event;
+};
+
+#endif /* SIMCLOCKCONTROLLER_H_ */
@@ -0,0 +1,45 @@
+/*
+ * SimConfig.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// Build settings from the default (la) environment in platformio.ini,
+// force included ahead of every source with -include.
+//
+
+#ifndef SIMCONFIG_H_
+#define SIMCONFIG_H_
+
+#define DEFAULT_TC0_OCCUR  2
+#define DEFAULT_TC0_DOW    0
+#define DEFAULT_TC0_DOFF   0
+#define DEFAULT_TC0_MONTH  3
+#define DEFAULT_TC0_HOUR   2
+#define DEFAULT_TC0_OFFSET -25200
+#define DEFAULT_TC1_OCCUR  1
+#define DEFAULT_TC1_DOW    0
+#define DEFAULT_TC1_DOFF   0
+#define DEFAULT_TC1_MONTH  11
+#define DEFAULT_TC1_HOUR   2
+#define DEFAULT_TC1_OFFSET -28800
+#define DEFAULT_TZ_NAME    "America/Los_Angeles"
+
+#endif /* SIMCONFIG_H_ */
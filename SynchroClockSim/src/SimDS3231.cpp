@@ -0,0 +1,207 @@
+/*
+ * SimDS3231.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimDS3231.h"
+#include "Sim.h"
+#include <string.h>
+#include <time.h>
+
+#define BCD(v)     ((uint8_t)((v) + 6 * ((v) / 10)))
+#define FROMBCD(v) ((uint8_t)((v) - 6 * ((v) >> 4)))
+
+#define DS3231_TIME_REGISTERS 7
+#define DS3231_CONTROL        0x0e
+#define DS3231_TEMP_MSB       0x11
+
+SimDS3231::SimDS3231(int sqw_pin) : SimI2CDevice("DS3231", 0)
+{
+    pin = sqw_pin;
+    memset(regs, 0, sizeof(regs));
+    pointer      = 0;
+    have_pointer = false;
+    written      = 0;
+    base         = 0;
+    anchor_us    = 0;
+    seconds      = 0;
+    last_edge    = 0;
+    period_us    = 1000000.0;
+    event        = 0;
+    time_writes  = 0;
+}
+
+//
+// start the oscillator now at unix_time, call after sim.reset()
+//
+void SimDS3231::begin(uint32_t unix_time, double ppm)
+{
+    memset(regs, 0, sizeof(regs));
+    regs[DS3231_TEMP_MSB] = 25;
+    period_us   = 1000000.0 / (1.0 + ppm / 1000000.0);
+    time_writes = 0;
+    anchor(unix_time, sim.now());
+}
+
+uint32_t SimDS3231::getTime()
+{
+    return base + seconds;
+}
+
+//
+// RTC time including the fraction of the current second
+//
+double SimDS3231::getExactTime()
+{
+    double elapsed = (double)(sim.now() - anchor_us) / period_us;
+    return (double)base + elapsed;
+}
+
+uint64_t SimDS3231::lastEdge()
+{
+    return last_edge;
+}
+
+uint32_t SimDS3231::timeWrites()
+{
+    return time_writes;
+}
+
+void SimDS3231::anchor(uint32_t unix_time, uint64_t when)
+{
+    base      = unix_time;
+    anchor_us = when;
+    seconds   = 0;
+    if (event)
+    {
+        sim.cancel(event);
+    }
+    sim.drivePin(pin, SIM_HIGH);
+    schedule();
+}
+
+//
+// next SQW edge: low for the first half of each second
+//
+void SimDS3231::schedule()
+{
+    uint64_t fall = anchor_us + (uint64_t)((seconds + 1) * period_us);
+    uint64_t rise = anchor_us + (uint64_t)((seconds + 0.5) * period_us);
+    bool falling  = sim.readPin(pin) == SIM_HIGH;
+    event = sim.at(falling ? fall : rise, [this, falling]() { edge(falling); });
+}
+
+void SimDS3231::edge(bool falling)
+{
+    event = 0;
+    if (falling)
+    {
+        ++seconds;
+        last_edge = sim.now();
+    }
+    sim.drivePin(pin, falling ? SIM_LOW : SIM_HIGH);
+    schedule();
+}
+
+void SimDS3231::toRegisters(uint32_t unix_time, uint8_t* r)
+{
+    time_t    t = unix_time;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    r[0] = BCD(tm.tm_sec);
+    r[1] = BCD(tm.tm_min);
+    r[2] = BCD(tm.tm_hour);
+    r[3] = BCD(tm.tm_wday == 0 ? 7 : tm.tm_wday);
+    r[4] = BCD(tm.tm_mday);
+    r[5] = BCD(tm.tm_mon + 1) | (tm.tm_year >= 200 ? 0x80 : 0);
+    r[6] = BCD(tm.tm_year % 100);
+}
+
+uint32_t SimDS3231::fromRegisters(const uint8_t* r)
+{
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_sec  = FROMBCD(r[0]);
+    tm.tm_min  = FROMBCD(r[1]);
+    tm.tm_hour = FROMBCD(r[2] & 0x3f);
+    tm.tm_mday = FROMBCD(r[4]);
+    tm.tm_mon  = FROMBCD(r[5] & 0x1f) - 1;
+    tm.tm_year = FROMBCD(r[6]) + ((r[5] & 0x80) ? 200 : 100);
+    return (uint32_t)timegm(&tm);
+}
+
+//
+// the time registers are copied to a buffer on START, reads see that copy
+//
+void SimDS3231::start(bool reading)
+{
+    toRegisters(getTime(), regs);
+    if (!reading)
+    {
+        have_pointer = false;
+        written      = 0;
+    }
+}
+
+bool SimDS3231::write(uint8_t value)
+{
+    if (!have_pointer)
+    {
+        pointer      = value % SIM_DS3231_REGISTERS;
+        have_pointer = true;
+        return true;
+    }
+
+    if (pointer < DS3231_TIME_REGISTERS)
+    {
+        written |= 1 << pointer;
+    }
+    regs[pointer] = value;
+    pointer = (pointer + 1) % SIM_DS3231_REGISTERS;
+    return true;
+}
+
+uint8_t SimDS3231::read()
+{
+    uint8_t value = regs[pointer];
+    pointer = (pointer + 1) % SIM_DS3231_REGISTERS;
+    return value;
+}
+
+void SimDS3231::stop()
+{
+    if (!written)
+    {
+        return;
+    }
+
+    uint32_t value = fromRegisters(regs);
+    ++time_writes;
+    if (written & 0x01)
+    {
+        anchor(value, sim.now());
+    }
+    else
+    {
+        // keep the phase of the countdown chain
+        base = value - seconds;
+    }
+    written = 0;
+}
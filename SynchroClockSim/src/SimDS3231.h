@@ -0,0 +1,73 @@
+/*
+ * SimDS3231.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMDS3231_H_
+#define SIMDS3231_H_
+
+#include "SimI2C.h"
+
+#define SIM_DS3231_ADDRESS   0x68
+#define SIM_DS3231_REGISTERS 0x13
+
+//
+// DS3231 register model.  The seconds count on the 1Hz SQW falling edge,
+// writing the seconds register restarts the countdown chain so the next
+// second starts a full period after the write.  ppm makes the oscillator
+// run fast (positive) or slow.
+//
+class SimDS3231 : public SimI2CDevice
+{
+public:
+    SimDS3231(int sqw_pin);
+    void     begin(uint32_t unix_time, double ppm);
+    uint32_t getTime();
+    double   getExactTime();
+    uint64_t lastEdge();
+    uint32_t timeWrites();
+
+    void     start(bool reading);
+    bool     write(uint8_t value);
+    uint8_t  read();
+    void     stop();
+
+private:
+    void     anchor(uint32_t unix_time, uint64_t when);
+    void     schedule();
+    void     edge(bool falling);
+    void     toRegisters(uint32_t unix_time, uint8_t* regs);
+    uint32_t fromRegisters(const uint8_t* regs);
+
+    int      pin;
+    uint8_t  regs[SIM_DS3231_REGISTERS];
+    uint8_t  pointer;
+    bool     have_pointer;
+    uint8_t  written;      // bit per time register written in this transfer
+    uint32_t base;         // time at the anchor
+    uint64_t anchor_us;    // when the countdown chain was last restarted
+    uint64_t seconds;      // falling edges since the anchor
+    uint64_t last_edge;
+    double   period_us;
+    uint64_t event;
+    uint32_t time_writes;
+};
+
+#endif /* SIMDS3231_H_ */
@@ -0,0 +1,417 @@
+/*
+ * SimESP.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// ESP8266 core objects for the host build
+//
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "ESP8266httpUpdate.h"
+#include "Updater.h"
+extern "C" {
+#include "user_interface.h"
+#include "gpio.h"
+}
+#include "EEPROM.h"
+#include "FS.h"
+#include "SimNetwork.h"
+#include "SimPower.h"
+#include "lwip/netif.h"
+#include <stdarg.h>
+
+#define SIM_FREE_HEAP 40000
+#define SIM_CHIP_ID   0x00c0ffee
+
+HardwareSerial    Serial;
+EspClass          ESP;
+ESP8266WiFiClass  WiFi;
+ESP8266HTTPUpdate ESPhttpUpdate;
+UpdaterClass      Update;
+EEPROMClass       EEPROM;
+FS                SPIFFS;
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+    size_t n = 0;
+    while (n < size && write(buffer[n]))
+    {
+        ++n;
+    }
+    return n;
+}
+
+size_t Print::print(const char* s)
+{
+    return write((const uint8_t*)s, strlen(s));
+}
+
+size_t Print::println(const char* s)
+{
+    size_t n = print(s);
+    return n + print("\n");
+}
+
+size_t Print::printf(const char* fmt, ...)
+{
+    char    buffer[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, ap);
+    va_end(ap);
+    return print(buffer);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    putchar(c);
+    return 1;
+}
+
+EspClass::EspClass()
+{
+    memset(&reset_info, 0, sizeof(reset_info));
+    memset(rtc_memory, 0xff, sizeof(rtc_memory));
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return SIM_FREE_HEAP;
+}
+
+uint32_t EspClass::getChipId()
+{
+    return SIM_CHIP_ID;
+}
+
+rst_info* EspClass::getResetInfoPtr()
+{
+    return &reset_info;
+}
+
+String EspClass::getResetReason()
+{
+    static const char* reasons[] =
+    {
+        "Power on", "Hardware Watchdog", "Exception", "Software Watchdog",
+        "Software/System restart", "Deep-Sleep Wake", "External System"
+    };
+    return String(reset_info.reason <= REASON_EXT_SYS_RST ? reasons[reset_info.reason] : "Unknown");
+}
+
+void EspClass::deepSleep(uint64_t time_us, RFMode mode)
+{
+    reset_info.reason = REASON_DEEP_SLEEP_AWAKE;
+    throw SimDeepSleep(time_us, mode);
+}
+
+uint64_t EspClass::deepSleepMax()
+{
+    return SIM_DEEP_SLEEP_MAX;
+}
+
+void EspClass::restart()
+{
+    reset_info.reason = REASON_SOFT_RESTART;
+    throw SimRestart();
+}
+
+bool EspClass::eraseConfig()
+{
+    return true;
+}
+
+extern "C" uint8_t system_get_cpu_freq(void)
+{
+    return power.cpuMHz();
+}
+
+extern "C" bool system_update_cpu_freq(uint8_t freq)
+{
+    if (freq != SYS_CPU_80MHZ && freq != SYS_CPU_160MHZ)
+    {
+        return false;
+    }
+    power.setCpuMHz(freq);
+    return true;
+}
+
+static bool          fpm_open;
+static sleep_type    fpm_type;
+static fpm_wakeup_cb fpm_cb;
+static int           wakeup_pin = -1;
+static int           wakeup_level;
+
+extern "C" bool wifi_set_opmode_current(uint8_t opmode)
+{
+    power.setRadio(opmode != NULL_MODE);
+    return true;
+}
+
+extern "C" void wifi_fpm_set_sleep_type(enum sleep_type type)
+{
+    fpm_type = type;
+}
+
+extern "C" void wifi_fpm_open(void)
+{
+    fpm_open = true;
+}
+
+extern "C" void wifi_fpm_close(void)
+{
+    fpm_open = false;
+}
+
+extern "C" void wifi_fpm_set_wakeup_cb(fpm_wakeup_cb cb)
+{
+    fpm_cb = cb;
+}
+
+extern "C" void gpio_pin_wakeup_enable(uint32_t i, GPIO_INT_TYPE intr_state)
+{
+    wakeup_pin   = i;
+    wakeup_level = intr_state == GPIO_PIN_INTR_HILEVEL ? SIM_HIGH : SIM_LOW;
+}
+
+extern "C" void gpio_pin_wakeup_disable(void)
+{
+    wakeup_pin = -1;
+}
+
+//
+// like the SDK we refuse to light sleep with the radio up, the pin is
+// checked every ms
+//
+extern "C" int8_t wifi_fpm_do_sleep(uint32_t sleep_time_in_us)
+{
+    if (!fpm_open || fpm_type != LIGHT_SLEEP_T || power.isRadioOn() || sleep_time_in_us > 0xFFFFFFF)
+    {
+        return -1;
+    }
+
+    uint64_t end = sim.now() + sleep_time_in_us;
+    power.setLightSleep(true);
+    while (sim.now() < end && (wakeup_pin < 0 || sim.readPin(wakeup_pin) != wakeup_level))
+    {
+        sim.advance(end - sim.now() < 1000 ? end - sim.now() : 1000);
+    }
+    power.setLightSleep(false);
+    sim.advance(SIM_POWER_LIGHT_US);
+
+    if (fpm_cb != NULL)
+    {
+        fpm_cb();
+    }
+    return 0;
+}
+
+extern "C" uint32_t system_get_rtc_time(void)
+{
+    return (uint32_t)sim.now();
+}
+
+extern "C" uint32_t system_rtc_clock_cali_proc(void)
+{
+    return 1 << 12;
+}
+
+//
+// there is no flash image on the host
+//
+uint32_t EspClass::getSketchSize()
+{
+    return 0;
+}
+
+String EspClass::getSketchMD5()
+{
+    return String();
+}
+
+bool EspClass::flashRead(uint32_t offset, uint32_t *data, size_t size)
+{
+    (void)offset; (void)data; (void)size;
+    return false;
+}
+
+//
+// offset is in 4 byte blocks like the SDK
+//
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(rtc_memory))
+    {
+        return false;
+    }
+    memcpy(data, rtc_memory + offset * 4, size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(rtc_memory))
+    {
+        return false;
+    }
+    memcpy(rtc_memory + offset * 4, data, size);
+    return true;
+}
+
+ESP8266WiFiClass::ESP8266WiFiClass()
+{
+    available  = false;
+    connect_ms = 0;
+    address    = IPAddress(192, 168, 0, 42);
+    connected  = false;
+}
+
+//
+// nothing runs loop() on the host, the stay awake idle is never simulated
+//
+bool ESP8266WiFiClass::setSleepMode(WiFiSleepType_t type, uint8_t listenInterval)
+{
+    (void)type;
+    (void)listenInterval;
+    return true;
+}
+
+extern "C" void esp_schedule()
+{
+}
+
+struct netif* netif_default;
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode)
+{
+    if (mode == WIFI_OFF)
+    {
+        connected = false;
+    }
+    power.setRadio(mode != WIFI_OFF);
+    return true;
+}
+
+bool ESP8266WiFiClass::isConnected()
+{
+    return connected;
+}
+
+IPAddress ESP8266WiFiClass::localIP()
+{
+    return connected ? address : IPAddress();
+}
+
+String ESP8266WiFiClass::macAddress()
+{
+    return String("5C:CF:7F:C0:FF:EE");
+}
+
+int ESP8266WiFiClass::hostByName(const char* name, IPAddress& result)
+{
+    if (!connected)
+    {
+        return 0;
+    }
+    if (!result.fromString(name) && !network.resolve(name, result))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+//
+// wait for the network, gives up after timeout_ms like WiFiManager does
+//
+bool ESP8266WiFiClass::connect(uint32_t timeout_ms)
+{
+    if (connected)
+    {
+        return true;
+    }
+    if (!available || !power.isRadioOn() || connect_ms > timeout_ms)
+    {
+        delay(timeout_ms);
+        return false;
+    }
+    delay(connect_ms);
+    connected = true;
+    return true;
+}
+
+void ESP8266WiFiClass::disconnect()
+{
+    connected = false;
+}
+
+size_t File::read(uint8_t* buffer, size_t size)
+{
+    if (data == NULL)
+    {
+        return 0;
+    }
+    size = std::min(size, data->size() - position);
+    memcpy(buffer, data->data() + position, size);
+    position += size;
+    return size;
+}
+
+size_t File::write(const uint8_t* buffer, size_t size)
+{
+    if (data == NULL)
+    {
+        return 0;
+    }
+    data->append((const char*)buffer, size);
+    return size;
+}
+
+File FS::open(const char* path, const char* mode)
+{
+    if (mode[0] == 'w')
+    {
+        files[path].clear();
+        return File(&files[path]);
+    }
+    if (mode[0] == 'a')
+    {
+        return File(&files[path]);
+    }
+    std::map<std::string, std::string>::iterator it = files.find(path);
+    if (it == files.end())
+    {
+        return File();
+    }
+    return File(&it->second);
+}
+
+bool FS::rename(const char* from, const char* to)
+{
+    std::map<std::string, std::string>::iterator it = files.find(from);
+    if (it == files.end() || files.count(to) != 0)
+    {
+        return false;
+    }
+    files[to].swap(it->second);
+    files.erase(from);
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * SimFirmware.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimFirmware.h"
+#include "Sim.h"
+#include <dlfcn.h>
+
+SimFirmware firmware;
+
+SimFirmware::SimFirmware()
+{
+    path   = SIM_FIRMWARE_FILE;
+    level  = DLOG_LEVEL_NONE;
+    handle = NULL;
+    api    = NULL;
+}
+
+void SimFirmware::setPath(const char* _path)
+{
+    path = _path;
+}
+
+void SimFirmware::setLogLevel(DLogLevel _level)
+{
+    level = _level;
+}
+
+//
+// fresh firmware RAM, like the ESP coming out of reset
+//
+int SimFirmware::load()
+{
+    unload();
+    handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL)
+    {
+        fprintf(stderr, "failed to load firmware: %s\n", dlerror());
+        return -1;
+    }
+
+    const SimFirmwareAPI* (*entry)() = (const SimFirmwareAPI* (*)())dlsym(handle, SIM_FIRMWARE_ENTRY);
+    if (entry == NULL)
+    {
+        fprintf(stderr, "firmware has no %s: %s\n", SIM_FIRMWARE_ENTRY, dlerror());
+        unload();
+        return -1;
+    }
+    api = entry();
+    api->setLogLevel(level);
+    return 0;
+}
+
+//
+// the handlers live in the firmware, they can't outlive it
+//
+void SimFirmware::unload()
+{
+    sim.detachInterrupts();
+    if (handle != NULL)
+    {
+        dlclose(handle);
+        handle = NULL;
+    }
+    api = NULL;
+}
+
+const SimFirmwareAPI* SimFirmware::operator->() const
+{
+    return api;
+}
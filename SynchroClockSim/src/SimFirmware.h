@@ -0,0 +1,74 @@
+/*
+ * SimFirmware.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMFIRMWARE_H_
+#define SIMFIRMWARE_H_
+
+#include "SynchroClock.h"
+#include <string>
+
+//
+// The firmware (sketch, libraries, DLog and Wire) is built as a shared
+// object so every wake can start from a fresh load: deep sleep on the
+// ESP loses all RAM, only the RTC user memory and flash survive and those
+// live in the simulator.  The firmware reaches the simulated hardware
+// through symbols exported by the simulator, the simulator reaches the
+// firmware through this table.
+//
+
+#define SIM_FIRMWARE_FILE  "synchroclock.so"
+#define SIM_FIRMWARE_ENTRY "simFirmwareAPI"
+
+typedef struct sim_firmware_api
+{
+    void           (*setup)();
+    int            (*getEdgeSyncedTime)(uint32_t* unix_time, uint32_t* edge_us, unsigned int retries);
+    int            (*setCLKfromRTC)();
+    void           (*invalidateTimeBase)();
+    uint32_t       (*calculateCRC32)(const uint8_t* data, size_t length);
+    void           (*setLogLevel)(DLogLevel level);
+    Config*        config;
+    DeepSleepData* dsd;
+} SimFirmwareAPI;
+
+extern "C" const SimFirmwareAPI* simFirmwareAPI();
+
+class SimFirmware
+{
+public:
+    SimFirmware();
+    void     setPath(const char* path);
+    void     setLogLevel(DLogLevel level);
+    int      load();
+    void     unload();
+    const SimFirmwareAPI* operator->() const;
+
+private:
+    std::string           path;
+    DLogLevel             level;
+    void*                 handle;
+    const SimFirmwareAPI* api;
+};
+
+extern SimFirmware firmware;
+
+#endif /* SIMFIRMWARE_H_ */
@@ -0,0 +1,233 @@
+/*
+ * SimI2C.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimI2C.h"
+#include "Sim.h"
+#include <string.h>
+
+#define SIM_SDA_PIN 4
+#define SIM_SCL_PIN 5
+#define SIM_OUTPUT  0x01
+
+SimI2CBus i2c;
+
+SimI2CBus::SimI2CBus()
+{
+    memset(devices, 0, sizeof(devices));
+    memset(nacks, 0, sizeof(nacks));
+    memset(&total, 0, sizeof(total));
+    memset(per_address, 0, sizeof(per_address));
+    clock_hz         = SIM_I2C_CLOCK_HZ;
+    stretch_limit    = SIM_I2C_STRETCH_LIMIT;
+    sda_stuck_clocks = 0;
+}
+
+//
+// call after sim.reset(), the bus watches SCL being clocked by hand
+//
+void SimI2CBus::reset()
+{
+    memset(devices, 0, sizeof(devices));
+    memset(nacks, 0, sizeof(nacks));
+    memset(&total, 0, sizeof(total));
+    memset(per_address, 0, sizeof(per_address));
+    clock_hz         = SIM_I2C_CLOCK_HZ;
+    stretch_limit    = SIM_I2C_STRETCH_LIMIT;
+    sda_stuck_clocks = 0;
+    sim.setPinModeHook([this](int pin, int mode) { pinMode(pin, mode); });
+}
+
+void SimI2CBus::attach(uint8_t address, SimI2CDevice* device)
+{
+    devices[address & 0x7f] = device;
+}
+
+void SimI2CBus::setClock(uint32_t hz)
+{
+    clock_hz = hz;
+}
+
+void SimI2CBus::setStretchLimit(uint32_t us)
+{
+    stretch_limit = us;
+}
+
+void SimI2CBus::nack(uint8_t address, unsigned int count)
+{
+    nacks[address & 0x7f] = count;
+}
+
+//
+// a slave holds SDA low (say it was reset mid byte) until SCL is clocked
+//
+void SimI2CBus::stickSDA(unsigned int clocks)
+{
+    sda_stuck_clocks = clocks;
+    sim.drivePin(SIM_SDA_PIN, clocks ? SIM_LOW : SIM_HIGH);
+}
+
+bool SimI2CBus::isSDAStuck()
+{
+    return sda_stuck_clocks != 0;
+}
+
+//
+// WireUtils::clearBus() clocks SCL by switching the pin to an output
+//
+void SimI2CBus::pinMode(int pin, int mode)
+{
+    if (pin == SIM_SCL_PIN && mode == SIM_OUTPUT && sda_stuck_clocks)
+    {
+        if (--sda_stuck_clocks == 0)
+        {
+            sim.drivePin(SIM_SDA_PIN, SIM_HIGH);
+        }
+    }
+}
+
+void SimI2CBus::busy(uint8_t address, size_t bytes, uint32_t stretch_us)
+{
+    uint64_t us = SIM_I2C_START_STOP_US + (uint64_t)(bytes + 1) * 9 * 1000000 / clock_hz + stretch_us;
+    total.bus_us                += us;
+    per_address[address].bus_us += us;
+    sim.advance(us);
+}
+
+//
+// address phase, returns SIM_I2C_OK if the device is listening
+//
+int SimI2CBus::begin(uint8_t address, bool reading, SimI2CDevice** device)
+{
+    address &= 0x7f;
+    total.transactions                += 1;
+    per_address[address].transactions += 1;
+    if (reading)
+    {
+        total.reads                += 1;
+        per_address[address].reads += 1;
+    }
+    else
+    {
+        total.writes                += 1;
+        per_address[address].writes += 1;
+    }
+
+    if (sda_stuck_clocks)
+    {
+        total.errors                += 1;
+        per_address[address].errors += 1;
+        busy(address, 0, 0);
+        return SIM_I2C_BUS_ERROR;
+    }
+
+    *device = devices[address];
+    if (*device == NULL || nacks[address])
+    {
+        if (nacks[address])
+        {
+            --nacks[address];
+        }
+        total.nacks                += 1;
+        per_address[address].nacks += 1;
+        busy(address, 0, 0);
+        return SIM_I2C_NACK_ADDRESS;
+    }
+
+    if ((*device)->stretch_us > stretch_limit)
+    {
+        total.errors                += 1;
+        per_address[address].errors += 1;
+        busy(address, 0, stretch_limit);
+        return SIM_I2C_BUS_ERROR;
+    }
+
+    (*device)->start(reading);
+    return SIM_I2C_OK;
+}
+
+int SimI2CBus::write(uint8_t address, const uint8_t* data, size_t size, bool stop)
+{
+    SimI2CDevice* device;
+    int err = begin(address, false, &device);
+    if (err)
+    {
+        return err;
+    }
+
+    address &= 0x7f;
+    size_t sent = 0;
+    bool   ack  = true;
+    while (ack && sent < size)
+    {
+        ack = device->write(data[sent++]);
+    }
+    if (stop)
+    {
+        device->stop();
+    }
+
+    total.bytes                += sent;
+    per_address[address].bytes += sent;
+    busy(address, sent, sent * device->stretch_us);
+
+    if (!ack)
+    {
+        total.nacks                += 1;
+        per_address[address].nacks += 1;
+        return SIM_I2C_NACK_DATA;
+    }
+    return SIM_I2C_OK;
+}
+
+size_t SimI2CBus::read(uint8_t address, uint8_t* data, size_t size, bool stop)
+{
+    SimI2CDevice* device;
+    if (begin(address, true, &device))
+    {
+        return 0;
+    }
+
+    address &= 0x7f;
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = device->read();
+    }
+    if (stop)
+    {
+        device->stop();
+    }
+
+    total.bytes                += size;
+    per_address[address].bytes += size;
+    busy(address, size, size * device->stretch_us);
+    return size;
+}
+
+SimI2CStats SimI2CBus::stats()
+{
+    return total;
+}
+
+SimI2CStats SimI2CBus::stats(uint8_t address)
+{
+    return per_address[address & 0x7f];
+}
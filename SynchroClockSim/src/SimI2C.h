@@ -0,0 +1,124 @@
+/*
+ * SimI2C.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMI2C_H_
+#define SIMI2C_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <map>
+
+//
+// Virtual i2c bus.  Each transfer advances virtual time by its wire time
+// (start/stop, 9 clocks per byte including the address) plus any clock
+// stretching the device does per byte, and is counted per device.
+// Faults: a device can be told to NACK its next transfers and SDA can be
+// stuck low until SCL has been clocked a number of times (WireUtils::clearBus).
+//
+
+#define SIM_I2C_CLOCK_HZ        100000 // Wire default
+#define SIM_I2C_START_STOP_US   10     // start, stop & bus free time
+#define SIM_I2C_STRETCH_LIMIT   230    // Wire default clock stretch limit in us
+#define SIM_I2C_ADDRESSES       128
+
+// Wire endTransmission() results
+#define SIM_I2C_OK              0
+#define SIM_I2C_NACK_ADDRESS    2
+#define SIM_I2C_NACK_DATA       3
+#define SIM_I2C_BUS_ERROR       4
+
+class SimI2CDevice
+{
+public:
+    SimI2CDevice(const char* _name, uint32_t _stretch_us) : name(_name), stretch_us(_stretch_us) {}
+    virtual ~SimI2CDevice() {}
+    virtual void    start(bool reading) { (void)reading; }
+    virtual bool    write(uint8_t value) = 0; // false to NACK
+    virtual uint8_t read() = 0;
+    virtual void    stop() {}
+
+    const char* name;
+    uint32_t    stretch_us; // SCL held low after each byte while the device works
+};
+
+typedef struct sim_i2c_stats
+{
+    uint32_t transactions; // each addressed transfer (write or read)
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t bytes;        // data bytes, not counting the address
+    uint32_t nacks;
+    uint32_t errors;       // bus errors (SDA stuck, stretch timeout)
+    uint64_t bus_us;       // time the bus was busy
+
+    struct sim_i2c_stats operator-(const struct sim_i2c_stats& o) const
+    {
+        struct sim_i2c_stats d;
+        d.transactions = transactions - o.transactions;
+        d.writes       = writes - o.writes;
+        d.reads        = reads - o.reads;
+        d.bytes        = bytes - o.bytes;
+        d.nacks        = nacks - o.nacks;
+        d.errors       = errors - o.errors;
+        d.bus_us       = bus_us - o.bus_us;
+        return d;
+    }
+} SimI2CStats;
+
+class SimI2CBus
+{
+public:
+    SimI2CBus();
+    void   reset();
+    void   attach(uint8_t address, SimI2CDevice* device);
+    void   setClock(uint32_t hz);
+    void   setStretchLimit(uint32_t us);
+
+    // fault injection
+    void   nack(uint8_t address, unsigned int count);
+    void   stickSDA(unsigned int clocks);
+    bool   isSDAStuck();
+
+    // transfers, used by Wire
+    int    write(uint8_t address, const uint8_t* data, size_t size, bool stop);
+    size_t read(uint8_t address, uint8_t* data, size_t size, bool stop);
+
+    SimI2CStats stats();
+    SimI2CStats stats(uint8_t address);
+
+private:
+    int    begin(uint8_t address, bool reading, SimI2CDevice** device);
+    void   busy(uint8_t address, size_t bytes, uint32_t stretch_us);
+    void   pinMode(int pin, int mode);
+
+    SimI2CDevice* devices[SIM_I2C_ADDRESSES];
+    unsigned int  nacks[SIM_I2C_ADDRESSES];
+    SimI2CStats   total;
+    SimI2CStats   per_address[SIM_I2C_ADDRESSES];
+    uint32_t      clock_hz;
+    uint32_t      stretch_limit;
+    unsigned int  sda_stuck_clocks;
+};
+
+extern SimI2CBus i2c;
+
+#endif /* SIMI2C_H_ */
@@ -0,0 +1,165 @@
+/*
+ * SimNetwork.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimNetwork.h"
+#include "SimPower.h"
+#include "Sim.h"
+#include "ESP8266WiFi.h"
+#include <algorithm>
+
+#define SIM_DNS_US          20000 // name lookup round trip
+#define SIM_NTP_TURNAROUND  50    // us between the server's receive and transmit stamps
+
+SimNetwork network;
+
+SimNetwork::SimNetwork()
+{
+    reset();
+}
+
+void SimNetwork::reset()
+{
+    ntp_available = true;
+    ntp_address   = IPAddress(192, 168, 0, 123);
+    epoch         = 0;
+    one_way       = 0;
+    jitter        = 0;
+    seed          = 1;
+    inbox.clear();
+    memset(&counts, 0, sizeof(counts));
+}
+
+void SimNetwork::begin(uint32_t unix_time, uint32_t one_way_us, uint32_t jitter_us)
+{
+    epoch   = unix_time;
+    one_way = one_way_us;
+    jitter  = jitter_us;
+}
+
+double SimNetwork::trueTime()
+{
+    return epoch + sim.now() / 1000000.0;
+}
+
+bool SimNetwork::resolve(const char* name, IPAddress& address)
+{
+    (void)name;
+    sim.advance(SIM_DNS_US);
+    ++counts.dns;
+    address = ntp_address;
+    return true;
+}
+
+bool SimNetwork::send(uint16_t local_port, IPAddress address, uint16_t port, const std::string& packet)
+{
+    if (!WiFi.isConnected() || !power.isRadioOn())
+    {
+        return false;
+    }
+
+    ++counts.sent;
+    if (port == SIM_NTP_PORT && address == ntp_address && ntp_available)
+    {
+        sim.at(sim.now() + latency(), [this, local_port, packet]() { answerNTP(local_port, packet); });
+    }
+    else if (port == SIM_SYSLOG_PORT)
+    {
+        ++counts.syslog;
+        counts.syslog_lines += 1 + std::count(packet.begin(), packet.end(), '\n');
+    }
+    return true;
+}
+
+size_t SimNetwork::receive(uint16_t local_port, std::string& packet)
+{
+    std::deque<std::string>& queue = inbox[local_port];
+    if (queue.empty())
+    {
+        return 0;
+    }
+    packet = queue.front();
+    queue.pop_front();
+    ++counts.received;
+    return packet.size();
+}
+
+//
+// the socket closed, anything still in flight for it is lost
+//
+void SimNetwork::drop(uint16_t local_port)
+{
+    inbox.erase(local_port);
+}
+
+SimNetworkStats SimNetwork::stats()
+{
+    return counts;
+}
+
+//
+// repeatable jitter, runs must compare between builds
+//
+uint32_t SimNetwork::latency()
+{
+    seed = seed * 1103515245 + 12345;
+    return one_way + (jitter ? (seed >> 8) % jitter : 0);
+}
+
+static void putStamp(std::string& packet, size_t offset, double unix_time)
+{
+    uint32_t seconds  = (uint32_t)unix_time;
+    uint32_t fraction = (uint32_t)((unix_time - seconds) * 4294967296.0);
+    seconds += SIM_NTP_UNIX_OFFSET;
+    for (int i = 0; i < 4; ++i)
+    {
+        packet[offset + i]     = (char)(seconds >> (24 - i * 8));
+        packet[offset + 4 + i] = (char)(fraction >> (24 - i * 8));
+    }
+}
+
+void SimNetwork::answerNTP(uint16_t local_port, std::string request)
+{
+    if (request.size() != SIM_NTP_PACKET_SIZE)
+    {
+        return;
+    }
+
+    double received = trueTime();
+    std::string reply(SIM_NTP_PACKET_SIZE, '\0');
+    reply[0] = 0x24; // LI 0, version 4, server
+    reply[1] = 2;    // stratum
+    reply[2] = request[2];
+    reply[3] = (char)-20;
+    putStamp(reply, 16, received - 30); // reference
+    reply.replace(24, 8, request, 40, 8); // origin is the client's transmit
+    putStamp(reply, 32, received);
+    putStamp(reply, 40, received + SIM_NTP_TURNAROUND / 1000000.0);
+    ++counts.ntp;
+
+    sim.at(sim.now() + SIM_NTP_TURNAROUND + latency(), [this, local_port, reply]()
+    {
+        if (WiFi.isConnected())
+        {
+            inbox[local_port].push_back(reply);
+        }
+    });
+}
@@ -0,0 +1,83 @@
+/*
+ * SimNetwork.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMNETWORK_H_
+#define SIMNETWORK_H_
+
+#include "IPAddress.h"
+#include <deque>
+#include <map>
+#include <string>
+
+#define SIM_NTP_PORT        123
+#define SIM_SYSLOG_PORT     514
+#define SIM_NTP_PACKET_SIZE 48
+#define SIM_NTP_UNIX_OFFSET 2208988800UL // 1900 to 1970
+
+typedef struct sim_network_stats
+{
+    uint32_t dns;       // name lookups
+    uint32_t sent;      // datagrams from the ESP
+    uint32_t received;  // datagrams delivered to the ESP
+    uint32_t ntp;       // requests answered by the NTP server
+    uint32_t syslog;    // datagrams to the syslog port
+    uint32_t syslog_lines;
+} SimNetworkStats;
+
+//
+// The other end of the WiFi link: a resolver that answers every name with
+// the NTP server, an NTP server that stamps true time and a syslog sink
+// that counts what it gets.  True time is
+// begin()'s unix time plus virtual time, the DS3231 drifts against it.
+// Datagrams take one_way_us (+ up to jitter_us) each way.
+//
+class SimNetwork
+{
+public:
+    SimNetwork();
+    void      reset();
+    void      begin(uint32_t unix_time, uint32_t one_way_us, uint32_t jitter_us);
+    double    trueTime();
+    bool      resolve(const char* name, IPAddress& address);
+    bool      send(uint16_t local_port, IPAddress address, uint16_t port, const std::string& packet);
+    size_t    receive(uint16_t local_port, std::string& packet);
+    void      drop(uint16_t local_port);
+    SimNetworkStats stats();
+
+    bool      ntp_available; // server answers requests
+    IPAddress ntp_address;
+
+private:
+    uint32_t  latency();
+    void      answerNTP(uint16_t local_port, std::string request);
+
+    uint32_t  epoch;
+    uint32_t  one_way;
+    uint32_t  jitter;
+    uint32_t  seed;
+    std::map<uint16_t, std::deque<std::string> > inbox;
+    SimNetworkStats counts;
+};
+
+extern SimNetwork network;
+
+#endif /* SIMNETWORK_H_ */
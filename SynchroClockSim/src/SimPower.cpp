@@ -0,0 +1,210 @@
+/*
+ * SimPower.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#include "SimPower.h"
+#include "Sim.h"
+
+SimPower power;
+
+SimPower::SimPower()
+{
+    awake       = true;
+    rf_enabled  = true;
+    radio       = true;
+    cpu_mhz     = 80;
+    light       = false;
+    last_us     = 0;
+    wake_us     = 0;
+    awake_us    = 0;
+    total       = 0.0;
+    sleep_total = 0.0;
+}
+
+//
+// power on, awake with the radio up.  Must be called after sim.reset().
+//
+void SimPower::reset()
+{
+    *this   = SimPower();
+    last_us = sim.now();
+    wake_us = last_us;
+    phase("boot");
+}
+
+//
+// the deep sleep timer fired, mode is what the firmware asked for when it
+// went to sleep.  Boot time passes before setup() gets to run.
+//
+void SimPower::wake(RFMode mode)
+{
+    settle();
+    awake      = true;
+    rf_enabled = mode != RF_DISABLED;
+    radio      = rf_enabled;
+    cpu_mhz    = 80;
+    light      = false;
+    wake_us    = sim.now();
+    phases.clear();
+    phase("boot");
+    sim.advance(SIM_POWER_BOOT_US + (mode == RF_CAL || mode == RF_DEFAULT ? SIM_POWER_RFCAL_US : 0));
+}
+
+void SimPower::sleep()
+{
+    settle();
+    awake = false;
+    radio = false;
+}
+
+//
+// WiFi on/off, the radio can't come back if the wake disabled the RF
+//
+void SimPower::setRadio(bool on)
+{
+    settle();
+    radio = on && rf_enabled;
+}
+
+//
+// the firmware changed the CPU clock, the reset brings it back to 80MHz
+//
+void SimPower::setCpuMHz(uint8_t mhz)
+{
+    settle();
+    cpu_mhz = mhz;
+}
+
+//
+// the firmware is in forced light sleep, the wake goes on at a lower current
+//
+void SimPower::setLightSleep(bool on)
+{
+    settle();
+    light = on;
+}
+
+uint8_t SimPower::cpuMHz()
+{
+    return cpu_mhz;
+}
+
+//
+// a phase that took no time is replaced, one that is still running continues
+//
+void SimPower::phase(const char* name)
+{
+    if (!awake)
+    {
+        return;
+    }
+    settle();
+    if (!phases.empty() && phases.back().duration_us == 0)
+    {
+        phases.pop_back();
+    }
+    if (!phases.empty() && phases.back().name == name)
+    {
+        return;
+    }
+    SimPowerPhase p;
+    p.name        = name;
+    p.start_us    = sim.now() - wake_us;
+    p.duration_us = 0;
+    p.charge      = 0.0;
+    phases.push_back(p);
+}
+
+bool SimPower::isAwake()
+{
+    return awake;
+}
+
+bool SimPower::isRadioOn()
+{
+    return radio;
+}
+
+double SimPower::charge()
+{
+    settle();
+    return total;
+}
+
+double SimPower::sleepCharge()
+{
+    settle();
+    return sleep_total;
+}
+
+uint64_t SimPower::awakeTime()
+{
+    settle();
+    return awake_us;
+}
+
+uint64_t SimPower::wakeStart()
+{
+    return wake_us;
+}
+
+const std::vector<SimPowerPhase>& SimPower::timeline()
+{
+    settle();
+    return phases;
+}
+
+double SimPower::current()
+{
+    if (!awake)
+    {
+        return SIM_POWER_SLEEP_MA;
+    }
+    if (light)
+    {
+        return SIM_POWER_LIGHT_MA;
+    }
+    double ma = radio ? SIM_POWER_RADIO_MA : SIM_POWER_CPU_MA;
+    return cpu_mhz == 160 ? ma + SIM_POWER_160MHZ_MA : ma;
+}
+
+void SimPower::settle()
+{
+    uint64_t now     = sim.now();
+    uint64_t elapsed = now - last_us;
+    double   charge  = current() * elapsed / 1000000.0;
+
+    total += charge;
+    if (awake)
+    {
+        awake_us += elapsed;
+        if (!phases.empty())
+        {
+            phases.back().duration_us += elapsed;
+            phases.back().charge      += charge;
+        }
+    }
+    else
+    {
+        sleep_total += charge;
+    }
+    last_us = now;
+}
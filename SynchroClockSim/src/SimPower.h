@@ -0,0 +1,98 @@
+/*
+ * SimPower.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef SIMPOWER_H_
+#define SIMPOWER_H_
+
+#include "Esp.h"
+#include <string>
+#include <vector>
+
+//
+// ESP8266 supply current by state.  Ballpark datasheet/bench figures,
+// change them here when better measurements are available.
+//
+#define SIM_POWER_SLEEP_MA  0.02   // deep sleep, RTC timer running
+#define SIM_POWER_CPU_MA    15.0   // awake with the RF disabled
+#define SIM_POWER_160MHZ_MA 8.0    // extra when the CPU runs at 160MHz
+#define SIM_POWER_LIGHT_MA  0.9    // forced light sleep, CPU and RF stopped
+#define SIM_POWER_LIGHT_US  1000   // waking from light sleep, at the CPU current
+#define SIM_POWER_RADIO_MA  70.0   // awake with the radio listening/connecting
+#define SIM_POWER_BOARD_MA  0.15   // DS3231, controller and movement, always on
+#define SIM_POWER_BOOT_US   100000 // ROM + SDK start up before setup() runs
+#define SIM_POWER_RFCAL_US  60000  // extra start up for a full RF calibration
+#define SIM_BATTERY_MAH     2000   // 2 x AA alkaline, usable
+
+typedef struct sim_power_phase
+{
+    std::string name;
+    uint64_t    start_us;    // since the wake started
+    uint64_t    duration_us;
+    double      charge;      // mA*s
+} SimPowerPhase;
+
+//
+// Integrates the ESP current over virtual time.  Each wake is split into
+// phases (named by the firmware function that is running) so a wake can
+// be shown as a timeline.
+//
+class SimPower
+{
+public:
+    SimPower();
+    void     reset();
+    void     wake(RFMode mode);
+    void     sleep();
+    void     setRadio(bool on);
+    void     setCpuMHz(uint8_t mhz);
+    void     setLightSleep(bool on);
+    uint8_t  cpuMHz();
+    void     phase(const char* name);
+
+    bool     isAwake();
+    bool     isRadioOn();
+    double   charge();       // mA*s since reset()
+    double   sleepCharge();  // mA*s of that spent in deep sleep
+    uint64_t awakeTime();    // us awake since reset()
+    uint64_t wakeStart();
+    const std::vector<SimPowerPhase>& timeline(); // phases of the current/last wake
+
+private:
+    void     settle();
+    double   current();
+
+    bool     awake;
+    bool     rf_enabled;     // RF not disabled for this wake
+    bool     radio;
+    uint8_t  cpu_mhz;
+    bool     light;
+    uint64_t last_us;
+    uint64_t wake_us;
+    uint64_t awake_us;
+    double   total;
+    double   sleep_total;
+    std::vector<SimPowerPhase> phases;
+};
+
+extern SimPower power;
+
+#endif /* SIMPOWER_H_ */
@@ -0,0 +1,840 @@
+/*
+ * SynchroClockSim.cpp
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+//
+// Runs the unmodified SynchroClock firmware on the host against simulated
+// hardware (DS3231, clock controller, i2c bus, WiFi/NTP, battery) in
+// virtual time.
+//
+//   SynchroClockSim [-v] [-d days] [-f firmware.so] [-l log_dir] [command]...
+//
+//   i2c    bus transactions and time for the wake path
+//   wake   wake after wake for days, timeline, charge and battery life, and
+//          a wake with a config saved by older firmware
+//
+// Each scenario runs in its own process and the firmware is reloaded for
+// every wake so it starts with fresh RAM.  Exits non-zero if any check
+// fails.
+//
+
+#include "SimFirmware.h"
+#include "SimI2C.h"
+#include "SimDS3231.h"
+#include "SimClockController.h"
+#include "SimNetwork.h"
+#include "SimPower.h"
+#include "BinaryLog.h"
+#include "FS.h"
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define SIM_START_TIME      1792288000 // 2026-10-18 01:46:40 UTC
+#define SIM_START_TZ_OFFSET -25200     // PDT from the la rules in SimConfig.h
+#define SIM_SLEEP_LEFT      7200       // wake with this much deep sleep still to go
+#define SIM_RUN_LIMIT_US    (600ULL * 1000000) // give up on a wake after 10 minutes
+#define SIM_WAKE_DAYS       3          // default for -d
+#define SIM_RTC_PPM         2.0        // DS3231 runs this much fast against true time
+#define SIM_SLEEP_ERROR     0.03       // the ESP deep sleep timer sleeps this much longer than asked
+#define SIM_WAKE_LATE_S     10.0       // average distance a radio wake may land from its target
+#define SIM_WIFI_CONNECT_MS 2500       // association + dhcp
+#define SIM_NTP_ONE_WAY_US  15000
+#define SIM_NTP_JITTER_US   5000
+#define SIM_SYSLOG_HOST     "syslog.sim"
+#define SIM_SYSLOG_PACKETS  6          // most datagrams a radio wake should take to send its log
+#define SIM_FALL_BACK       1793523600 // 2026-11-01 09:00 UTC, 2am PDT back to 1am PST
+#define SIM_SPRING_FORWARD  1805018400 // 2027-03-14 10:00 UTC, 2am PST forward to 3am PDT
+#define SIM_PDT             -25200
+#define SIM_PST             -28800
+#define SIM_DST_BEFORE      (2 * 86400) // power on this long before a time change
+#define SIM_DST_AFTER       (2 * 86400) // and watch the hands this long after it
+#define SIM_DST_WRONG_S     3700       // an hour of correction and a little
+
+#define US2MS(x)            ((double)(x) / 1000.0)
+#define MAS2MAH(x)          ((x) / 3600.0)
+
+static SimDS3231          ds3231(SYNC_PIN);
+static SimClockController controller(SYNC_PIN);
+static int                failures;
+static int                days = SIM_WAKE_DAYS;
+static const char*        log_dir;              // -l: save the binary logs here
+
+static void check(bool ok, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("  %s: ", ok ? "PASS" : "FAIL");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok)
+    {
+        ++failures;
+    }
+}
+
+//
+// local clock position for a UTC time
+//
+static uint16_t localPosition(uint32_t utc, int tz_offset)
+{
+    return (uint16_t)((((int64_t)utc + tz_offset) % CLOCK_MAX + CLOCK_MAX) % CLOCK_MAX);
+}
+
+//
+// a saved config like the one the portal leaves behind
+//
+static void saveDefaultConfig(int tz_offset)
+{
+    Config c;
+    memset(&c, 0, sizeof(c));
+    c.sleep_duration = DEFAULT_SLEEP_DURATION;
+    c.tz_offset      = tz_offset;
+    c.syslog_port    = SIM_SYSLOG_PORT;
+    c.tc[0]          = { DEFAULT_TC0_OFFSET, DEFAULT_TC0_MONTH, DEFAULT_TC0_OCCUR, DEFAULT_TC0_DOW, DEFAULT_TC0_HOUR, DEFAULT_TC0_DOFF };
+    c.tc[1]          = { DEFAULT_TC1_OFFSET, DEFAULT_TC1_MONTH, DEFAULT_TC1_OCCUR, DEFAULT_TC1_DOW, DEFAULT_TC1_HOUR, DEFAULT_TC1_DOFF };
+    strncpy(c.tz_name, DEFAULT_TZ_NAME, sizeof(c.tz_name) - 1);
+    strncpy(c.ntp_server, DEFAULT_NTP_SERVER, sizeof(c.ntp_server) - 1);
+    strncpy(c.syslog_host, SIM_SYSLOG_HOST, sizeof(c.syslog_host) - 1);
+
+    EEConfig ee;
+    memcpy(ee.data, &c, sizeof(c));
+    ee.crc = firmware->calculateCRC32(ee.data, sizeof(ee.data));
+    memcpy(EEPROM.flash, &ee, sizeof(ee));
+}
+
+//
+// the config the firmware last saved
+//
+static Config savedConfig()
+{
+    EEConfig ee;
+    Config   c;
+    memcpy(&ee, EEPROM.flash, sizeof(ee));
+    memcpy(&c, ee.data, sizeof(c));
+    return c;
+}
+
+//
+// the deep sleep data the firmware last saved
+//
+static DeepSleepData savedDeepSleepData()
+{
+    RTCDeepSleepData rtc;
+    DeepSleepData    d;
+    memcpy(&rtc, ESP.rtc_memory, sizeof(rtc));
+    memcpy(&d, rtc.data, sizeof(d));
+    return d;
+}
+
+static void saveDeepSleepData(uint32_t sleep_delay_left)
+{
+    DeepSleepData d;
+    memset(&d, 0, sizeof(d));
+    d.sleep_delay_left = sleep_delay_left;
+
+    RTCDeepSleepData rtc;
+    memcpy(rtc.data, &d, sizeof(d));
+    rtc.crc = firmware->calculateCRC32(rtc.data, sizeof(rtc.data));
+    memcpy(ESP.rtc_memory, &rtc, sizeof(rtc));
+}
+
+//
+// fresh batteries in a clock that was already set up: RTC running, clock
+// enabled and showing the right time, config saved.  Loads the firmware.
+//
+static void powerOn(double rtc_ppm = 0.0, uint32_t start = SIM_START_TIME, int tz_offset = SIM_START_TZ_OFFSET)
+{
+    sim.reset();
+    i2c.reset();
+    network.reset();
+    power.reset();
+    i2c.attach(SIM_DS3231_ADDRESS, &ds3231);
+    i2c.attach(SIM_CLOCK_ADDRESS, &controller);
+    ds3231.begin(start, rtc_ppm);
+    controller.begin(localPosition(start, tz_offset), true);
+    network.begin(start, SIM_NTP_ONE_WAY_US, SIM_NTP_JITTER_US);
+    WiFi.available  = true;
+    WiFi.connect_ms = SIM_WIFI_CONNECT_MS;
+
+    if (firmware.load())
+    {
+        exit(2);
+    }
+    saveDefaultConfig(tz_offset);
+    memset(ESP.rtc_memory, 0xff, sizeof(ESP.rtc_memory));
+    ESP.reset_info.reason = REASON_DEFAULT_RST;
+}
+
+//
+// as if an earlier wake left part of a long sleep to go
+//
+static void sleepingWake()
+{
+    saveDeepSleepData(SIM_SLEEP_LEFT);
+    ESP.reset_info.reason = REASON_DEEP_SLEEP_AWAKE;
+}
+
+//
+// run setup() until it deep sleeps, false if it never does
+//
+static bool runSetup(SimDeepSleep* result)
+{
+    sim.stopAt(sim.now() + SIM_RUN_LIMIT_US);
+    try
+    {
+        firmware->setup();
+    }
+    catch (SimDeepSleep& sleep)
+    {
+        sim.stopAt(UINT64_MAX);
+        if (result != NULL)
+        {
+            *result = sleep;
+        }
+        return true;
+    }
+    catch (SimRestart&)
+    {
+        printf("  firmware restarted\n");
+    }
+    catch (SimStop&)
+    {
+        printf("  firmware still running after %0.0fs\n", US2MS(SIM_RUN_LIMIT_US) / 1000.0);
+    }
+    sim.stopAt(UINT64_MAX);
+    return false;
+}
+
+//
+// bus activity between start() and report()
+//
+class BusProbe
+{
+public:
+    void start()
+    {
+        total = i2c.stats();
+        rtc   = i2c.stats(SIM_DS3231_ADDRESS);
+        clock = i2c.stats(SIM_CLOCK_ADDRESS);
+        began = sim.now();
+    }
+
+    SimI2CStats report(const char* name)
+    {
+        SimI2CStats t = i2c.stats() - total;
+        SimI2CStats r = i2c.stats(SIM_DS3231_ADDRESS) - rtc;
+        SimI2CStats c = i2c.stats(SIM_CLOCK_ADDRESS) - clock;
+        printf("  %s: %0.3fms elapsed\n", name, US2MS(sim.now() - began));
+        printf("    %-8s %6s %6s %6s %6s %6s %6s %9s\n", "device", "xfers", "writes", "reads", "bytes", "nacks", "errors", "bus ms");
+        line("DS3231", r);
+        line("Clock", c);
+        line("total", t);
+        return t;
+    }
+
+private:
+    void line(const char* name, const SimI2CStats& s)
+    {
+        printf("    %-8s %6u %6u %6u %6u %6u %6u %9.3f\n", name, s.transactions, s.writes, s.reads, s.bytes, s.nacks, s.errors, US2MS(s.bus_us));
+    }
+
+    SimI2CStats total;
+    SimI2CStats rtc;
+    SimI2CStats clock;
+    uint64_t    began;
+};
+
+//
+// a wake that only checks the RTC and goes back to sleep
+//
+static void i2cSleepWake()
+{
+    BusProbe     probe;
+    SimDeepSleep sleep(0, RF_DEFAULT);
+
+    powerOn();
+    sleepingWake();
+    probe.start();
+    bool slept = runSetup(&sleep);
+    SimI2CStats s = probe.report("setup() with sleep left");
+
+    check(slept, "went back to deep sleep");
+    check(sleep.us / 1000000 == (SIM_SLEEP_LEFT > SIM_DEEP_SLEEP_MAX / 1000000 ? SIM_DEEP_SLEEP_MAX / 1000000 : SIM_SLEEP_LEFT),
+            "sleeping %llus", (unsigned long long)(sleep.us / 1000000));
+    check(s.errors == 0 && s.nacks == 0, "no bus errors");
+    check(s.transactions <= 10, "%u transfers (budget 10)", s.transactions);
+}
+
+static void i2cEdgeSyncedTime()
+{
+    BusProbe probe;
+    uint32_t unix_time = 0;
+    uint32_t edge_us   = 0;
+
+    powerOn();
+    sleepingWake();
+    runSetup(NULL);
+
+    // one with the bus working and one with SDA stuck low at the start
+    for (int stuck = 0; stuck < 2; ++stuck)
+    {
+        if (stuck)
+        {
+            i2c.stickSDA(9);
+        }
+        probe.start();
+        int err = firmware->getEdgeSyncedTime(&unix_time, &edge_us, 3);
+        SimI2CStats s = probe.report(stuck ? "getEdgeSyncedTime() SDA stuck" : "getEdgeSyncedTime()");
+        uint32_t rtc_time = ds3231.getTime();
+
+        check(err == 0, "returned %d", err);
+        check(unix_time == rtc_time, "time %u RTC %u", unix_time, rtc_time);
+        // the ISR reads micros() a moment after the edge
+        check(edge_us - (uint32_t)ds3231.lastEdge() < 10, "edge %uus RTC edge %uus", edge_us, (uint32_t)ds3231.lastEdge());
+        if (!stuck)
+        {
+            check(s.transactions <= 2, "%u transfers (budget 2)", s.transactions);
+        }
+        else
+        {
+            check(!i2c.isSDAStuck(), "bus recovered by clearBus()");
+        }
+    }
+}
+
+static void i2cSetCLKfromRTC()
+{
+    BusProbe probe;
+
+    powerOn();
+    sleepingWake();
+    runSetup(NULL);
+    firmware->invalidateTimeBase();
+
+    // clock 20 seconds behind, the controller should catch up by itself
+    int      tz_offset = firmware->config->tz_offset;
+    uint16_t expected  = localPosition(ds3231.getTime(), tz_offset);
+    controller.setPosition((expected + CLOCK_MAX - 20) % CLOCK_MAX);
+
+    probe.start();
+    int err = firmware->setCLKfromRTC();
+    SimI2CStats s = probe.report("setCLKfromRTC() 20s behind");
+    check(err == 0, "returned %d", err);
+    check(s.errors == 0 && s.nacks == 0, "no bus errors");
+    check(s.transactions <= 6, "%u transfers (budget 6)", s.transactions);
+
+    sim.advance(3000000);
+    uint16_t rtc_pos = localPosition(ds3231.getTime(), tz_offset);
+    check(controller.getPosition() == rtc_pos, "clock position %u RTC %u after 3s", controller.getPosition(), rtc_pos);
+}
+
+//
+// the controller NACKs while it is busy, setup() should ride through it
+//
+static void i2cClockNack()
+{
+    BusProbe probe;
+
+    powerOn();
+    sleepingWake();
+    i2c.nack(SIM_CLOCK_ADDRESS, 2);
+    probe.start();
+    bool slept = runSetup(NULL);
+    SimI2CStats s = probe.report("setup() clock NACKs twice");
+    check(slept, "went back to deep sleep");
+    check(s.nacks == 2, "%u nacks", s.nacks);
+}
+
+static void printTimeline(const std::vector<SimPowerPhase>& phases)
+{
+    printf("    %-8s %10s %10s %9s\n", "phase", "start ms", "ms", "mA*s");
+    for (size_t i = 0; i < phases.size(); ++i)
+    {
+        const SimPowerPhase& p = phases[i];
+        printf("    %-8s %10.1f %10.1f %9.2f\n", p.name.c_str(), US2MS(p.start_us), US2MS(p.duration_us), p.charge);
+    }
+}
+
+//
+// phases are named after the top level firmware function that is logging
+//
+static void trackPhases()
+{
+    static const char* phases[][2] =
+    {
+        { "setup",         "setup" },
+        { "initWiFi",      "wifi"  },
+        { "processOTA",    "ota"   },
+        { "setRTCfromNTP", "ntp"   },
+        { "setCLKfromRTC", "clock" },
+        { "sleepFor",      "sleep" },
+    };
+
+    sim.listenLog([](const char* tag)
+    {
+        for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); ++i)
+        {
+            if (!strcmp(tag, phases[i][0]))
+            {
+                power.phase(phases[i][1]);
+                return;
+            }
+        }
+    });
+}
+
+typedef struct wake_totals
+{
+    uint32_t wakes;
+    uint64_t awake_us;
+    double   charge;
+} WakeTotals;
+
+//
+// copy the binary logs (LOG_BINARY firmware) out of the simulated SPIFFS so
+// logdecode.py can be run on them along with the firmware.
+//
+static void saveLogs()
+{
+    const char* logs[] = { BINARY_LOG_OLD_FILE, BINARY_LOG_FILE };
+    for (size_t i = 0; i < sizeof(logs) / sizeof(logs[0]); ++i)
+    {
+        File f = SPIFFS.open(logs[i], "r");
+        if (!f)
+        {
+            continue;
+        }
+        std::string data(f.size(), '\0');
+        f.read((uint8_t*)&data[0], data.size());
+        f.close();
+
+        std::string path = std::string(log_dir) + logs[i];
+        FILE* out = fopen(path.c_str(), "wb");
+        check(out != NULL && fwrite(data.data(), 1, data.size(), out) == data.size(), "saved %s (%u bytes)",
+                path.c_str(), (unsigned)data.size());
+        if (out != NULL)
+        {
+            fclose(out);
+        }
+    }
+}
+
+//
+// the clock on batteries for days: every wake runs setup() with fresh
+// firmware RAM until it deep sleeps, then the hardware runs through the
+// sleep.
+//
+static void wakeDays()
+{
+    WakeTotals radio;
+    WakeTotals radio_off;
+    bool       shown = false;
+    RFMode     mode  = RF_CAL; // power on calibrates the radio
+    double     worst_error = 0.0;
+    uint32_t   targets     = 0;
+    double     late_sum    = 0.0;
+    int        late_worst  = 0;
+
+    memset(&radio, 0, sizeof(radio));
+    memset(&radio_off, 0, sizeof(radio_off));
+
+    powerOn(SIM_RTC_PPM);
+    trackPhases();
+
+    printf("  %-5s %-8s %10s %9s %10s\n", "day", "time", "awake ms", "mA*s", "RTC err ms");
+    uint64_t end = (uint64_t)days * 86400 * 1000000;
+    while (sim.now() < end)
+    {
+        SimDeepSleep sleep(0, RF_DEFAULT);
+        bool         with_radio = mode != RF_DISABLED;
+        uint32_t     target     = savedDeepSleepData().sleep_until;
+
+        // power on leaves whatever was in the RTC memory
+        if (with_radio && target != 0 && radio.wakes + radio_off.wakes > 0)
+        {
+            int late    = (int)(ds3231.getTime() - target);
+            targets    += 1;
+            late_sum   += abs(late);
+            late_worst  = abs(late) > abs(late_worst) ? late : late_worst;
+        }
+
+        WiFi.disconnect(); // the link doesn't survive deep sleep
+        power.wake(mode);
+        double charge = power.charge();
+        if (firmware.load())
+        {
+            exit(2);
+        }
+        bool slept = runSetup(&sleep);
+        firmware.unload();
+        power.sleep();
+
+        uint64_t awake_us = sim.now() - power.wakeStart();
+        charge            = power.charge() - charge;
+        WakeTotals& t     = with_radio ? radio : radio_off;
+        t.wakes          += 1;
+        t.awake_us       += awake_us;
+        t.charge         += charge;
+
+        if (!slept)
+        {
+            check(false, "wake at %0.3fs never went back to sleep", US2MS(sim.now()) / 1000.0);
+            return;
+        }
+
+        if (with_radio)
+        {
+            double   error = (ds3231.getExactTime() - network.trueTime()) * 1000.0;
+            uint32_t now   = ds3231.getTime();
+            printf("  %-5u %02u:%02u:%02u %10.1f %9.2f %10.3f\n", (unsigned)(sim.now() / 86400000000ULL),
+                    now / 3600 % 24, now / 60 % 60, now % 60, US2MS(awake_us), charge, error);
+            worst_error = std::max(worst_error, fabs(error));
+            if (!shown)
+            {
+                printTimeline(power.timeline());
+                shown = true;
+            }
+        }
+
+        ESP.reset_info.reason = REASON_DEEP_SLEEP_AWAKE;
+        mode = sleep.mode;
+        sim.advance(sleep.us + (uint64_t)(sleep.us * SIM_SLEEP_ERROR));
+    }
+
+    double seconds   = US2MS(sim.now()) / 1000.0;
+    double per_day   = 86400.0 / seconds;
+    double awake_mah = MAS2MAH(radio.charge + radio_off.charge) * per_day;
+    double sleep_mah = MAS2MAH(power.sleepCharge()) * per_day;
+    double board_mah = SIM_POWER_BOARD_MA * 24.0;
+    double day_mah   = awake_mah + sleep_mah + board_mah;
+    double life      = SIM_BATTERY_MAH / day_mah;
+
+    printf("  %-10s %6s %12s %12s\n", "wakes", "count", "avg awake ms", "avg mA*s");
+    printf("  %-10s %6u %12.1f %12.2f\n", "radio", radio.wakes,
+            radio.wakes ? US2MS(radio.awake_us) / radio.wakes : 0.0, radio.wakes ? radio.charge / radio.wakes : 0.0);
+    printf("  %-10s %6u %12.1f %12.2f\n", "radio off", radio_off.wakes,
+            radio_off.wakes ? US2MS(radio_off.awake_us) / radio_off.wakes : 0.0, radio_off.wakes ? radio_off.charge / radio_off.wakes : 0.0);
+    printf("  per day: awake %0.3fmAh sleep %0.3fmAh board %0.3fmAh total %0.3fmAh (%0.3fmA average)\n",
+            awake_mah, sleep_mah, board_mah, day_mah, day_mah / 24.0);
+    printf("  battery: %umAh lasts %0.0f days\n", SIM_BATTERY_MAH, life);
+
+    double late = targets ? late_sum / targets : 0.0;
+    printf("  radio wakes: %0.1fs average %ds worst from their target, timer %+0.1f%% calibrated to %0.5f\n",
+            late, late_worst, SIM_SLEEP_ERROR * 100.0, savedDeepSleepData().sleep_cal);
+
+    SimNetworkStats net = network.stats();
+    printf("  syslog: %u lines in %u datagrams\n", net.syslog_lines, net.syslog);
+
+    MetricsData metrics = savedDeepSleepData().metrics;
+    printf("  metrics: %u wakes %0.1fs awake, %u NTP (%u failed %u rejected) %0.3fs rtt, heap min %u\n", metrics.wakes,
+            metrics.wake_ms_sum / 1000.0, metrics.ntp_requests, metrics.ntp_failures, metrics.ntp_rejected, metrics.ntp_rtt_us_sum / 1000000.0,
+            metrics.heap_min);
+
+    uint32_t now       = ds3231.getTime();
+    int      tz_offset = savedConfig().tz_offset;
+    check(controller.getPosition() == localPosition(now, tz_offset), "clock position %u RTC %u",
+            controller.getPosition(), localPosition(now, tz_offset));
+    // the firmware leaves offsets under NTP_OFFSET_THRESHOLD alone
+    check(worst_error < NTP_OFFSET_THRESHOLD * 1000.0 + 5.0, "RTC within %0.3fms of true time after NTP wakes", worst_error);
+    check(late <= SIM_WAKE_LATE_S, "radio wakes land %0.1fs from their target (max %0.0f)", late, SIM_WAKE_LATE_S);
+    check(life >= 440, "battery life %0.0f days (budget 440)", life);
+    check(metrics.wakes == radio.wakes + radio_off.wakes && metrics.ntp_requests == net.ntp,
+            "metrics counted %u wakes and %u NTP requests", metrics.wakes, metrics.ntp_requests);
+    check(net.syslog_lines > 0 && net.syslog <= radio.wakes * SIM_SYSLOG_PACKETS, "%0.1f syslog datagrams per radio wake (max %u)",
+            radio.wakes ? (double)net.syslog / radio.wakes : 0.0, SIM_SYSLOG_PACKETS);
+
+    if (log_dir != NULL)
+    {
+        saveLogs();
+    }
+}
+
+//
+// a config saved by firmware from before tz_name, the same bytes up to it
+// with the CRC over just those.  It has to survive the upgrade, drift and all.
+//
+static void wakeConfigUpgrade()
+{
+    powerOn();
+    Config c = savedConfig();
+    strncpy(c.ntp_server, "upgrade.sim", sizeof(c.ntp_server) - 1);
+    c.ntp_persist.drift = 1.5;
+    memset(c.tz_name, 0xff, sizeof(c.tz_name)); // whatever was in the flash past the old config
+
+    EEConfig ee;
+    memcpy(ee.data, &c, sizeof(c));
+    ee.crc = firmware->calculateCRC32(ee.data, offsetof(Config, tz_name));
+    memcpy(EEPROM.flash, &ee, sizeof(ee));
+
+    sleepingWake();
+    bool slept = runSetup(NULL);
+
+    memcpy(&ee, EEPROM.flash, sizeof(ee));
+    Config saved = savedConfig();
+    check(slept, "went back to deep sleep");
+    check(ee.crc == firmware->calculateCRC32(ee.data, sizeof(ee.data)), "config saved in the new layout");
+    check(!strcmp(saved.ntp_server, "upgrade.sim") && saved.ntp_persist.drift == 1.5,
+            "kept ntp server '%s' and drift %0.1fppm", saved.ntp_server, saved.ntp_persist.drift);
+    check(saved.tz_name[0] == '\0' && !memcmp(saved.tc, c.tc, sizeof(c.tc)), "no time zone, kept the time changes");
+}
+
+typedef struct hand_watch
+{
+    uint32_t change;  // UTC time of the time change
+    int      before;  // offset until the change
+    int      after;
+    uint32_t wrong;   // seconds the hands were wrong
+    int64_t  first;   // first and last wrong second, relative to the change
+    int64_t  last;
+} HandWatch;
+
+//
+// compare the hands with the local time the RTC says once a second, half
+// way between ticks so a tick in progress doesn't count
+//
+static void watchHands(HandWatch* w, uint64_t when)
+{
+    sim.at(when, [w, when]() {
+        uint32_t now    = ds3231.getTime();
+        int      offset = now < w->change ? w->before : w->after;
+        if (controller.getPosition() != localPosition(now, offset))
+        {
+            int64_t rel = (int64_t)now - w->change;
+            w->first    = w->wrong ? w->first : rel;
+            w->last     = rel;
+            w->wrong   += 1;
+        }
+        watchHands(w, when + 1000000);
+    });
+}
+
+//
+// power on SIM_DST_BEFORE ahead of a time change and wake as the firmware
+// asks until SIM_DST_AFTER past it, the hands should be right until the
+// change and only wrong for the hour the controller takes to correct.
+//
+static void dstChange(uint32_t change, int before, int after)
+{
+    HandWatch w;
+    memset(&w, 0, sizeof(w));
+    w.change = change;
+    w.before = before;
+    w.after  = after;
+
+    powerOn(0.0, change - SIM_DST_BEFORE, before);
+    watchHands(&w, ds3231.lastEdge() + 500000);
+
+    RFMode   mode  = RF_CAL;
+    uint32_t wakes = 0;
+    uint64_t end   = (uint64_t)(SIM_DST_BEFORE + SIM_DST_AFTER) * 1000000;
+    while (sim.now() < end)
+    {
+        SimDeepSleep sleep(0, RF_DEFAULT);
+        WiFi.disconnect();
+        power.wake(mode);
+        if (firmware.load())
+        {
+            exit(2);
+        }
+        bool slept = runSetup(&sleep);
+        firmware.unload();
+        power.sleep();
+        wakes += 1;
+        if (!slept)
+        {
+            check(false, "wake at %0.3fs never went back to sleep", US2MS(sim.now()) / 1000.0);
+            return;
+        }
+        ESP.reset_info.reason = REASON_DEEP_SLEEP_AWAKE;
+        mode = sleep.mode;
+        sim.advance(sleep.us + (uint64_t)(sleep.us * SIM_SLEEP_ERROR));
+    }
+
+    printf("  %u wakes, hands wrong for %us", wakes, w.wrong);
+    if (w.wrong)
+    {
+        printf(" from %+llds to %+llds of the change", (long long)w.first, (long long)w.last);
+    }
+    printf("\n");
+    check(w.wrong == 0 || w.first >= 0, "hands right until the change");
+    check(w.wrong <= SIM_DST_WRONG_S, "hands wrong for %us (budget %u)", w.wrong, SIM_DST_WRONG_S);
+    check(controller.getPosition() == localPosition(ds3231.getTime(), after), "clock position %u RTC %u",
+            controller.getPosition(), localPosition(ds3231.getTime(), after));
+}
+
+static void dstFallBack()
+{
+    dstChange(SIM_FALL_BACK, SIM_PDT, SIM_PST);
+}
+
+static void dstSpringForward()
+{
+    dstChange(SIM_SPRING_FORWARD, SIM_PST, SIM_PDT);
+}
+
+typedef struct scenario
+{
+    const char* name;
+    void      (*func)();
+} Scenario;
+
+static const Scenario i2c_scenarios[] =
+{
+    { "sleep wake",        i2cSleepWake      },
+    { "edge synced time",  i2cEdgeSyncedTime },
+    { "set clock",         i2cSetCLKfromRTC  },
+    { "clock nack",        i2cClockNack      },
+};
+
+static const Scenario wake_scenarios[] =
+{
+    { "wake cycle",        wakeDays          },
+    { "config upgrade",    wakeConfigUpgrade },
+};
+
+static const Scenario dst_scenarios[] =
+{
+    { "fall back",         dstFallBack       },
+    { "spring forward",    dstSpringForward  },
+};
+
+//
+// each scenario gets its own process so the hardware models and the
+// simulator start out fresh too.
+//
+static int runScenario(const Scenario& s)
+{
+    printf("%s:\n", s.name);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        failures = 0;
+        s.func();
+        fflush(stdout);
+        _exit(failures ? 1 : 0);
+    }
+
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        printf("  FAIL: scenario did not complete\n");
+        return 1;
+    }
+    return WEXITSTATUS(status);
+}
+
+static int runScenarios(const Scenario* scenarios, size_t count)
+{
+    int failed = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        failed += runScenario(scenarios[i]) ? 1 : 0;
+    }
+    return failed;
+}
+
+static int commandI2C()
+{
+    return runScenarios(i2c_scenarios, sizeof(i2c_scenarios) / sizeof(i2c_scenarios[0]));
+}
+
+static int commandWake()
+{
+    return runScenarios(wake_scenarios, sizeof(wake_scenarios) / sizeof(wake_scenarios[0]));
+}
+
+static int commandDST()
+{
+    return runScenarios(dst_scenarios, sizeof(dst_scenarios) / sizeof(dst_scenarios[0]));
+}
+
+typedef struct command
+{
+    const char* name;
+    int       (*func)();
+} Command;
+
+static const Command commands[] =
+{
+    { "i2c",  commandI2C  },
+    { "wake", commandWake },
+    { "dst",  commandDST  },
+};
+
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+//
+// the firmware is expected next to the simulator unless -f says otherwise
+//
+static std::string defaultFirmware(const char* argv0)
+{
+    std::string path(argv0);
+    size_t slash = path.rfind('/');
+    return (slash == std::string::npos ? std::string("./") : path.substr(0, slash + 1)) + SIM_FIRMWARE_FILE;
+}
+
+int main(int argc, char** argv)
+{
+    firmware.setPath(defaultFirmware(argv[0]).c_str());
+
+    int opt;
+    while ((opt = getopt(argc, argv, "vd:f:l:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v':
+            firmware.setLogLevel(DLOG_LEVEL_DEBUG);
+            break;
+        case 'd':
+            days = atoi(optarg);
+            break;
+        case 'f':
+            firmware.setPath(optarg);
+            break;
+        case 'l':
+            log_dir = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-v] [-d days] [-f firmware.so] [-l log_dir] [command]...\n", argv[0]);
+            return 2;
+        }
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < COMMAND_COUNT; ++i)
+    {
+        bool selected = optind >= argc;
+        for (int a = optind; a < argc; ++a)
+        {
+            selected = selected || !strcmp(argv[a], commands[i].name);
+        }
+        if (selected)
+        {
+            failed += commands[i].func();
+        }
+    }
+
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * Ticker.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef TICKER_H_
+#define TICKER_H_
+
+//
+// the LED blink ticker does nothing on the host
+//
+class Ticker
+{
+public:
+    template<typename T> void attach(float seconds, void (*callback)(T), T arg)
+    {
+        (void)seconds; (void)callback; (void)arg;
+    }
+    void detach() {}
+};
+
+#endif /* TICKER_H_ */
@@ -0,0 +1,44 @@
+/*
+ * Updater.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef UPDATER_H_
+#define UPDATER_H_
+
+#include "Arduino.h"
+
+//
+// no OTA partition on the host, begin() always fails.
+//
+class UpdaterClass
+{
+public:
+    bool    begin(size_t size)                  { (void)size; return false; }
+    bool    setMD5(const char* md5)             { (void)md5; return true; }
+    size_t  write(uint8_t* data, size_t len)    { (void)data; (void)len; return 0; }
+    bool    end(bool even_if_remaining = false) { (void)even_if_remaining; return false; }
+    bool    isRunning()                         { return false; }
+    uint8_t getError()                          { return 0; }
+};
+
+extern UpdaterClass Update;
+
+#endif /* UPDATER_H_ */
@@ -0,0 +1,58 @@
+/*
+ * WString.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WSTRING_H_
+#define WSTRING_H_
+
+#include <string>
+#include <strings.h>
+
+class __FlashStringHelper;
+
+class String
+{
+public:
+    String() {}
+    String(const char* s) : str(s ? s : "") {}
+    String(const __FlashStringHelper* s) : String(reinterpret_cast<const char*>(s)) {}
+    String(const std::string& s) : str(s) {}
+    String(int value) : str(std::to_string(value)) {}
+    String(unsigned int value) : str(std::to_string(value)) {}
+    String(long value) : str(std::to_string(value)) {}
+    String(unsigned long value) : str(std::to_string(value)) {}
+
+    const char*  c_str() const                   { return str.c_str(); }
+    unsigned int length() const                  { return str.length(); }
+    long         toInt() const                   { return atol(str.c_str()); }
+    bool         reserve(unsigned int size)      { str.reserve(size); return true; }
+    bool         equals(const String& s) const   { return str == s.str; }
+    bool         equalsIgnoreCase(const String& s) const { return strcasecmp(str.c_str(), s.c_str()) == 0; }
+    bool         operator==(const String& s) const { return str == s.str; }
+    String&      operator+=(const String& s)     { str += s.str; return *this; }
+    String       operator+(const String& s) const { return String(str + s.str); }
+    String       operator+(const char* s) const  { return String(str + s); }
+
+private:
+    std::string str;
+};
+
+#endif /* WSTRING_H_ */
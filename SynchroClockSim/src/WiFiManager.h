@@ -0,0 +1,80 @@
+/*
+ * WiFiManager.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WIFIMANAGER_H_
+#define WIFIMANAGER_H_
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include <functional>
+
+class WiFiManagerParameter
+{
+public:
+    WiFiManagerParameter(const char* custom) : id(NULL), value(NULL), custom_html(custom) {}
+    WiFiManagerParameter(const char* _id, const char* placeholder, const char* _value, int length)
+        : id(_id), value(_value), custom_html(NULL)
+    {
+        (void)placeholder;
+        (void)length;
+    }
+    const char* getID()         { return id; }
+    const char* getValue()      { return value; }
+    const char* getCustomHTML() { return custom_html; }
+private:
+    const char* id;
+    const char* value;
+    const char* custom_html;
+};
+
+//
+// autoConnect joins the simulated network, the config portal is never
+// used by anyone so it just times out.
+//
+class WiFiManager
+{
+public:
+    WiFiManager() : connect_timeout(0) {}
+    void setEnableConfigPortal(bool enable)                          { (void)enable; }
+    void setDebugOutput(bool debug)                                  { (void)debug; }
+    void setConnectTimeout(unsigned long seconds)                    { connect_timeout = seconds; }
+    void setSaveConfigCallback(std::function<void()> callback)       { (void)callback; }
+    void setAPCallback(std::function<void(WiFiManager*)> callback)   { (void)callback; }
+    void addParameter(WiFiManagerParameter* parameter)               { (void)parameter; }
+    bool autoConnect(const char* name, const char* password)
+    {
+        (void)name;
+        (void)password;
+        return WiFi.connect(connect_timeout * 1000);
+    }
+    bool startConfigPortal(const char* name, const char* password)
+    {
+        (void)name;
+        (void)password;
+        delay(180000); // default portal timeout
+        return false;
+    }
+private:
+    unsigned long connect_timeout;
+};
+
+#endif /* WIFIMANAGER_H_ */
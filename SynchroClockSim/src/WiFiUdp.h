@@ -0,0 +1,102 @@
+/*
+ * WiFiUdp.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WIFIUDP_H_
+#define WIFIUDP_H_
+
+#include "Arduino.h"
+#include "SimNetwork.h"
+
+//
+// datagrams go through the simulated network, only sockets with a local
+// port can receive.
+//
+class WiFiUDP
+{
+public:
+    WiFiUDP() : local_port(0), remote_port(0) {}
+
+    uint8_t begin(uint16_t port)
+    {
+        local_port = port;
+        return 1;
+    }
+
+    int beginPacket(IPAddress address, uint16_t port)
+    {
+        remote      = address;
+        remote_port = port;
+        packet.clear();
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size)
+    {
+        packet.append((const char*)buffer, size);
+        return size;
+    }
+
+    int endPacket()
+    {
+        return network.send(local_port, remote, remote_port, packet) ? 1 : 0;
+    }
+
+    int parsePacket()
+    {
+        position = 0;
+        return (int)network.receive(local_port, received);
+    }
+
+    int read(char* buffer, size_t size)
+    {
+        size = std::min(size, received.size() - position);
+        memcpy(buffer, received.data() + position, size);
+        position += size;
+        return (int)size;
+    }
+
+    // the simulated network only delivers replies, they come from where we sent
+    IPAddress remoteIP()
+    {
+        return remote;
+    }
+
+    uint16_t remotePort()
+    {
+        return remote_port;
+    }
+
+    void stop()
+    {
+        network.drop(local_port);
+    }
+
+private:
+    uint16_t    local_port;
+    IPAddress   remote;
+    uint16_t    remote_port;
+    std::string packet;
+    std::string received;
+    size_t      position;
+};
+
+#endif /* WIFIUDP_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Wire.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef WIRE_H_
+#define WIRE_H_
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 128
+
+//
+// Wire master on top of the simulated i2c bus
+//
+class TwoWire : public Print
+{
+public:
+    TwoWire();
+    void    begin();
+    void    begin(int sda, int scl);
+    void    setClock(uint32_t hz);
+    void    setClockStretchLimit(uint32_t limit);
+
+    void    beginTransmission(uint8_t address);
+    void    beginTransmission(int address);
+    uint8_t endTransmission();
+    uint8_t endTransmission(uint8_t sendStop);
+
+    uint8_t requestFrom(uint8_t address, size_t size, bool sendStop);
+    uint8_t requestFrom(uint8_t address, size_t size);
+    uint8_t requestFrom(uint8_t address, uint8_t size);
+    uint8_t requestFrom(uint8_t address, uint8_t size, uint8_t sendStop);
+    uint8_t requestFrom(int address, int size);
+    uint8_t requestFrom(int address, int size, int sendStop);
+
+    size_t  write(uint8_t value);
+    size_t  write(const uint8_t* data, size_t size);
+    int     available();
+    int     read();
+    int     peek();
+    void    flush();
+
+private:
+    uint8_t tx_address;
+    bool    transmitting;
+    uint8_t tx_buffer[BUFFER_LENGTH];
+    size_t  tx_length;
+    uint8_t rx_buffer[BUFFER_LENGTH];
+    size_t  rx_length;
+    size_t  rx_index;
+};
+
+extern TwoWire Wire;
+
+#endif /* WIRE_H_ */
@@ -0,0 +1,46 @@
+/*
+ * netif.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef LWIP_NETIF_H_
+#define LWIP_NETIF_H_
+
+#include <stdint.h>
+
+//
+// just the input hook, there is no interface on the host so netif_default
+// stays NULL
+//
+typedef int8_t err_t;
+
+struct pbuf;
+struct netif;
+
+typedef err_t (*netif_input_fn)(struct pbuf* p, struct netif* inp);
+
+struct netif
+{
+    netif_input_fn input;
+};
+
+extern struct netif* netif_default;
+
+#endif /* LWIP_NETIF_H_ */
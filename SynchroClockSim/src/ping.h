@@ -0,0 +1,44 @@
+/*
+ * ping.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef PING_H_
+#define PING_H_
+
+#include <stdint.h>
+
+struct ping_option
+{
+    uint32_t count;
+    uint32_t ip;
+    uint32_t coarse_time;
+    void   (*recv_function)(void* arg, void* pdata);
+    void   (*sent_function)(void* arg, void* pdata);
+    void*    reverse;
+};
+
+inline bool ping_start(struct ping_option* option)
+{
+    (void)option;
+    return true;
+}
+
+#endif /* PING_H_ */
@@ -0,0 +1,62 @@
+/*
+ * user_interface.h
+ *
+ * Copyright 2017 Christopher B. Liebman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: liebman
+ */
+
+#ifndef USER_INTERFACE_H_
+#define USER_INTERFACE_H_
+
+#include <stdint.h>
+
+//
+// the SDK's CPU clock control, the clock changes the simulated current
+//
+#define SYS_CPU_80MHZ  80
+#define SYS_CPU_160MHZ 160
+
+uint8_t system_get_cpu_freq(void);
+bool    system_update_cpu_freq(uint8_t freq);
+
+//
+// forced light sleep, the sleep runs inside wifi_fpm_do_sleep() at the
+// light sleep current until the timer or the gpio wake up level.  The RTC
+// timer counts microseconds.
+//
+#define NULL_MODE 0x00
+
+enum sleep_type
+{
+    NONE_SLEEP_T = 0,
+    LIGHT_SLEEP_T,
+    MODEM_SLEEP_T
+};
+
+typedef void (*fpm_wakeup_cb)(void);
+
+bool     wifi_set_opmode_current(uint8_t opmode);
+void     wifi_fpm_set_sleep_type(enum sleep_type type);
+void     wifi_fpm_open(void);
+void     wifi_fpm_close(void);
+void     wifi_fpm_set_wakeup_cb(fpm_wakeup_cb cb);
+int8_t   wifi_fpm_do_sleep(uint32_t sleep_time_in_us);
+uint32_t system_get_rtc_time(void);
+uint32_t system_rtc_clock_cali_proc(void);
+
+#endif /* USER_INTERFACE_H_ */